@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+
+volatile uintptr_t libos_bench_sink;
+
+static libos_time_ticks_calibration_t libos_bench_calibration;
+
+// Runs the benchmark once and returns the duration in nanoseconds.
+static uint64_t libos_bench_sample(libos_bench_fn_t fn, void *context, uint32_t iterations)
+{
+    libos_time_ticks_t start = libos_time_ticks_now();
+    fn(context, iterations);
+    libos_time_ticks_t end = libos_time_ticks_now();
+    return libos_time_ticks_to_ns(&libos_bench_calibration, libos_time_ticks_diff(start, end));
+}
+
+static int libos_bench_compare(const void *a, const void *b)
+{
+    uint64_t left = *(const uint64_t *)a;
+    uint64_t right = *(const uint64_t *)b;
+    return (left > right) - (left < right);
+}
+
+libos_err_t libos_bench_init(void)
+{
+    // 10 ms, long enough to calibrate against a millisecond clock.
+    return libos_time_ticks_calibrate(&libos_bench_calibration, 10000);
+}
+
+libos_err_t libos_bench_measure(libos_bench_fn_t fn, void *context, libos_bench_result_t *result)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(fn);
+    LIBOS_ERR_RET_ARG_NOT_NULL(result);
+
+    // Static, the stack of a embedded task is usually small.
+    static uint64_t samples[LIBOS_BENCH_SAMPLES];
+
+    // Warm up and find the number of operations per sample.
+    uint32_t iterations = 1;
+    while (libos_bench_sample(fn, context, iterations) < LIBOS_BENCH_MIN_SAMPLE_NS && iterations < (UINT32_C(1) << 30))
+    {
+        iterations *= 2;
+    }
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < LIBOS_BENCH_SAMPLES; i++)
+    {
+        samples[i] = libos_bench_sample(fn, context, iterations);
+        total += samples[i];
+    }
+    qsort(samples, LIBOS_BENCH_SAMPLES, sizeof(samples[0]), libos_bench_compare);
+
+    result->iterations = iterations;
+    result->mean_ns = (double)total / ((double)LIBOS_BENCH_SAMPLES * iterations);
+    result->p50_ns = (double)samples[LIBOS_BENCH_SAMPLES / 2] / iterations;
+    result->p99_ns = (double)samples[((LIBOS_BENCH_SAMPLES - 1) * 99) / 100] / iterations;
+    return LIBOS_ERR_OK;
+}
+
+void libos_bench_report(const char *name, const libos_bench_result_t *result)
+{
+    printf("%-40s %10.2f ns/op  p50 %10.2f  p99 %10.2f  (%lu ops/sample)\n",
+        name, result->mean_ns, result->p50_ns, result->p99_ns, (unsigned long)result->iterations);
+}
+
+libos_err_t libos_bench_run(const char *name, libos_bench_fn_t fn, void *context)
+{
+    libos_bench_result_t result;
+    LIBOS_ERR_CHECK(libos_bench_measure(fn, context, &result));
+    libos_bench_report(name, &result);
+    return LIBOS_ERR_OK;
+}
+
+// The cost of the benchmark loop itself, to put the other results in perspective.
+static void libos_bench_loop(void *context, uint32_t iterations)
+{
+    (void)context;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        LIBOS_BENCH_KEEP(i);
+    }
+}
+
+libos_err_t libos_bench_run_all(void)
+{
+    LIBOS_ERR_CHECK(libos_bench_init());
+
+    LIBOS_ERR_CHECK(libos_bench_run("loop", libos_bench_loop, NULL));
+    LIBOS_ERR_CHECK(libos_bench_time());
+    LIBOS_ERR_CHECK(libos_bench_mutex());
+    LIBOS_ERR_CHECK(libos_bench_bits());
+    LIBOS_ERR_CHECK(libos_bench_contention(LIBOS_BENCH_CONTENTION_MAX_THREADS, 1,
+        LIBOS_BENCH_CONTENTION_CRITICAL_SECTION, LIBOS_BENCH_CONTENTION_DURATION_MS));
+    LIBOS_ERR_CHECK(libos_bench_contention(LIBOS_BENCH_CONTENTION_MAX_THREADS, LIBOS_BENCH_CONTENTION_MAX_MUTEXES,
+        LIBOS_BENCH_CONTENTION_CRITICAL_SECTION, LIBOS_BENCH_CONTENTION_DURATION_MS));
+    return LIBOS_ERR_OK;
+}
@@ -0,0 +1,201 @@
+/**
+ * @file bench.h
+ * @brief A small micro-benchmark harness for the libos primitives.
+ * 
+ * @details
+ * A benchmark is a function that runs the operation under test a given
+ * number of times. The harness first doubles that number until one run
+ * takes at least LIBOS_BENCH_MIN_SAMPLE_NS, such that the overhead of
+ * reading the clock is negligible, and then takes LIBOS_BENCH_SAMPLES runs.
+ * The mean, median and 99th percentile of the time per operation are
+ * reported on stdout.
+ * 
+ * The time is measured with libos_time_ticks_now, calibrated against
+ * libos_time_get_now by libos_bench_init. Only the platform port is needed,
+ * so the same benchmarks run on the host and on the targets.
+ * 
+ * @code
+ * static void bench_nothing(void *context, uint32_t iterations)
+ * {
+ *     for (uint32_t i = 0; i < iterations; i++)
+ *     {
+ *         LIBOS_BENCH_KEEP(i);
+ *     }
+ * }
+ * 
+ * libos_bench_init();
+ * libos_bench_run("nothing", bench_nothing, NULL);
+ * @endcode
+ */
+
+#pragma once
+#ifndef LIBOS_BENCH_H
+#define LIBOS_BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "libos/error.h"
+#include "libos/time.h"
+
+/**
+ * @brief The number of samples taken per benchmark.
+ */
+#ifndef LIBOS_BENCH_SAMPLES
+#define LIBOS_BENCH_SAMPLES 101
+#endif // LIBOS_BENCH_SAMPLES
+
+/**
+ * @brief The minimum duration of a sample in nanoseconds.
+ */
+#ifndef LIBOS_BENCH_MIN_SAMPLE_NS
+#define LIBOS_BENCH_MIN_SAMPLE_NS 50000
+#endif // LIBOS_BENCH_MIN_SAMPLE_NS
+
+/**
+ * @brief The maximum number of workers of libos_bench_contention, libos_bench_run_all uses all of them.
+ */
+#ifndef LIBOS_BENCH_CONTENTION_MAX_THREADS
+#define LIBOS_BENCH_CONTENTION_MAX_THREADS 8
+#endif // LIBOS_BENCH_CONTENTION_MAX_THREADS
+
+/**
+ * @brief The maximum number of mutexes of libos_bench_contention, libos_bench_run_all uses one and all of them.
+ */
+#ifndef LIBOS_BENCH_CONTENTION_MAX_MUTEXES
+#define LIBOS_BENCH_CONTENTION_MAX_MUTEXES 16
+#endif // LIBOS_BENCH_CONTENTION_MAX_MUTEXES
+
+/**
+ * @brief The length of the critical section used by libos_bench_run_all, in busy loop iterations.
+ */
+#ifndef LIBOS_BENCH_CONTENTION_CRITICAL_SECTION
+#define LIBOS_BENCH_CONTENTION_CRITICAL_SECTION 50
+#endif // LIBOS_BENCH_CONTENTION_CRITICAL_SECTION
+
+/**
+ * @brief The duration of every run of libos_bench_contention used by libos_bench_run_all, in milliseconds.
+ */
+#ifndef LIBOS_BENCH_CONTENTION_DURATION_MS
+#define LIBOS_BENCH_CONTENTION_DURATION_MS 200
+#endif // LIBOS_BENCH_CONTENTION_DURATION_MS
+
+/**
+ * @brief A benchmark, runs the operation under test @ref iterations times.
+ */
+typedef void (*libos_bench_fn_t)(void *context, uint32_t iterations);
+
+/**
+ * @brief The result of a benchmark, in nanoseconds per operation.
+ */
+typedef struct libos_bench_result_s
+{
+    double mean_ns; ///< The mean over all samples.
+    double p50_ns;  ///< The median sample.
+    double p99_ns;  ///< The 99th percentile sample.
+    uint32_t iterations; ///< The number of operations per sample.
+} libos_bench_result_t;
+
+/**
+ * @brief Keeps the compiler from optimizing away the calculation of @ref value.
+ */
+#define LIBOS_BENCH_KEEP(value) (libos_bench_sink = (uintptr_t)(value))
+
+/**
+ * @brief The target of LIBOS_BENCH_KEEP.
+ */
+extern volatile uintptr_t libos_bench_sink;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Calibrates the ticks used for the measurements, has to be called once before the first benchmark.
+ * 
+ * @return libos_err_t The error of libos_time_ticks_calibrate.
+ */
+libos_err_t libos_bench_init(void);
+
+/**
+ * @brief Measures a benchmark.
+ * 
+ * @param[in] fn The benchmark.
+ * @param[in] context Passed to @ref fn.
+ * @param[out] result The time per operation.
+ * 
+ * @return libos_err_t LIBOS_ERR_OK when measured, LIBOS_ERR_INVALID_ARG if @ref fn or @ref result is NULL.
+ */
+libos_err_t libos_bench_measure(libos_bench_fn_t fn, void *context, libos_bench_result_t *result);
+
+/**
+ * @brief Prints a result as one line of the report.
+ * 
+ * @param[in] name The name of the benchmark.
+ * @param[in] result The result of libos_bench_measure.
+ */
+void libos_bench_report(const char *name, const libos_bench_result_t *result);
+
+/**
+ * @brief Measures a benchmark and prints the result.
+ * 
+ * @param[in] name The name of the benchmark.
+ * @param[in] fn The benchmark.
+ * @param[in] context Passed to @ref fn.
+ * 
+ * @return libos_err_t The error of libos_bench_measure.
+ */
+libos_err_t libos_bench_run(const char *name, libos_bench_fn_t fn, void *context);
+
+/**
+ * @brief Runs the benchmarks of libos_time_get_now and the ticks.
+ */
+libos_err_t libos_bench_time(void);
+
+/**
+ * @brief Runs the uncontended and contended mutex benchmarks.
+ */
+libos_err_t libos_bench_mutex(void);
+
+/**
+ * @brief Measures the mutex throughput and fairness for an increasing number of workers.
+ * 
+ * @details
+ * For every mutex kind (plain, and adaptive and recursive when enabled) the
+ * workers lock @ref mutexes mutexes in turn for @ref duration_ms, each
+ * worker starting at a different one. With a single mutex all workers
+ * contend for it, with as many mutexes as workers they mostly don't.
+ * The runs use 1, 2, 4, ... up to @ref max_threads workers, and report the
+ * total operations per second, per worker, and the longest a worker had to
+ * wait for a single operation (the starvation).
+ * 
+ * @param[in] max_threads The number of workers of the last run, at most LIBOS_BENCH_CONTENTION_MAX_THREADS.
+ * @param[in] mutexes The number of mutexes, at most LIBOS_BENCH_CONTENTION_MAX_MUTEXES.
+ * @param[in] critical_section The number of busy loop iterations while holding a mutex.
+ * @param[in] duration_ms The duration of every run.
+ * 
+ * @retval LIBOS_ERR_OK All runs completed.
+ * @retval LIBOS_ERR_INVALID_ARG A argument is out of range.
+ * @retval LIBOS_ERR_INVALID_STATE The mutex didn't provide mutual exclusion.
+ * 
+ * @return libos_err_t The libos standard success code, or the error of the mutex or thread API.
+ */
+libos_err_t libos_bench_contention(uint32_t max_threads, uint32_t mutexes, uint32_t critical_section, uint32_t duration_ms);
+
+/**
+ * @brief Runs the benchmarks of the bits.h array access.
+ */
+libos_err_t libos_bench_bits(void);
+
+/**
+ * @brief Calibrates and runs all benchmarks, the entry point for a application.
+ * 
+ * @return libos_err_t LIBOS_ERR_OK if all benchmarks ran.
+ */
+libos_err_t libos_bench_run_all(void);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_BENCH_H
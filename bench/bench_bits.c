@@ -0,0 +1,68 @@
+#include "bench.h"
+#include "libos/bits.h"
+
+#define BENCH_BITS_WORDS 1024
+
+static uint8_t bench_bits_bytes[BENCH_BITS_WORDS * 4];
+static uint32_t bench_bits_words[BENCH_BITS_WORDS];
+
+// One operation is the conversion of a whole 4 KiB block.
+static void bench_bits_get_32_in_array(void *context, uint32_t iterations)
+{
+    (void)context;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        for (size_t word = 0; word < BENCH_BITS_WORDS; word++)
+        {
+            bench_bits_words[word] = GET_32_IN_ARRAY(bench_bits_bytes, word * 4);
+        }
+        LIBOS_BENCH_KEEP(bench_bits_words[i % BENCH_BITS_WORDS]);
+    }
+}
+
+static void bench_bits_set_32_in_array(void *context, uint32_t iterations)
+{
+    (void)context;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        for (size_t word = 0; word < BENCH_BITS_WORDS; word++)
+        {
+            SET_32_IN_ARRAY(bench_bits_bytes, bench_bits_words[word], word * 4);
+        }
+        LIBOS_BENCH_KEEP(bench_bits_bytes[i % sizeof(bench_bits_bytes)]);
+    }
+}
+
+static void bench_bits_load_be32_array(void *context, uint32_t iterations)
+{
+    (void)context;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        libos_load_be32_array(bench_bits_words, bench_bits_bytes, BENCH_BITS_WORDS);
+        LIBOS_BENCH_KEEP(bench_bits_words[i % BENCH_BITS_WORDS]);
+    }
+}
+
+static void bench_bits_store_be32_array(void *context, uint32_t iterations)
+{
+    (void)context;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        libos_store_be32_array(bench_bits_bytes, bench_bits_words, BENCH_BITS_WORDS);
+        LIBOS_BENCH_KEEP(bench_bits_bytes[i % sizeof(bench_bits_bytes)]);
+    }
+}
+
+libos_err_t libos_bench_bits(void)
+{
+    for (size_t i = 0; i < sizeof(bench_bits_bytes); i++)
+    {
+        bench_bits_bytes[i] = (uint8_t)i;
+    }
+
+    LIBOS_ERR_CHECK(libos_bench_run("GET_32_IN_ARRAY (4 KiB)", bench_bits_get_32_in_array, NULL));
+    LIBOS_ERR_CHECK(libos_bench_run("SET_32_IN_ARRAY (4 KiB)", bench_bits_set_32_in_array, NULL));
+    LIBOS_ERR_CHECK(libos_bench_run("libos_load_be32_array (4 KiB)", bench_bits_load_be32_array, NULL));
+    LIBOS_ERR_CHECK(libos_bench_run("libos_store_be32_array (4 KiB)", bench_bits_store_be32_array, NULL));
+    return LIBOS_ERR_OK;
+}
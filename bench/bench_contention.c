@@ -0,0 +1,250 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "bench.h"
+#include "libos/concurrent/atomic.h"
+#include "libos/concurrent/mutex.h"
+#include "libos/concurrent/thread.h"
+
+#ifndef LIBOS_CACHE_LINE_SIZE
+#define LIBOS_CACHE_LINE_SIZE 64
+#endif // LIBOS_CACHE_LINE_SIZE
+
+// The timeout of the lock calls, only reached when a port is broken.
+#define BENCH_CONTENTION_TIMEOUT libos_time_from_ms(10000)
+
+typedef enum
+{
+    BENCH_CONTENTION_PLAIN,
+#if LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+    BENCH_CONTENTION_ADAPTIVE,
+#endif // LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+#if LIBOS_MUTEX_ENABLE_RECURSIVE==1
+    BENCH_CONTENTION_RECURSIVE,
+#endif // LIBOS_MUTEX_ENABLE_RECURSIVE==1
+    BENCH_CONTENTION_MODES,
+} bench_contention_mode_t;
+
+static const char *const bench_contention_mode_names[BENCH_CONTENTION_MODES] = {
+    "plain",
+#if LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+    "adaptive",
+#endif // LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+#if LIBOS_MUTEX_ENABLE_RECURSIVE==1
+    "recursive",
+#endif // LIBOS_MUTEX_ENABLE_RECURSIVE==1
+};
+
+// The data guarded by a mutex, on its own cache line such that only the mutex is contended.
+typedef struct
+{
+    _Alignas(LIBOS_CACHE_LINE_SIZE) uint64_t count;
+} bench_contention_counter_t;
+
+typedef struct
+{
+    uint32_t index;
+    uint64_t operations;
+    libos_time_microseconds_t max_wait_us;
+    libos_err_t err;
+    libos_thread_handle_t thread;
+} bench_contention_worker_t;
+
+#if LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
+static LIBOS_MUTEX_STATIC_DATA_STRUCT(bench_contention_data[LIBOS_BENCH_CONTENTION_MAX_MUTEXES]);
+#endif // LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
+static libos_mutex_handle_t bench_contention_mutexes[LIBOS_BENCH_CONTENTION_MAX_MUTEXES];
+static bench_contention_counter_t bench_contention_counters[LIBOS_BENCH_CONTENTION_MAX_MUTEXES];
+static bench_contention_worker_t bench_contention_workers[LIBOS_BENCH_CONTENTION_MAX_THREADS];
+#if LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+static LIBOS_THREAD_STATIC_DATA_STRUCT(bench_contention_threads[LIBOS_BENCH_CONTENTION_MAX_THREADS], LIBOS_THREAD_STACK_SIZE_DEFAULT);
+#endif // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+
+// The parameters of the current run, only written while no worker runs.
+static uint32_t bench_contention_mutex_count;
+static uint32_t bench_contention_critical_section;
+static libos_time_microseconds_t bench_contention_duration_us;
+// The workers that are ready, and the flag on which they all start together.
+static libos_atomic_uint32_t bench_contention_started;
+static libos_atomic_uint32_t bench_contention_go;
+
+static libos_err_t bench_contention_create(bench_contention_mode_t mode, uint32_t index)
+{
+    switch (mode)
+    {
+#if LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+    case BENCH_CONTENTION_ADAPTIVE:
+        return LIBOS_MUTEX_CREATE_ADAPTIVE_PREFER_STATIC(bench_contention_data[index], bench_contention_mutexes[index], LIBOS_MUTEX_ADAPTIVE_DEFAULT_SPIN_COUNT);
+#endif // LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+#if LIBOS_MUTEX_ENABLE_RECURSIVE==1
+    case BENCH_CONTENTION_RECURSIVE:
+        return LIBOS_MUTEX_CREATE_RECURSIVE_PREFER_STATIC(bench_contention_data[index], bench_contention_mutexes[index]);
+#endif // LIBOS_MUTEX_ENABLE_RECURSIVE==1
+    default:
+        return LIBOS_MUTEX_CREATE_PREFER_STATIC(bench_contention_data[index], bench_contention_mutexes[index]);
+    }
+}
+
+static void bench_contention_worker(void *arg)
+{
+    bench_contention_worker_t *worker = (bench_contention_worker_t *)arg;
+    uint64_t operations = 0;
+    libos_time_microseconds_t max_wait_us = 0;
+    // Every worker starts at a different mutex and takes them in turn.
+    uint32_t next = worker->index % bench_contention_mutex_count;
+
+    // Wait for the other workers, the first ones would otherwise run uncontended until the last is created.
+    LIBOS_ATOMIC_FETCH_ADD(&bench_contention_started, 1, LIBOS_ATOMIC_RELAXED);
+    while (LIBOS_ATOMIC_LOAD(&bench_contention_go, LIBOS_ATOMIC_ACQUIRE) == 0)
+    {
+        libos_thread_yield();
+    }
+    libos_time_t start = libos_time_get_now();
+    libos_time_t before = start;
+    while (libos_time_difference_us(start, before) < bench_contention_duration_us)
+    {
+        libos_err_t err = libos_mutex_lock(bench_contention_mutexes[next], BENCH_CONTENTION_TIMEOUT);
+        if (err != LIBOS_ERR_OK)
+        {
+            worker->err = err;
+            break;
+        }
+
+        bench_contention_counters[next].count++;
+        for (volatile uint32_t spin = 0; spin < bench_contention_critical_section; spin++)
+        {
+        }
+        libos_mutex_unlock(bench_contention_mutexes[next]);
+
+        // The time until the worker got through, the wait for the lock plus its own critical section.
+        libos_time_t released = libos_time_get_now();
+        libos_time_microseconds_t wait_us = libos_time_difference_us(before, released);
+        if (wait_us > max_wait_us)
+        {
+            max_wait_us = wait_us;
+        }
+        before = released;
+        operations++;
+        if (++next == bench_contention_mutex_count)
+        {
+            next = 0;
+        }
+    }
+
+    worker->operations = operations;
+    worker->max_wait_us = max_wait_us;
+}
+
+// Runs the workers on the created mutexes and reports the throughput and the longest wait.
+static libos_err_t bench_contention_run(const char *mode_name, uint32_t threads)
+{
+    for (uint32_t i = 0; i < bench_contention_mutex_count; i++)
+    {
+        bench_contention_counters[i].count = 0;
+    }
+    LIBOS_ATOMIC_STORE(&bench_contention_started, 0, LIBOS_ATOMIC_RELAXED);
+    LIBOS_ATOMIC_STORE(&bench_contention_go, 0, LIBOS_ATOMIC_RELAXED);
+
+    libos_thread_config_t config = LIBOS_THREAD_CONFIG_DEFAULT("bench_worker");
+    uint32_t created = 0;
+    libos_err_t err = LIBOS_ERR_OK;
+    while (created < threads && err == LIBOS_ERR_OK)
+    {
+        bench_contention_worker_t *worker = &bench_contention_workers[created];
+        worker->index = created;
+        worker->operations = 0;
+        worker->max_wait_us = 0;
+        worker->err = LIBOS_ERR_OK;
+        err = LIBOS_THREAD_CREATE_PREFER_STATIC(bench_contention_threads[created], worker->thread, &config, bench_contention_worker, worker);
+        if (err == LIBOS_ERR_OK)
+        {
+            created++;
+        }
+    }
+
+    // Release the workers once all of them are running (also after a failed create, so they can be joined).
+    while (LIBOS_ATOMIC_LOAD(&bench_contention_started, LIBOS_ATOMIC_RELAXED) < created)
+    {
+        libos_thread_yield();
+    }
+    libos_time_t start = libos_time_get_now();
+    LIBOS_ATOMIC_STORE(&bench_contention_go, 1, LIBOS_ATOMIC_RELEASE);
+
+    uint64_t operations = 0;
+    libos_time_microseconds_t max_wait_us = 0;
+    for (uint32_t i = 0; i < created; i++)
+    {
+        bench_contention_worker_t *worker = &bench_contention_workers[i];
+        libos_thread_join(worker->thread);
+        operations += worker->operations;
+        if (worker->max_wait_us > max_wait_us)
+        {
+            max_wait_us = worker->max_wait_us;
+        }
+        if (worker->err != LIBOS_ERR_OK)
+        {
+            err = worker->err;
+        }
+    }
+    libos_time_microseconds_t elapsed_us = libos_time_difference_us(start, libos_time_get_now());
+    LIBOS_ERR_CHECK(err);
+
+    // Every operation increments a guarded counter once, anything else is a broken mutex.
+    uint64_t counted = 0;
+    for (uint32_t i = 0; i < bench_contention_mutex_count; i++)
+    {
+        counted += bench_contention_counters[i].count;
+    }
+    LIBOS_ERR_RET_ON_TRUE(counted != operations, LIBOS_ERR_INVALID_STATE);
+
+    double ops_per_s = (elapsed_us > 0) ? ((double)operations * 1e6) / (double)elapsed_us : 0.0;
+    printf("%-10s %3lu mutexes %3lu threads %12.0f ops/s %12.0f ops/s/thread  max wait %8lld us\n",
+        mode_name, (unsigned long)bench_contention_mutex_count, (unsigned long)threads,
+        ops_per_s, ops_per_s / threads, (long long)max_wait_us);
+    return LIBOS_ERR_OK;
+}
+
+libos_err_t libos_bench_contention(uint32_t max_threads, uint32_t mutexes, uint32_t critical_section, uint32_t duration_ms)
+{
+    LIBOS_ERR_RET_ARG_IN_RANGE(max_threads, 1, LIBOS_BENCH_CONTENTION_MAX_THREADS);
+    LIBOS_ERR_RET_ARG_IN_RANGE(mutexes, 1, LIBOS_BENCH_CONTENTION_MAX_MUTEXES);
+    LIBOS_ERR_RET_ON_TRUE(duration_ms == 0, LIBOS_ERR_INVALID_ARG);
+
+    bench_contention_mutex_count = mutexes;
+    bench_contention_critical_section = critical_section;
+    bench_contention_duration_us = (libos_time_microseconds_t)duration_ms * 1000;
+
+    printf("mutex contention, critical section of %lu iterations\n", (unsigned long)critical_section);
+    for (int mode = 0; mode < BENCH_CONTENTION_MODES; mode++)
+    {
+        uint32_t created = 0;
+        libos_err_t err = LIBOS_ERR_OK;
+        while (created < mutexes && err == LIBOS_ERR_OK)
+        {
+            err = bench_contention_create((bench_contention_mode_t)mode, created);
+            if (err == LIBOS_ERR_OK)
+            {
+                created++;
+            }
+        }
+
+        // 1, 2, 4, ... and max_threads itself.
+        uint32_t threads = 1;
+        while (err == LIBOS_ERR_OK)
+        {
+            err = bench_contention_run(bench_contention_mode_names[mode], threads);
+            if (threads == max_threads)
+            {
+                break;
+            }
+            threads = (threads * 2 < max_threads) ? threads * 2 : max_threads;
+        }
+
+        for (uint32_t i = 0; i < created; i++)
+        {
+            libos_mutex_delete(bench_contention_mutexes[i]);
+        }
+        LIBOS_ERR_CHECK(err);
+    }
+    return LIBOS_ERR_OK;
+}
@@ -0,0 +1,83 @@
+#include <stdbool.h>
+
+#include "bench.h"
+#include "libos/concurrent/atomic.h"
+#include "libos/concurrent/mutex.h"
+#include "libos/concurrent/thread.h"
+
+// The timeout of the lock calls, only reached when a port is broken.
+#define BENCH_MUTEX_TIMEOUT libos_time_from_ms(10000)
+
+#if LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
+static LIBOS_MUTEX_STATIC_DATA_STRUCT(bench_mutex_data);
+#endif // LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
+#if LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+static LIBOS_THREAD_STATIC_DATA_STRUCT(bench_mutex_contender_data, LIBOS_THREAD_STACK_SIZE_DEFAULT);
+#endif // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+static libos_mutex_handle_t bench_mutex;
+static libos_atomic_uint32_t bench_mutex_running;
+
+static void bench_mutex_lock_unlock(void *context, uint32_t iterations)
+{
+    (void)context;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        libos_mutex_lock(bench_mutex, BENCH_MUTEX_TIMEOUT);
+        libos_mutex_unlock(bench_mutex);
+    }
+}
+
+static void bench_mutex_try_lock_unlock(void *context, uint32_t iterations)
+{
+    (void)context;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        if (libos_mutex_try_lock(bench_mutex) == LIBOS_ERR_OK)
+        {
+            libos_mutex_unlock(bench_mutex);
+        }
+    }
+}
+
+// The failing probe of a mutex that is held, the caller holds it.
+static void bench_mutex_try_lock_busy(void *context, uint32_t iterations)
+{
+    (void)context;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        LIBOS_BENCH_KEEP(libos_mutex_try_lock(bench_mutex));
+    }
+}
+
+// Takes and releases the mutex as fast as possible, to contend with the benchmark.
+static void bench_mutex_contender(void *arg)
+{
+    (void)arg;
+    while (LIBOS_ATOMIC_LOAD(&bench_mutex_running, LIBOS_ATOMIC_RELAXED) != 0)
+    {
+        libos_mutex_lock(bench_mutex, BENCH_MUTEX_TIMEOUT);
+        libos_mutex_unlock(bench_mutex);
+    }
+}
+
+libos_err_t libos_bench_mutex(void)
+{
+    LIBOS_ERR_CHECK(LIBOS_MUTEX_CREATE_PREFER_STATIC(bench_mutex_data, bench_mutex));
+
+    LIBOS_ERR_CHECK(libos_bench_run("mutex lock+unlock", bench_mutex_lock_unlock, NULL));
+    LIBOS_ERR_CHECK(libos_bench_run("mutex try_lock+unlock", bench_mutex_try_lock_unlock, NULL));
+
+    LIBOS_ERR_CHECK(libos_mutex_lock(bench_mutex, BENCH_MUTEX_TIMEOUT));
+    libos_err_t err = libos_bench_run("mutex try_lock (held)", bench_mutex_try_lock_busy, NULL);
+    LIBOS_ERR_CHECK(libos_mutex_unlock(bench_mutex));
+    LIBOS_ERR_CHECK(err);
+
+    libos_thread_config_t config = LIBOS_THREAD_CONFIG_DEFAULT("bench_contender");
+    libos_thread_handle_t contender;
+    LIBOS_ATOMIC_STORE(&bench_mutex_running, 1, LIBOS_ATOMIC_RELAXED);
+    LIBOS_ERR_CHECK(LIBOS_THREAD_CREATE_PREFER_STATIC(bench_mutex_contender_data, contender, &config, bench_mutex_contender, NULL));
+    err = libos_bench_run("mutex lock+unlock (contended)", bench_mutex_lock_unlock, NULL);
+    LIBOS_ATOMIC_STORE(&bench_mutex_running, 0, LIBOS_ATOMIC_RELAXED);
+    LIBOS_ERR_CHECK(libos_thread_join(contender));
+    return err;
+}
@@ -0,0 +1,37 @@
+#include "bench.h"
+
+static void bench_time_get_now(void *context, uint32_t iterations)
+{
+    (void)context;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        LIBOS_BENCH_KEEP(libos_time_get_now());
+    }
+}
+
+static void bench_time_difference_us(void *context, uint32_t iterations)
+{
+    (void)context;
+    libos_time_t start = libos_time_get_now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        LIBOS_BENCH_KEEP(libos_time_difference_us(start, libos_time_get_now()));
+    }
+}
+
+static void bench_time_ticks_now(void *context, uint32_t iterations)
+{
+    (void)context;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        LIBOS_BENCH_KEEP(libos_time_ticks_now());
+    }
+}
+
+libos_err_t libos_bench_time(void)
+{
+    LIBOS_ERR_CHECK(libos_bench_run("libos_time_get_now", bench_time_get_now, NULL));
+    LIBOS_ERR_CHECK(libos_bench_run("libos_time_difference_us", bench_time_difference_us, NULL));
+    LIBOS_ERR_CHECK(libos_bench_run("libos_time_ticks_now", bench_time_ticks_now, NULL));
+    return LIBOS_ERR_OK;
+}
@@ -0,0 +1,14 @@
+#include <stdio.h>
+
+#include "bench.h"
+
+int main(void)
+{
+    libos_err_t err = libos_bench_run_all();
+    if (err != LIBOS_ERR_OK)
+    {
+        printf("benchmarks failed: %d\n", (int)err);
+        return 1;
+    }
+    return 0;
+}
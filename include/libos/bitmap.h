@@ -0,0 +1,293 @@
+/**
+ * @file bitmap.h
+ * @brief Multi-word bitmaps with word-at-a-time search and range operations.
+ * 
+ * @details
+ * A bitmap is a plain array of libos_bitmap_word_t, bit 0 is the least
+ * significant bit of the first word. The size in bits is given to every
+ * operation, the bits in the last word beyond the size are ignored by the
+ * searches and never set by the range operations. Searching and counting
+ * work on a whole word at a time with LIBOS_CTZ and LIBOS_POPCOUNT of
+ * bits.h, which map to single instructions on most architectures.
+ * 
+ * The operations are not atomic, the caller has to protect a bitmap that is
+ * shared between tasks.
+ * 
+ * @code
+ * static LIBOS_BITMAP_DEFINE(slots, 100);
+ * 
+ * size_t free_slot = libos_bitmap_find_first_clear(slots, 100);
+ * if (free_slot < 100)
+ * {
+ *     libos_bitmap_set(slots, free_slot);
+ * }
+ * @endcode
+ */
+
+#pragma once
+#ifndef LIBOS_BITMAP_H
+#define LIBOS_BITMAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "libos/bits.h"
+
+/**
+ * @brief The size in bits of a bitmap word, 32 or 64. By default the native word size.
+ */
+#ifndef LIBOS_BITMAP_WORD_BITS
+#if UINTPTR_MAX > UINT32_MAX
+#define LIBOS_BITMAP_WORD_BITS 64
+#else // UINTPTR_MAX > UINT32_MAX
+#define LIBOS_BITMAP_WORD_BITS 32
+#endif // UINTPTR_MAX > UINT32_MAX
+#endif // LIBOS_BITMAP_WORD_BITS
+
+#if LIBOS_BITMAP_WORD_BITS==64
+typedef uint64_t libos_bitmap_word_t;
+#define LIBOS_BITMAP_CTZ_(word) LIBOS_CTZ64(word)
+#define LIBOS_BITMAP_POPCOUNT_(word) LIBOS_POPCOUNT64(word)
+#elif LIBOS_BITMAP_WORD_BITS==32
+typedef uint32_t libos_bitmap_word_t;
+#define LIBOS_BITMAP_CTZ_(word) LIBOS_CTZ32(word)
+#define LIBOS_BITMAP_POPCOUNT_(word) LIBOS_POPCOUNT32(word)
+#else
+#error "LIBOS_BITMAP_WORD_BITS has to be 32 or 64."
+#endif // LIBOS_BITMAP_WORD_BITS==64
+
+/**
+ * @brief The number of words needed for a bitmap of @ref bits bits.
+ */
+#define LIBOS_BITMAP_WORDS(bits) (((size_t)(bits) + LIBOS_BITMAP_WORD_BITS - 1) / LIBOS_BITMAP_WORD_BITS)
+
+/**
+ * @brief Defines a bitmap of @ref bits bits, zero initialized when static.
+ * 
+ * @param name The name of the array.
+ * @param bits The size of the bitmap in bits.
+ */
+#define LIBOS_BITMAP_DEFINE(name, bits) libos_bitmap_word_t name[LIBOS_BITMAP_WORDS(bits)]
+
+// The mask of the bits in a word from bit 'first' (inclusive) up.
+#define LIBOS_BITMAP_MASK_FROM_(first) (~(libos_bitmap_word_t)0 << (first))
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Sets a single bit.
+ * 
+ * @param[in,out] bitmap The bitmap.
+ * @param[in] bit The index of the bit.
+ */
+static inline void libos_bitmap_set(libos_bitmap_word_t *bitmap, size_t bit)
+{
+    bitmap[bit / LIBOS_BITMAP_WORD_BITS] |= (libos_bitmap_word_t)1 << (bit % LIBOS_BITMAP_WORD_BITS);
+}
+
+/**
+ * @brief Clears a single bit.
+ * 
+ * @param[in,out] bitmap The bitmap.
+ * @param[in] bit The index of the bit.
+ */
+static inline void libos_bitmap_clear(libos_bitmap_word_t *bitmap, size_t bit)
+{
+    bitmap[bit / LIBOS_BITMAP_WORD_BITS] &= ~((libos_bitmap_word_t)1 << (bit % LIBOS_BITMAP_WORD_BITS));
+}
+
+/**
+ * @brief Checks if a single bit is set.
+ * 
+ * @param[in] bitmap The bitmap.
+ * @param[in] bit The index of the bit.
+ * 
+ * @retval true The bit is set.
+ * @retval false The bit is clear.
+ */
+static inline bool libos_bitmap_test(const libos_bitmap_word_t *bitmap, size_t bit)
+{
+    return ((bitmap[bit / LIBOS_BITMAP_WORD_BITS] >> (bit % LIBOS_BITMAP_WORD_BITS)) & 1) != 0;
+}
+
+/**
+ * @brief Clears all bits of the bitmap.
+ * 
+ * @param[out] bitmap The bitmap.
+ * @param[in] bits The size of the bitmap in bits.
+ */
+static inline void libos_bitmap_zero(libos_bitmap_word_t *bitmap, size_t bits)
+{
+    for (size_t i = 0; i < LIBOS_BITMAP_WORDS(bits); i++)
+    {
+        bitmap[i] = 0;
+    }
+}
+
+// Sets or clears count bits starting at first, a (partial) word at a time.
+static inline void libos_bitmap_assign_range_(libos_bitmap_word_t *bitmap, size_t first, size_t count, bool value)
+{
+    size_t index = first / LIBOS_BITMAP_WORD_BITS;
+    size_t offset = first % LIBOS_BITMAP_WORD_BITS;
+    while (count > 0)
+    {
+        size_t span = LIBOS_BITMAP_WORD_BITS - offset;
+        if (span > count)
+        {
+            span = count;
+        }
+        libos_bitmap_word_t mask = LIBOS_BITMAP_MASK_FROM_(offset);
+        if (offset + span < LIBOS_BITMAP_WORD_BITS)
+        {
+            mask &= ~LIBOS_BITMAP_MASK_FROM_(offset + span);
+        }
+
+        if (value)
+        {
+            bitmap[index] |= mask;
+        }
+        else
+        {
+            bitmap[index] &= ~mask;
+        }
+        count -= span;
+        offset = 0;
+        index++;
+    }
+}
+
+/**
+ * @brief Sets @ref count bits starting at @ref first, a word at a time.
+ * 
+ * @param[in,out] bitmap The bitmap.
+ * @param[in] first The index of the first bit to set.
+ * @param[in] count The number of bits to set, the range has to be inside the bitmap.
+ */
+static inline void libos_bitmap_set_range(libos_bitmap_word_t *bitmap, size_t first, size_t count)
+{
+    libos_bitmap_assign_range_(bitmap, first, count, true);
+}
+
+/**
+ * @brief Clears @ref count bits starting at @ref first, a word at a time.
+ * 
+ * @param[in,out] bitmap The bitmap.
+ * @param[in] first The index of the first bit to clear.
+ * @param[in] count The number of bits to clear, the range has to be inside the bitmap.
+ */
+static inline void libos_bitmap_clear_range(libos_bitmap_word_t *bitmap, size_t first, size_t count)
+{
+    libos_bitmap_assign_range_(bitmap, first, count, false);
+}
+
+// Finds the first set (or clear when invert is true) bit at or after start.
+static inline size_t libos_bitmap_find_(const libos_bitmap_word_t *bitmap, size_t bits, size_t start, bool invert)
+{
+    if (start >= bits)
+    {
+        return bits;
+    }
+
+    const libos_bitmap_word_t flip = invert ? ~(libos_bitmap_word_t)0 : 0;
+    size_t index = start / LIBOS_BITMAP_WORD_BITS;
+    libos_bitmap_word_t word = (bitmap[index] ^ flip) & LIBOS_BITMAP_MASK_FROM_(start % LIBOS_BITMAP_WORD_BITS);
+    const size_t words = LIBOS_BITMAP_WORDS(bits);
+    while (word == 0)
+    {
+        if (++index >= words)
+        {
+            return bits;
+        }
+        word = bitmap[index] ^ flip;
+    }
+
+    size_t found = index * LIBOS_BITMAP_WORD_BITS + (size_t)LIBOS_BITMAP_CTZ_(word);
+    // Bits in the last word beyond the size don't count.
+    return (found < bits) ? found : bits;
+}
+
+/**
+ * @brief Finds the first set bit.
+ * 
+ * @param[in] bitmap The bitmap.
+ * @param[in] bits The size of the bitmap in bits.
+ * 
+ * @return size_t The index of the first set bit, or @ref bits if no bit is set.
+ */
+static inline size_t libos_bitmap_find_first_set(const libos_bitmap_word_t *bitmap, size_t bits)
+{
+    return libos_bitmap_find_(bitmap, bits, 0, false);
+}
+
+/**
+ * @brief Finds the first clear bit.
+ * 
+ * @param[in] bitmap The bitmap.
+ * @param[in] bits The size of the bitmap in bits.
+ * 
+ * @return size_t The index of the first clear bit, or @ref bits if all bits are set.
+ */
+static inline size_t libos_bitmap_find_first_clear(const libos_bitmap_word_t *bitmap, size_t bits)
+{
+    return libos_bitmap_find_(bitmap, bits, 0, true);
+}
+
+/**
+ * @brief Finds the first set bit at or after @ref start.
+ * 
+ * @param[in] bitmap The bitmap.
+ * @param[in] bits The size of the bitmap in bits.
+ * @param[in] start The index of the bit to start searching from.
+ * 
+ * @return size_t The index of the set bit, or @ref bits if there is none.
+ */
+static inline size_t libos_bitmap_find_next_set(const libos_bitmap_word_t *bitmap, size_t bits, size_t start)
+{
+    return libos_bitmap_find_(bitmap, bits, start, false);
+}
+
+/**
+ * @brief Finds the first clear bit at or after @ref start.
+ * 
+ * @param[in] bitmap The bitmap.
+ * @param[in] bits The size of the bitmap in bits.
+ * @param[in] start The index of the bit to start searching from.
+ * 
+ * @return size_t The index of the clear bit, or @ref bits if there is none.
+ */
+static inline size_t libos_bitmap_find_next_clear(const libos_bitmap_word_t *bitmap, size_t bits, size_t start)
+{
+    return libos_bitmap_find_(bitmap, bits, start, true);
+}
+
+/**
+ * @brief Counts the set bits.
+ * 
+ * @param[in] bitmap The bitmap.
+ * @param[in] bits The size of the bitmap in bits.
+ * 
+ * @return size_t The number of set bits.
+ */
+static inline size_t libos_bitmap_count(const libos_bitmap_word_t *bitmap, size_t bits)
+{
+    size_t count = 0;
+    size_t full = bits / LIBOS_BITMAP_WORD_BITS;
+    for (size_t i = 0; i < full; i++)
+    {
+        count += (size_t)LIBOS_BITMAP_POPCOUNT_(bitmap[i]);
+    }
+    if (bits % LIBOS_BITMAP_WORD_BITS != 0)
+    {
+        count += (size_t)LIBOS_BITMAP_POPCOUNT_(bitmap[full] & ~LIBOS_BITMAP_MASK_FROM_(bits % LIBOS_BITMAP_WORD_BITS));
+    }
+    return count;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_BITMAP_H
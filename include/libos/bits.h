@@ -22,6 +22,12 @@
  * Generally speaking, the macros do not assume any types. Unless explicitly
  * stated. Examples are the macros to retrieve nibbles of a byte, or combine
  * singular bytes into a larger word like 16 bit words.
+ * 
+ * The exception to the above are the functions that convert the byte order
+ * of whole arrays (libos_bswap16_array and friends). Those are used on
+ * larger buffers at run-time, the default implementation processes a word
+ * at a time and a platform can replace each of them with a version that uses
+ * the SIMD or byte swap instructions of the architecture.
  *
  * IMPLEMENTORS:
  * Implementors are free to override any macro that they want. It is required
@@ -60,9 +66,22 @@
 #define LIBOS_BITS_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include <string.h>
 
 #include "libos/platform/bits.h"
 
+#ifndef LIBOS_BIT
+
+/**
+ * @brief The mask with only the given bit set, as a 64 bit value such that every bit index of a 64 bit value works.
+ * 
+ * @param bit The index (0-based, at most 63) of the bit.
+ * 
+ */
+#define LIBOS_BIT(bit) ((uint64_t)1 << (bit))
+#endif // LIBOS_BIT
+
 #ifndef GET_MASK
 
 /**
@@ -118,7 +137,7 @@
  * @return false if the bit is NOT set.
  *
  */
-#define HAS_FLAG(value, flag_pos) (HAS_MASK(value, 1 << flag_pos))
+#define HAS_FLAG(value, flag_pos) (HAS_MASK(value, LIBOS_BIT(flag_pos)))
 #endif
 
 #ifndef ONLY_FLAG
@@ -133,7 +152,7 @@
  * @return false if is NOT the only bit is set.
  *
  */
-#define ONLY_FLAG(value, flag_pos) ( (HAS_FLAG(value, flag_pos) && (((value) & (1 << (flag_pos))) == (value))) )
+#define ONLY_FLAG(value, flag_pos) ( (HAS_FLAG(value, flag_pos) && (((value) & LIBOS_BIT(flag_pos)) == (value))) )
 #endif
 
 #ifndef SET_MASK
@@ -169,7 +188,7 @@
  * @param flag_pos The index (0-based) of the bit to set in the value.
  * 
  */
-#define SET_FLAG(value, flag_pos) (SET_MASK(value, (1 << flag_pos)))
+#define SET_FLAG(value, flag_pos) (SET_MASK(value, LIBOS_BIT(flag_pos)))
 #endif
 
 #ifndef CLEAR_FLAG
@@ -181,7 +200,7 @@
  * @param flag_pos The index (0-based) of the bit to set in the value.
  * 
  */
-#define CLEAR_FLAG(value, flag_pos) (CLEAR_MASK(value, (1 << flag_pos)))
+#define CLEAR_FLAG(value, flag_pos) (CLEAR_MASK(value, LIBOS_BIT(flag_pos)))
 #endif
 
 #ifndef SET_MASKED_VALUE
@@ -197,6 +216,96 @@
 #define SET_MASKED_VALUE(value, set_mask, set_value) ((value) = (((value) & (~set_mask)) | ((set_value) & (set_mask))))
 #endif
 
+#ifndef LIBOS_BITMASK32
+
+/**
+ * @brief The mask with the lowest @ref width bits set, as a 32 bit value.
+ * 
+ * @param width The number of bits, 1 up to 32.
+ * 
+ */
+#define LIBOS_BITMASK32(width) ((uint32_t)(UINT32_MAX >> (32 - (width))))
+#endif // LIBOS_BITMASK32
+
+#ifndef LIBOS_BITMASK64
+
+/**
+ * @brief The mask with the lowest @ref width bits set, as a 64 bit value.
+ * 
+ * @param width The number of bits, 1 up to 64.
+ * 
+ */
+#define LIBOS_BITMASK64(width) ((uint64_t)(UINT64_MAX >> (64 - (width))))
+#endif // LIBOS_BITMASK64
+
+#ifndef LIBOS_GENMASK32
+
+/**
+ * @brief The mask with bits @ref low up to and including @ref high set, as a 32 bit value.
+ * 
+ * @details
+ * Like the other mask macros, this is a constant expression for constant
+ * arguments, and can be used in static initialisation.
+ * 
+ * @param high The index of the highest bit of the mask, at most 31.
+ * @param low The index of the lowest bit of the mask, at most @ref high.
+ * 
+ */
+#define LIBOS_GENMASK32(high, low) ((uint32_t)(LIBOS_BITMASK32((high) - (low) + 1) << (low)))
+#endif // LIBOS_GENMASK32
+
+#ifndef LIBOS_GENMASK64
+
+/**
+ * @brief The mask with bits @ref low up to and including @ref high set, as a 64 bit value.
+ * 
+ * @param high The index of the highest bit of the mask, at most 63.
+ * @param low The index of the lowest bit of the mask, at most @ref high.
+ * 
+ */
+#define LIBOS_GENMASK64(high, low) ((uint64_t)(LIBOS_BITMASK64((high) - (low) + 1) << (low)))
+#endif // LIBOS_GENMASK64
+
+#ifndef LIBOS_BITFIELD_GET
+
+/**
+ * @brief Extracts the bit-field of @ref width bits starting at bit @ref lsb.
+ * 
+ * @details
+ * The result is shifted down to bit 0. With constant @ref lsb and @ref width
+ * this is a single shift and mask, which compilers emit as a bit-field
+ * extract instruction (like ubfx or extui) where the architecture has one.
+ * The value can be up to 64 bits, the result is a uint64_t that can be
+ * narrowed to the type of the field.
+ * 
+ * @param value The value that contains the field.
+ * @param lsb The index of the lowest bit of the field.
+ * @param width The number of bits of the field, 1 up to 64 - @ref lsb.
+ * 
+ */
+#define LIBOS_BITFIELD_GET(value, lsb, width) (((uint64_t)(value) >> (lsb)) & LIBOS_BITMASK64(width))
+#endif // LIBOS_BITFIELD_GET
+
+#ifndef LIBOS_BITFIELD_SET
+
+/**
+ * @brief Evaluates to @ref value with the bit-field of @ref width bits starting at bit @ref lsb replaced by @ref field.
+ * 
+ * @details
+ * Unlike SET_MASKED_VALUE this doesn't assign, it is a expression that can
+ * also be used in static initialisation. Bits of @ref field that don't fit
+ * in the field are ignored. The result is a uint64_t.
+ * 
+ * @param value The value that contains the field.
+ * @param lsb The index of the lowest bit of the field.
+ * @param width The number of bits of the field, 1 up to 64 - @ref lsb.
+ * @param field The new value of the field (not shifted).
+ * 
+ */
+#define LIBOS_BITFIELD_SET(value, lsb, width, field) \
+    (((uint64_t)(value) & ~(LIBOS_BITMASK64(width) << (lsb))) | (((uint64_t)(field) & LIBOS_BITMASK64(width)) << (lsb)))
+#endif // LIBOS_BITFIELD_SET
+
 #ifndef GET_LOWER_NIBBLE
 
 /**
@@ -279,6 +388,28 @@
 #define COMBINE_BYTES_32(higher, higher_middle, lower_middle, lower) ((uint32_t)COMBINE_BYTES_16(lower_middle, lower) | ((uint32_t)COMBINE_BYTES_16(higher, higher_middle) << 16))
 #endif
 
+#ifndef COMBINE_BYTES_64
+
+/**
+ * @brief Combines the given 8 bytes into a 64 bit unsigned integer.
+ * 
+ * @details
+ * The data entry for the parameters is like entering a big endian number. This
+ * is usually how larger number are also written.
+ * 
+ * @param b7 The most significant byte of the uint64 (bit 56-63).
+ * @param b6 Bit 48-55 of the uint64.
+ * @param b5 Bit 40-47 of the uint64.
+ * @param b4 Bit 32-39 of the uint64.
+ * @param b3 Bit 24-31 of the uint64.
+ * @param b2 Bit 16-23 of the uint64.
+ * @param b1 Bit 8-15 of the uint64.
+ * @param b0 The least significant byte of the uint64 (bit 0-7).
+ * 
+ */
+#define COMBINE_BYTES_64(b7, b6, b5, b4, b3, b2, b1, b0) ((uint64_t)COMBINE_BYTES_32(b3, b2, b1, b0) | ((uint64_t)COMBINE_BYTES_32(b7, b6, b5, b4) << 32))
+#endif
+
 #ifndef SET_16_IN_ARRAY
 
 /**
@@ -402,6 +533,292 @@
                                            ))
 #endif // GET_32_IN_ARRAY
 
+#ifndef SET_64_IN_ARRAY
+
+/**
+ * @brief Sets the given 64 bits of data at @ref byte_offset in the @ref data memory.
+ * 
+ * @details
+ * Be aware that this macro doesn't do any bounds checking on the array given
+ * to it. It is the users responsibility to ensure that data is written inside
+ * the allocated memory for the data.
+ * 
+ * Note that the byte endianess of @ref data is assumed to be big endian
+ * because this macro focuses on 'exporting' data is it where. Which is usually
+ * big-endian. If this is not the correct end ordering, use the _LE variant.
+ * 
+ * The default implementation accesses the bytes one by one, which optimizing
+ * compilers merge into a single (unaligned) access and a byte swap where the
+ * architecture allows it. A platform can also map it to those directly.
+ * 
+ * Whilst data, value and byte_offset are only evaluated once in the default
+ * implementation, this is not guaranteed for other platform implementations.
+ * 
+ * @param data The memory to place the data in.
+ * @param value The 64 bits of data to place in the memory.
+ * @param byte_offset The bytes in 8-bit words from the starting point of @ref data.
+ * 
+ */
+#define SET_64_IN_ARRAY(data, value, byte_offset) do { \
+        uint64_t __val = (value); \
+        uint8_t *__data = ((uint8_t*)(data) + (size_t)(byte_offset)); \
+        *(__data + 0) = (uint8_t)((__val >> 56) & 0xFF); \
+        *(__data + 1) = (uint8_t)((__val >> 48) & 0xFF); \
+        *(__data + 2) = (uint8_t)((__val >> 40) & 0xFF); \
+        *(__data + 3) = (uint8_t)((__val >> 32) & 0xFF); \
+        *(__data + 4) = (uint8_t)((__val >> 24) & 0xFF); \
+        *(__data + 5) = (uint8_t)((__val >> 16) & 0xFF); \
+        *(__data + 6) = (uint8_t)((__val >>  8) & 0xFF); \
+        *(__data + 7) = (uint8_t)((__val >>  0) & 0xFF); \
+    } while(0)
+#endif // SET_64_IN_ARRAY
+
+#ifndef GET_64_IN_ARRAY
+
+/**
+ * @brief Retrieves the 64 bits of data at @ref byte_offset in the @ref data memory.
+ * 
+ * @details
+ * Be aware that this macro doesn't do any bounds checking on the array given
+ * to it. It is the users responsibility to ensure that data is written inside
+ * the allocated memory for the data.
+ * 
+ * Note that the byte endianess of @ref data is assumed to be big endian
+ * because this macro focuses on 'exporting' data is it where. Which is usually
+ * big-endian. If this is not the correct end ordering, use the _LE variant.
+ * 
+ * The default implementation accesses the bytes one by one, which optimizing
+ * compilers merge into a single (unaligned) access and a byte swap where the
+ * architecture allows it. A platform can also map it to those directly.
+ * 
+ * Whilst data and byte_offset are only evaluated once in the default
+ * implementation, this is not guaranteed for other platform implementations.
+ * 
+ * @param data The memory to retrieve the data from.
+ * @param byte_offset The bytes in 8-bit words from the starting point of @ref data.
+ * 
+ * @return uint64_t The 64-bit value at the given location.
+ */
+#define GET_64_IN_ARRAY(data, byte_offset) ((uint64_t)( \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 0))) << 56) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 1))) << 48) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 2))) << 40) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 3))) << 32) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 4))) << 24) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 5))) << 16) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 6))) << 8) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 7))) << 0) \
+    ))
+#endif // GET_64_IN_ARRAY
+
+#ifndef SET_16_IN_ARRAY_LE
+
+/**
+ * @brief Sets the given 16 bits of data at @ref byte_offset in the @ref data memory as little endian.
+ * 
+ * @details
+ * Be aware that this macro doesn't do any bounds checking on the array given
+ * to it. It is the users responsibility to ensure that data is written inside
+ * the allocated memory for the data.
+ * 
+ * The bytes in @ref data are in little endian order, see the variant without
+ * _LE for big endian data.
+ * 
+ * The default implementation accesses the bytes one by one, which optimizing
+ * compilers merge into a single (unaligned) access where the architecture
+ * allows it. A platform can also map it to that directly.
+ * 
+ * Whilst data, value and byte_offset are only evaluated once in the default
+ * implementation, this is not guaranteed for other platform implementations.
+ * 
+ * @param data The memory to place the data in.
+ * @param value The 16 bits of data to place in the memory.
+ * @param byte_offset The bytes in 8-bit words from the starting point of @ref data.
+ * 
+ */
+#define SET_16_IN_ARRAY_LE(data, value, byte_offset) do { \
+        uint16_t __val = (value); \
+        uint8_t *__data = ((uint8_t*)(data) + (size_t)(byte_offset)); \
+        *(__data + 0) = (uint8_t)((__val >>  0) & 0xFF); \
+        *(__data + 1) = (uint8_t)((__val >>  8) & 0xFF); \
+    } while(0)
+#endif // SET_16_IN_ARRAY_LE
+
+#ifndef GET_16_IN_ARRAY_LE
+
+/**
+ * @brief Retrieves the 16 bits of data at @ref byte_offset in the @ref data memory as little endian.
+ * 
+ * @details
+ * Be aware that this macro doesn't do any bounds checking on the array given
+ * to it. It is the users responsibility to ensure that data is written inside
+ * the allocated memory for the data.
+ * 
+ * The bytes in @ref data are in little endian order, see the variant without
+ * _LE for big endian data.
+ * 
+ * The default implementation accesses the bytes one by one, which optimizing
+ * compilers merge into a single (unaligned) access where the architecture
+ * allows it. A platform can also map it to that directly.
+ * 
+ * Whilst data and byte_offset are only evaluated once in the default
+ * implementation, this is not guaranteed for other platform implementations.
+ * 
+ * @param data The memory to retrieve the data from.
+ * @param byte_offset The bytes in 8-bit words from the starting point of @ref data.
+ * 
+ * @return uint16_t The 16-bit value at the given location.
+ */
+#define GET_16_IN_ARRAY_LE(data, byte_offset) ((uint16_t)( \
+        ((uint16_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 0))) << 0) | \
+        ((uint16_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 1))) << 8) \
+    ))
+#endif // GET_16_IN_ARRAY_LE
+
+#ifndef SET_32_IN_ARRAY_LE
+
+/**
+ * @brief Sets the given 32 bits of data at @ref byte_offset in the @ref data memory as little endian.
+ * 
+ * @details
+ * Be aware that this macro doesn't do any bounds checking on the array given
+ * to it. It is the users responsibility to ensure that data is written inside
+ * the allocated memory for the data.
+ * 
+ * The bytes in @ref data are in little endian order, see the variant without
+ * _LE for big endian data.
+ * 
+ * The default implementation accesses the bytes one by one, which optimizing
+ * compilers merge into a single (unaligned) access where the architecture
+ * allows it. A platform can also map it to that directly.
+ * 
+ * Whilst data, value and byte_offset are only evaluated once in the default
+ * implementation, this is not guaranteed for other platform implementations.
+ * 
+ * @param data The memory to place the data in.
+ * @param value The 32 bits of data to place in the memory.
+ * @param byte_offset The bytes in 8-bit words from the starting point of @ref data.
+ * 
+ */
+#define SET_32_IN_ARRAY_LE(data, value, byte_offset) do { \
+        uint32_t __val = (value); \
+        uint8_t *__data = ((uint8_t*)(data) + (size_t)(byte_offset)); \
+        *(__data + 0) = (uint8_t)((__val >>  0) & 0xFF); \
+        *(__data + 1) = (uint8_t)((__val >>  8) & 0xFF); \
+        *(__data + 2) = (uint8_t)((__val >> 16) & 0xFF); \
+        *(__data + 3) = (uint8_t)((__val >> 24) & 0xFF); \
+    } while(0)
+#endif // SET_32_IN_ARRAY_LE
+
+#ifndef GET_32_IN_ARRAY_LE
+
+/**
+ * @brief Retrieves the 32 bits of data at @ref byte_offset in the @ref data memory as little endian.
+ * 
+ * @details
+ * Be aware that this macro doesn't do any bounds checking on the array given
+ * to it. It is the users responsibility to ensure that data is written inside
+ * the allocated memory for the data.
+ * 
+ * The bytes in @ref data are in little endian order, see the variant without
+ * _LE for big endian data.
+ * 
+ * The default implementation accesses the bytes one by one, which optimizing
+ * compilers merge into a single (unaligned) access where the architecture
+ * allows it. A platform can also map it to that directly.
+ * 
+ * Whilst data and byte_offset are only evaluated once in the default
+ * implementation, this is not guaranteed for other platform implementations.
+ * 
+ * @param data The memory to retrieve the data from.
+ * @param byte_offset The bytes in 8-bit words from the starting point of @ref data.
+ * 
+ * @return uint32_t The 32-bit value at the given location.
+ */
+#define GET_32_IN_ARRAY_LE(data, byte_offset) ((uint32_t)( \
+        ((uint32_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 0))) << 0) | \
+        ((uint32_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 1))) << 8) | \
+        ((uint32_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 2))) << 16) | \
+        ((uint32_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 3))) << 24) \
+    ))
+#endif // GET_32_IN_ARRAY_LE
+
+#ifndef SET_64_IN_ARRAY_LE
+
+/**
+ * @brief Sets the given 64 bits of data at @ref byte_offset in the @ref data memory as little endian.
+ * 
+ * @details
+ * Be aware that this macro doesn't do any bounds checking on the array given
+ * to it. It is the users responsibility to ensure that data is written inside
+ * the allocated memory for the data.
+ * 
+ * The bytes in @ref data are in little endian order, see the variant without
+ * _LE for big endian data.
+ * 
+ * The default implementation accesses the bytes one by one, which optimizing
+ * compilers merge into a single (unaligned) access where the architecture
+ * allows it. A platform can also map it to that directly.
+ * 
+ * Whilst data, value and byte_offset are only evaluated once in the default
+ * implementation, this is not guaranteed for other platform implementations.
+ * 
+ * @param data The memory to place the data in.
+ * @param value The 64 bits of data to place in the memory.
+ * @param byte_offset The bytes in 8-bit words from the starting point of @ref data.
+ * 
+ */
+#define SET_64_IN_ARRAY_LE(data, value, byte_offset) do { \
+        uint64_t __val = (value); \
+        uint8_t *__data = ((uint8_t*)(data) + (size_t)(byte_offset)); \
+        *(__data + 0) = (uint8_t)((__val >>  0) & 0xFF); \
+        *(__data + 1) = (uint8_t)((__val >>  8) & 0xFF); \
+        *(__data + 2) = (uint8_t)((__val >> 16) & 0xFF); \
+        *(__data + 3) = (uint8_t)((__val >> 24) & 0xFF); \
+        *(__data + 4) = (uint8_t)((__val >> 32) & 0xFF); \
+        *(__data + 5) = (uint8_t)((__val >> 40) & 0xFF); \
+        *(__data + 6) = (uint8_t)((__val >> 48) & 0xFF); \
+        *(__data + 7) = (uint8_t)((__val >> 56) & 0xFF); \
+    } while(0)
+#endif // SET_64_IN_ARRAY_LE
+
+#ifndef GET_64_IN_ARRAY_LE
+
+/**
+ * @brief Retrieves the 64 bits of data at @ref byte_offset in the @ref data memory as little endian.
+ * 
+ * @details
+ * Be aware that this macro doesn't do any bounds checking on the array given
+ * to it. It is the users responsibility to ensure that data is written inside
+ * the allocated memory for the data.
+ * 
+ * The bytes in @ref data are in little endian order, see the variant without
+ * _LE for big endian data.
+ * 
+ * The default implementation accesses the bytes one by one, which optimizing
+ * compilers merge into a single (unaligned) access where the architecture
+ * allows it. A platform can also map it to that directly.
+ * 
+ * Whilst data and byte_offset are only evaluated once in the default
+ * implementation, this is not guaranteed for other platform implementations.
+ * 
+ * @param data The memory to retrieve the data from.
+ * @param byte_offset The bytes in 8-bit words from the starting point of @ref data.
+ * 
+ * @return uint64_t The 64-bit value at the given location.
+ */
+#define GET_64_IN_ARRAY_LE(data, byte_offset) ((uint64_t)( \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 0))) << 0) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 1))) << 8) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 2))) << 16) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 3))) << 24) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 4))) << 32) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 5))) << 40) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 6))) << 48) | \
+        ((uint64_t)(*(((const uint8_t*)(data)) + (size_t)((byte_offset) + 7))) << 56) \
+    ))
+#endif // GET_64_IN_ARRAY_LE
+
 #ifndef REVERSE_BYTES_IN_ARRAY_16BIT
 
 /**
@@ -439,4 +856,485 @@
                                                         } while(0)
 #endif // REVERSE_BYTES_IN_ARRAY_32BIT
 
+#ifndef LIBOS_BITS_NATIVE_LITTLE_ENDIAN
+
+/**
+ * @brief 1 if the native byte order is known to be little-endian, 0 otherwise.
+ */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define LIBOS_BITS_NATIVE_LITTLE_ENDIAN 1
+#else
+#define LIBOS_BITS_NATIVE_LITTLE_ENDIAN 0
+#endif
+#endif // LIBOS_BITS_NATIVE_LITTLE_ENDIAN
+
+#ifndef LIBOS_BITS_NATIVE_BIG_ENDIAN
+
+/**
+ * @brief 1 if the native byte order is known to be big-endian, 0 otherwise.
+ */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define LIBOS_BITS_NATIVE_BIG_ENDIAN 1
+#else
+#define LIBOS_BITS_NATIVE_BIG_ENDIAN 0
+#endif
+#endif // LIBOS_BITS_NATIVE_BIG_ENDIAN
+
+#ifndef LIBOS_BSWAP16
+
+/**
+ * @brief Reverses the order of the bytes of a 16 bit value.
+ * 
+ * @param value The value to reverse the bytes of.
+ * 
+ * @return uint16_t The reversed value.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_BSWAP16(value) ((uint16_t)__builtin_bswap16((uint16_t)(value)))
+#else
+#define LIBOS_BSWAP16(value) ((uint16_t)((((uint16_t)(value) & 0xFF) << 8) | (((uint16_t)(value) >> 8) & 0xFF)))
+#endif
+#endif // LIBOS_BSWAP16
+
+#ifndef LIBOS_BSWAP32
+
+/**
+ * @brief Reverses the order of the bytes of a 32 bit value.
+ * 
+ * @param value The value to reverse the bytes of.
+ * 
+ * @return uint32_t The reversed value.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_BSWAP32(value) ((uint32_t)__builtin_bswap32((uint32_t)(value)))
+#else
+#define LIBOS_BSWAP32(value) ((uint32_t)(                             \
+                                (((uint32_t)(value) & 0x000000FFUL) << 24) | \
+                                (((uint32_t)(value) & 0x0000FF00UL) <<  8) | \
+                                (((uint32_t)(value) & 0x00FF0000UL) >>  8) | \
+                                (((uint32_t)(value) & 0xFF000000UL) >> 24)   \
+                              ))
+#endif
+#endif // LIBOS_BSWAP32
+
+#ifndef LIBOS_BSWAP64
+
+/**
+ * @brief Reverses the order of the bytes of a 64 bit value.
+ * 
+ * @param value The value to reverse the bytes of.
+ * 
+ * @return uint64_t The reversed value.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_BSWAP64(value) ((uint64_t)__builtin_bswap64((uint64_t)(value)))
+#else
+#define LIBOS_BSWAP64(value) ((uint64_t)(((uint64_t)LIBOS_BSWAP32((uint64_t)(value) & 0xFFFFFFFFUL) << 32) | LIBOS_BSWAP32((uint64_t)(value) >> 32)))
+#endif
+#endif // LIBOS_BSWAP64
+
+#ifndef LIBOS_POPCOUNT32_CONST
+
+/**
+ * @brief Counts the bits that are set in a 32 bit value, as a constant expression.
+ * 
+ * @details
+ * Meant for static initialisation, @ref value is evaluated multiple times.
+ * Use LIBOS_POPCOUNT32 for values that are computed at run-time.
+ * 
+ * @param value The value to count the set bits of.
+ * 
+ */
+#define LIBOS_POPCOUNT32_CONST(value) ((int)((uint32_t)((LIBOS_POPCOUNT32_NIBBLES_(value) & 0x0F0F0F0FUL) * 0x01010101UL) >> 24))
+// Sum of the bits per nibble, then per byte (in the low nibble of every byte).
+#define LIBOS_POPCOUNT32_PAIRS_(value) ((uint32_t)(value) - (((uint32_t)(value) >> 1) & 0x55555555UL))
+#define LIBOS_POPCOUNT32_QUADS_(value) ((LIBOS_POPCOUNT32_PAIRS_(value) & 0x33333333UL) + ((LIBOS_POPCOUNT32_PAIRS_(value) >> 2) & 0x33333333UL))
+#define LIBOS_POPCOUNT32_NIBBLES_(value) (LIBOS_POPCOUNT32_QUADS_(value) + (LIBOS_POPCOUNT32_QUADS_(value) >> 4))
+#endif // LIBOS_POPCOUNT32_CONST
+
+#ifndef LIBOS_BIT_LENGTH32_CONST
+
+/**
+ * @brief The number of bits needed to represent a 32 bit value (0 for 0), as a constant expression.
+ * 
+ * @details
+ * Meant for static initialisation, @ref value is evaluated multiple times.
+ * 
+ * @param value The value to get the bit length of.
+ * 
+ */
+#define LIBOS_BIT_LENGTH32_CONST(value) ((int)( \
+                                   ((uint32_t)(value) >= 0x00000001UL) + \
+                                   ((uint32_t)(value) >= 0x00000002UL) + \
+                                   ((uint32_t)(value) >= 0x00000004UL) + \
+                                   ((uint32_t)(value) >= 0x00000008UL) + \
+                                   ((uint32_t)(value) >= 0x00000010UL) + \
+                                   ((uint32_t)(value) >= 0x00000020UL) + \
+                                   ((uint32_t)(value) >= 0x00000040UL) + \
+                                   ((uint32_t)(value) >= 0x00000080UL) + \
+                                   ((uint32_t)(value) >= 0x00000100UL) + \
+                                   ((uint32_t)(value) >= 0x00000200UL) + \
+                                   ((uint32_t)(value) >= 0x00000400UL) + \
+                                   ((uint32_t)(value) >= 0x00000800UL) + \
+                                   ((uint32_t)(value) >= 0x00001000UL) + \
+                                   ((uint32_t)(value) >= 0x00002000UL) + \
+                                   ((uint32_t)(value) >= 0x00004000UL) + \
+                                   ((uint32_t)(value) >= 0x00008000UL) + \
+                                   ((uint32_t)(value) >= 0x00010000UL) + \
+                                   ((uint32_t)(value) >= 0x00020000UL) + \
+                                   ((uint32_t)(value) >= 0x00040000UL) + \
+                                   ((uint32_t)(value) >= 0x00080000UL) + \
+                                   ((uint32_t)(value) >= 0x00100000UL) + \
+                                   ((uint32_t)(value) >= 0x00200000UL) + \
+                                   ((uint32_t)(value) >= 0x00400000UL) + \
+                                   ((uint32_t)(value) >= 0x00800000UL) + \
+                                   ((uint32_t)(value) >= 0x01000000UL) + \
+                                   ((uint32_t)(value) >= 0x02000000UL) + \
+                                   ((uint32_t)(value) >= 0x04000000UL) + \
+                                   ((uint32_t)(value) >= 0x08000000UL) + \
+                                   ((uint32_t)(value) >= 0x10000000UL) + \
+                                   ((uint32_t)(value) >= 0x20000000UL) + \
+                                   ((uint32_t)(value) >= 0x40000000UL) + \
+                                   ((uint32_t)(value) >= 0x80000000UL) \
+                                 ))
+#endif // LIBOS_BIT_LENGTH32_CONST
+
+#ifndef LIBOS_CLZ32_CONST
+
+/**
+ * @brief Counts the leading zero bits of a 32 bit value, as a constant expression.
+ * 
+ * @details
+ * Meant for static initialisation, @ref value is evaluated multiple times.
+ * Unlike LIBOS_CLZ32, the result for 0 is defined (32).
+ * 
+ * @param value The value to count the leading zeros of.
+ * 
+ */
+#define LIBOS_CLZ32_CONST(value) (32 - LIBOS_BIT_LENGTH32_CONST(value))
+#endif // LIBOS_CLZ32_CONST
+
+#ifndef LIBOS_CTZ32_CONST
+
+/**
+ * @brief Counts the trailing zero bits of a 32 bit value, as a constant expression.
+ * 
+ * @details
+ * Meant for static initialisation, @ref value is evaluated multiple times.
+ * Unlike LIBOS_CTZ32, the result for 0 is defined (32).
+ * 
+ * @param value The value to count the trailing zeros of.
+ * 
+ */
+#define LIBOS_CTZ32_CONST(value) LIBOS_POPCOUNT32_CONST(~(uint32_t)(value) & ((uint32_t)(value) - 1))
+#endif // LIBOS_CTZ32_CONST
+
+#ifndef LIBOS_POPCOUNT64_CONST
+
+/**
+ * @brief Counts the bits that are set in a 64 bit value, as a constant expression.
+ * 
+ * @param value The value to count the set bits of (evaluated multiple times).
+ * 
+ */
+#define LIBOS_POPCOUNT64_CONST(value) (LIBOS_POPCOUNT32_CONST((uint32_t)((uint64_t)(value) >> 32)) + LIBOS_POPCOUNT32_CONST((uint32_t)(value)))
+#endif // LIBOS_POPCOUNT64_CONST
+
+#ifndef LIBOS_CLZ64_CONST
+
+/**
+ * @brief Counts the leading zero bits of a 64 bit value, as a constant expression (64 for 0).
+ * 
+ * @param value The value to count the leading zeros of (evaluated multiple times).
+ * 
+ */
+#define LIBOS_CLZ64_CONST(value) (((uint64_t)(value) >> 32) != 0 ? LIBOS_CLZ32_CONST((uint32_t)((uint64_t)(value) >> 32)) : 32 + LIBOS_CLZ32_CONST((uint32_t)(value)))
+#endif // LIBOS_CLZ64_CONST
+
+#ifndef LIBOS_CTZ64_CONST
+
+/**
+ * @brief Counts the trailing zero bits of a 64 bit value, as a constant expression (64 for 0).
+ * 
+ * @param value The value to count the trailing zeros of (evaluated multiple times).
+ * 
+ */
+#define LIBOS_CTZ64_CONST(value) ((uint32_t)(value) != 0 ? LIBOS_CTZ32_CONST((uint32_t)(value)) : 32 + LIBOS_CTZ32_CONST((uint32_t)((uint64_t)(value) >> 32)))
+#endif // LIBOS_CTZ64_CONST
+
+#ifndef LIBOS_CLZ32
+
+/**
+ * @brief Counts the leading zero bits of a 32 bit value.
+ * 
+ * @details
+ * The result for 0 is undefined, such that it maps to a single instruction on
+ * most architectures. The default implementation uses the compiler builtins
+ * when available, and LIBOS_CLZ32_CONST otherwise.
+ * 
+ * @param value The value to count the leading zeros of, must not be 0.
+ * 
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_CLZ32(value) (__builtin_clzl((unsigned long)(uint32_t)(value)) - (int)(sizeof(unsigned long) * 8 - 32))
+#else
+#define LIBOS_CLZ32(value) LIBOS_CLZ32_CONST(value)
+#endif
+#endif // LIBOS_CLZ32
+
+#ifndef LIBOS_CTZ32
+
+/**
+ * @brief Counts the trailing zero bits of a 32 bit value.
+ * 
+ * @param value The value to count the trailing zeros of, must not be 0 (see LIBOS_CLZ32).
+ * 
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_CTZ32(value) __builtin_ctzl((unsigned long)(uint32_t)(value))
+#else
+#define LIBOS_CTZ32(value) LIBOS_CTZ32_CONST(value)
+#endif
+#endif // LIBOS_CTZ32
+
+#ifndef LIBOS_POPCOUNT32
+
+/**
+ * @brief Counts the bits that are set in a 32 bit value.
+ * 
+ * @param value The value to count the set bits of.
+ * 
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_POPCOUNT32(value) __builtin_popcountl((unsigned long)(uint32_t)(value))
+#else
+#define LIBOS_POPCOUNT32(value) LIBOS_POPCOUNT32_CONST(value)
+#endif
+#endif // LIBOS_POPCOUNT32
+
+#ifndef LIBOS_CLZ64
+
+/**
+ * @brief Counts the leading zero bits of a 64 bit value.
+ * 
+ * @param value The value to count the leading zeros of, must not be 0 (see LIBOS_CLZ32).
+ * 
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_CLZ64(value) __builtin_clzll((unsigned long long)(uint64_t)(value))
+#else
+#define LIBOS_CLZ64(value) LIBOS_CLZ64_CONST(value)
+#endif
+#endif // LIBOS_CLZ64
+
+#ifndef LIBOS_CTZ64
+
+/**
+ * @brief Counts the trailing zero bits of a 64 bit value.
+ * 
+ * @param value The value to count the trailing zeros of, must not be 0 (see LIBOS_CLZ32).
+ * 
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_CTZ64(value) __builtin_ctzll((unsigned long long)(uint64_t)(value))
+#else
+#define LIBOS_CTZ64(value) LIBOS_CTZ64_CONST(value)
+#endif
+#endif // LIBOS_CTZ64
+
+#ifndef LIBOS_POPCOUNT64
+
+/**
+ * @brief Counts the bits that are set in a 64 bit value.
+ * 
+ * @param value The value to count the set bits of.
+ * 
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_POPCOUNT64(value) __builtin_popcountll((unsigned long long)(uint64_t)(value))
+#else
+#define LIBOS_POPCOUNT64(value) LIBOS_POPCOUNT64_CONST(value)
+#endif
+#endif // LIBOS_POPCOUNT64
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef libos_bswap16_array
+
+/**
+ * @brief Reverses the bytes of every 16 bit element of the array.
+ * 
+ * @details
+ * The arrays don't have to be aligned. @ref dst may be the same as @ref src
+ * to convert in place, other overlap is not allowed.
+ * 
+ * @param[out] dst The memory for the converted elements.
+ * @param[in] src The elements to convert.
+ * @param[in] count The number of elements.
+ */
+static inline void libos_bswap16_array(void *dst, const void *src, size_t count)
+{
+    uint8_t *out = (uint8_t*)dst;
+    const uint8_t *in = (const uint8_t*)src;
+    size_t i = 0;
+
+    // Two elements per 32 bit word, swapping the bytes of both halves is independent of the native byte order.
+    for (; i + 2 <= count; i += 2)
+    {
+        uint32_t word;
+        memcpy(&word, &in[i * 2], sizeof(word));
+        word = ((word & 0x00FF00FFUL) << 8) | ((word >> 8) & 0x00FF00FFUL);
+        memcpy(&out[i * 2], &word, sizeof(word));
+    }
+    for (; i < count; i++)
+    {
+        uint16_t element;
+        memcpy(&element, &in[i * 2], sizeof(element));
+        element = LIBOS_BSWAP16(element);
+        memcpy(&out[i * 2], &element, sizeof(element));
+    }
+}
+#endif // libos_bswap16_array
+
+#ifndef libos_bswap32_array
+
+/**
+ * @brief Reverses the bytes of every 32 bit element of the array.
+ * 
+ * @details
+ * The arrays don't have to be aligned. @ref dst may be the same as @ref src
+ * to convert in place, other overlap is not allowed.
+ * 
+ * @param[out] dst The memory for the converted elements.
+ * @param[in] src The elements to convert.
+ * @param[in] count The number of elements.
+ */
+static inline void libos_bswap32_array(void *dst, const void *src, size_t count)
+{
+    uint8_t *out = (uint8_t*)dst;
+    const uint8_t *in = (const uint8_t*)src;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t element;
+        memcpy(&element, &in[i * 4], sizeof(element));
+        element = LIBOS_BSWAP32(element);
+        memcpy(&out[i * 4], &element, sizeof(element));
+    }
+}
+#endif // libos_bswap32_array
+
+#ifndef libos_load_be16_array
+
+/**
+ * @brief Reads a array of big-endian 16 bit values into native values.
+ * 
+ * @details
+ * @ref src doesn't have to be aligned, it may be the same memory as @ref dst.
+ * 
+ * @param[out] dst The native values.
+ * @param[in] src The big-endian data.
+ * @param[in] count The number of values.
+ */
+static inline void libos_load_be16_array(uint16_t *dst, const void *src, size_t count)
+{
+#if LIBOS_BITS_NATIVE_LITTLE_ENDIAN==1
+    libos_bswap16_array(dst, src, count);
+#elif LIBOS_BITS_NATIVE_BIG_ENDIAN==1
+    memmove(dst, src, count * sizeof(uint16_t));
+#else
+    for (size_t i = 0; i < count; i++)
+    {
+        dst[i] = GET_16_IN_ARRAY(src, i * 2);
+    }
+#endif
+}
+#endif // libos_load_be16_array
+
+#ifndef libos_load_be32_array
+
+/**
+ * @brief Reads a array of big-endian 32 bit values into native values.
+ * 
+ * @details
+ * @ref src doesn't have to be aligned, it may be the same memory as @ref dst.
+ * 
+ * @param[out] dst The native values.
+ * @param[in] src The big-endian data.
+ * @param[in] count The number of values.
+ */
+static inline void libos_load_be32_array(uint32_t *dst, const void *src, size_t count)
+{
+#if LIBOS_BITS_NATIVE_LITTLE_ENDIAN==1
+    libos_bswap32_array(dst, src, count);
+#elif LIBOS_BITS_NATIVE_BIG_ENDIAN==1
+    memmove(dst, src, count * sizeof(uint32_t));
+#else
+    for (size_t i = 0; i < count; i++)
+    {
+        dst[i] = GET_32_IN_ARRAY(src, i * 4);
+    }
+#endif
+}
+#endif // libos_load_be32_array
+
+#ifndef libos_store_be16_array
+
+/**
+ * @brief Writes a array of native 16 bit values as big-endian data.
+ * 
+ * @details
+ * @ref dst doesn't have to be aligned, it may be the same memory as @ref src.
+ * 
+ * @param[out] dst The memory for the big-endian data.
+ * @param[in] src The native values.
+ * @param[in] count The number of values.
+ */
+static inline void libos_store_be16_array(void *dst, const uint16_t *src, size_t count)
+{
+#if LIBOS_BITS_NATIVE_LITTLE_ENDIAN==1
+    libos_bswap16_array(dst, src, count);
+#elif LIBOS_BITS_NATIVE_BIG_ENDIAN==1
+    memmove(dst, src, count * sizeof(uint16_t));
+#else
+    for (size_t i = 0; i < count; i++)
+    {
+        SET_16_IN_ARRAY(dst, src[i], i * 2);
+    }
+#endif
+}
+#endif // libos_store_be16_array
+
+#ifndef libos_store_be32_array
+
+/**
+ * @brief Writes a array of native 32 bit values as big-endian data.
+ * 
+ * @details
+ * @ref dst doesn't have to be aligned, it may be the same memory as @ref src.
+ * 
+ * @param[out] dst The memory for the big-endian data.
+ * @param[in] src The native values.
+ * @param[in] count The number of values.
+ */
+static inline void libos_store_be32_array(void *dst, const uint32_t *src, size_t count)
+{
+#if LIBOS_BITS_NATIVE_LITTLE_ENDIAN==1
+    libos_bswap32_array(dst, src, count);
+#elif LIBOS_BITS_NATIVE_BIG_ENDIAN==1
+    memmove(dst, src, count * sizeof(uint32_t));
+#else
+    for (size_t i = 0; i < count; i++)
+    {
+        SET_32_IN_ARRAY(dst, src[i], i * 4);
+    }
+#endif
+}
+#endif // libos_store_be32_array
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
 #endif // LIBOS_BITS_H
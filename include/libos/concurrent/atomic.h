@@ -0,0 +1,289 @@
+/**
+ * @file atomic.h
+ * @brief Abstract API for atomic operations.
+ * 
+ * @details
+ * This header provides atomic types and operations, such that lock-free
+ * counters, flags and data structures can be written once for all platforms
+ * instead of taking a mutex or using compiler builtins per platform.
+ * 
+ * The following atomic types are provided:
+ * * libos_atomic_uint8_t
+ * * libos_atomic_uint16_t
+ * * libos_atomic_uint32_t
+ * * libos_atomic_uint64_t
+ * * libos_atomic_size_t
+ * * libos_atomic_ptr_t (a atomic void pointer)
+ * 
+ * The operations are function-like macros that work on all of the types
+ * above, and all of them take the memory order explicitly:
+ * * LIBOS_ATOMIC_RELAXED, only the atomicity is guaranteed.
+ * * LIBOS_ATOMIC_ACQUIRE, for loads that 'take' data published by a release.
+ * * LIBOS_ATOMIC_RELEASE, for stores that 'publish' data.
+ * * LIBOS_ATOMIC_ACQ_REL, both of the above, for read-modify-write operations.
+ * * LIBOS_ATOMIC_SEQ_CST, a single total order over all the seq_cst operations.
+ * 
+ * The semantics are the same as the C11 atomics (and the default
+ * implementation is the C11 stdatomic.h). Just like the C11 atomics, the 64-bit
+ * operations are not guaranteed to be lock-free on 32-bit targets, this can be
+ * checked with LIBOS_ATOMIC_64_IS_LOCK_FREE. A lock based 64-bit atomic can not
+ * be used from a interrupt service routine on most platforms.
+ * 
+ * Example:
+ * @code{.c}
+ * static libos_atomic_uint32_t ref_count;
+ * 
+ * void ref(void) {
+ *   LIBOS_ATOMIC_FETCH_ADD(&ref_count, 1, LIBOS_ATOMIC_RELAXED);
+ * }
+ * 
+ * bool unref(void) {
+ *   return LIBOS_ATOMIC_FETCH_SUB(&ref_count, 1, LIBOS_ATOMIC_ACQ_REL) == 1;
+ * }
+ * @endcode
+ * 
+ * 
+ * IMPLEMENTORS:
+ * For the implementor it is required to provide a
+ * libos/platform/concurrent/atomic.h header. This header can be empty, in
+ * which case the C11 atomics are used (or the C++11 std::atomic when compiled
+ * as C++).
+ * When the platform has better native primitives, it can override any of the
+ * macros in this header. If the types are overridden as well, the header must
+ * define LIBOS_ATOMIC_PLATFORM_TYPES and typedef all of the types listed above.
+ * It is the responsibility of the platform that all overrides are consistent
+ * with each other, and with the semantics of the C11 atomics.
+ * It should be noted that it is NOT allowed to implement the operations with a
+ * mutex, they have to be usable where a mutex can not be used.
+ */
+
+#pragma once
+#ifndef LIBOS_CONCURRENT_ATOMIC_H
+#define LIBOS_CONCURRENT_ATOMIC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "libos/platform/concurrent/atomic.h"
+
+#ifdef __cplusplus
+#include <atomic>
+#define LIBOS_ATOMIC_TYPE_(type) std::atomic<type>
+#define LIBOS_ATOMIC_STD_(name) std::name
+#else // __cplusplus
+#include <stdatomic.h>
+#define LIBOS_ATOMIC_TYPE_(type) _Atomic(type)
+#define LIBOS_ATOMIC_STD_(name) name
+#endif // __cplusplus
+
+#ifndef LIBOS_ATOMIC_PLATFORM_TYPES
+typedef LIBOS_ATOMIC_TYPE_(uint8_t) libos_atomic_uint8_t;
+typedef LIBOS_ATOMIC_TYPE_(uint16_t) libos_atomic_uint16_t;
+typedef LIBOS_ATOMIC_TYPE_(uint32_t) libos_atomic_uint32_t;
+typedef LIBOS_ATOMIC_TYPE_(uint64_t) libos_atomic_uint64_t;
+typedef LIBOS_ATOMIC_TYPE_(size_t) libos_atomic_size_t;
+typedef LIBOS_ATOMIC_TYPE_(void*) libos_atomic_ptr_t;
+#endif // LIBOS_ATOMIC_PLATFORM_TYPES
+
+// ================================================
+//
+// Memory orders
+//
+// ================================================
+
+#ifndef LIBOS_ATOMIC_RELAXED
+#define LIBOS_ATOMIC_RELAXED LIBOS_ATOMIC_STD_(memory_order_relaxed)
+#endif // LIBOS_ATOMIC_RELAXED
+
+#ifndef LIBOS_ATOMIC_ACQUIRE
+#define LIBOS_ATOMIC_ACQUIRE LIBOS_ATOMIC_STD_(memory_order_acquire)
+#endif // LIBOS_ATOMIC_ACQUIRE
+
+#ifndef LIBOS_ATOMIC_RELEASE
+#define LIBOS_ATOMIC_RELEASE LIBOS_ATOMIC_STD_(memory_order_release)
+#endif // LIBOS_ATOMIC_RELEASE
+
+#ifndef LIBOS_ATOMIC_ACQ_REL
+#define LIBOS_ATOMIC_ACQ_REL LIBOS_ATOMIC_STD_(memory_order_acq_rel)
+#endif // LIBOS_ATOMIC_ACQ_REL
+
+#ifndef LIBOS_ATOMIC_SEQ_CST
+#define LIBOS_ATOMIC_SEQ_CST LIBOS_ATOMIC_STD_(memory_order_seq_cst)
+#endif // LIBOS_ATOMIC_SEQ_CST
+
+#ifndef LIBOS_ATOMIC_64_IS_LOCK_FREE
+
+/**
+ * @brief Evaluates to true if the 64-bit atomics are always lock-free on this platform.
+ */
+#define LIBOS_ATOMIC_64_IS_LOCK_FREE (ATOMIC_LLONG_LOCK_FREE == 2)
+#endif // LIBOS_ATOMIC_64_IS_LOCK_FREE
+
+// ================================================
+//
+// Operations
+//
+// ================================================
+
+#ifndef LIBOS_ATOMIC_INIT
+
+/**
+ * @brief Initializes the atomic object with @ref value, this is NOT a atomic operation.
+ * 
+ * @details
+ * Should be used once before any other thread can access the object. Objects
+ * with a static storage duration are zero initialized and don't need this.
+ * 
+ * @param obj Pointer to the atomic object.
+ * @param value The initial value.
+ */
+#define LIBOS_ATOMIC_INIT(obj, value) LIBOS_ATOMIC_STD_(atomic_init)((obj), (value))
+#endif // LIBOS_ATOMIC_INIT
+
+#ifndef LIBOS_ATOMIC_LOAD
+
+/**
+ * @brief Atomically loads the value of the object.
+ * 
+ * @param obj Pointer to the atomic object.
+ * @param order The memory order (RELAXED, ACQUIRE or SEQ_CST).
+ * 
+ * @return The value of the object.
+ */
+#define LIBOS_ATOMIC_LOAD(obj, order) LIBOS_ATOMIC_STD_(atomic_load_explicit)((obj), (order))
+#endif // LIBOS_ATOMIC_LOAD
+
+#ifndef LIBOS_ATOMIC_STORE
+
+/**
+ * @brief Atomically stores the value in the object.
+ * 
+ * @param obj Pointer to the atomic object.
+ * @param value The value to store.
+ * @param order The memory order (RELAXED, RELEASE or SEQ_CST).
+ */
+#define LIBOS_ATOMIC_STORE(obj, value, order) LIBOS_ATOMIC_STD_(atomic_store_explicit)((obj), (value), (order))
+#endif // LIBOS_ATOMIC_STORE
+
+#ifndef LIBOS_ATOMIC_EXCHANGE
+
+/**
+ * @brief Atomically replaces the value of the object and returns the previous value.
+ * 
+ * @param obj Pointer to the atomic object.
+ * @param value The new value.
+ * @param order The memory order.
+ * 
+ * @return The value before the exchange.
+ */
+#define LIBOS_ATOMIC_EXCHANGE(obj, value, order) LIBOS_ATOMIC_STD_(atomic_exchange_explicit)((obj), (value), (order))
+#endif // LIBOS_ATOMIC_EXCHANGE
+
+#ifndef LIBOS_ATOMIC_COMPARE_EXCHANGE
+
+/**
+ * @brief Replaces the value with @ref desired if it is equal to the value pointed by @ref expected.
+ * 
+ * @details
+ * If the value is not equal, the current value is written in @ref expected.
+ * This never fails spuriously.
+ * 
+ * @param obj Pointer to the atomic object.
+ * @param expected Pointer to the (non atomic) value that is expected.
+ * @param desired The value to store if the object has the expected value.
+ * @param success The memory order if the exchange happened.
+ * @param failure The memory order if the exchange didn't happen (not RELEASE or ACQ_REL, and not stronger than success).
+ * 
+ * @return true if the exchange happened, false otherwise.
+ */
+#define LIBOS_ATOMIC_COMPARE_EXCHANGE(obj, expected, desired, success, failure) LIBOS_ATOMIC_STD_(atomic_compare_exchange_strong_explicit)((obj), (expected), (desired), (success), (failure))
+#endif // LIBOS_ATOMIC_COMPARE_EXCHANGE
+
+#ifndef LIBOS_ATOMIC_COMPARE_EXCHANGE_WEAK
+
+/**
+ * @brief Like LIBOS_ATOMIC_COMPARE_EXCHANGE but is allowed to fail spuriously.
+ * 
+ * @details
+ * This can be more efficient on LL/SC architectures (ARM, RISC-V) when used in
+ * a retry loop.
+ * 
+ * @param obj Pointer to the atomic object.
+ * @param expected Pointer to the (non atomic) value that is expected.
+ * @param desired The value to store if the object has the expected value.
+ * @param success The memory order if the exchange happened.
+ * @param failure The memory order if the exchange didn't happen.
+ * 
+ * @return true if the exchange happened, false otherwise.
+ */
+#define LIBOS_ATOMIC_COMPARE_EXCHANGE_WEAK(obj, expected, desired, success, failure) LIBOS_ATOMIC_STD_(atomic_compare_exchange_weak_explicit)((obj), (expected), (desired), (success), (failure))
+#endif // LIBOS_ATOMIC_COMPARE_EXCHANGE_WEAK
+
+#ifndef LIBOS_ATOMIC_FETCH_ADD
+
+/**
+ * @brief Atomically adds @ref value to the object and returns the previous value.
+ * 
+ * @param obj Pointer to the atomic object (integer types only).
+ * @param value The value to add.
+ * @param order The memory order.
+ * 
+ * @return The value before the addition.
+ */
+#define LIBOS_ATOMIC_FETCH_ADD(obj, value, order) LIBOS_ATOMIC_STD_(atomic_fetch_add_explicit)((obj), (value), (order))
+#endif // LIBOS_ATOMIC_FETCH_ADD
+
+#ifndef LIBOS_ATOMIC_FETCH_SUB
+
+/**
+ * @brief Atomically subtracts @ref value from the object and returns the previous value.
+ * 
+ * @param obj Pointer to the atomic object (integer types only).
+ * @param value The value to subtract.
+ * @param order The memory order.
+ * 
+ * @return The value before the subtraction.
+ */
+#define LIBOS_ATOMIC_FETCH_SUB(obj, value, order) LIBOS_ATOMIC_STD_(atomic_fetch_sub_explicit)((obj), (value), (order))
+#endif // LIBOS_ATOMIC_FETCH_SUB
+
+#ifndef LIBOS_ATOMIC_FETCH_OR
+
+/**
+ * @brief Atomically sets the bits of @ref mask in the object and returns the previous value.
+ * 
+ * @param obj Pointer to the atomic object (integer types only).
+ * @param mask The bits to set.
+ * @param order The memory order.
+ * 
+ * @return The value before the bits were set.
+ */
+#define LIBOS_ATOMIC_FETCH_OR(obj, mask, order) LIBOS_ATOMIC_STD_(atomic_fetch_or_explicit)((obj), (mask), (order))
+#endif // LIBOS_ATOMIC_FETCH_OR
+
+#ifndef LIBOS_ATOMIC_FETCH_AND
+
+/**
+ * @brief Atomically ands the object with @ref mask and returns the previous value.
+ * 
+ * @param obj Pointer to the atomic object (integer types only).
+ * @param mask The bits to keep.
+ * @param order The memory order.
+ * 
+ * @return The value before the bits were cleared.
+ */
+#define LIBOS_ATOMIC_FETCH_AND(obj, mask, order) LIBOS_ATOMIC_STD_(atomic_fetch_and_explicit)((obj), (mask), (order))
+#endif // LIBOS_ATOMIC_FETCH_AND
+
+#ifndef LIBOS_ATOMIC_THREAD_FENCE
+
+/**
+ * @brief A memory fence with the given order, without a associated atomic object.
+ * 
+ * @param order The memory order.
+ */
+#define LIBOS_ATOMIC_THREAD_FENCE(order) LIBOS_ATOMIC_STD_(atomic_thread_fence)((order))
+#endif // LIBOS_ATOMIC_THREAD_FENCE
+
+#endif // LIBOS_CONCURRENT_ATOMIC_H
@@ -0,0 +1,272 @@
+/**
+ * @file condvar.h
+ * @brief Abstract API for a condition variable object.
+ * 
+ * @details
+ * This header provides the API to a system native condition variable
+ * synchronisation primitive. A condition variable lets a task sleep until
+ * the state protected by a mutex changes, instead of polling that state in a
+ * loop of lock with timeout and recheck. Polling either burns CPU or adds
+ * latency equal to the poll interval, a wait on a condition variable costs
+ * nothing while idle and wakes up as soon as the state is signalled.
+ * 
+ * A condition variable is always used together with a mutex (see
+ * libos/concurrent/mutex.h). The waiter locks the mutex, checks the state and
+ * calls libos_condvar_wait while the state is not as required. The wait
+ * atomically unlocks the mutex and sleeps, and locks the mutex again before
+ * it returns. The task changing the state signals (one waiter) or broadcasts
+ * (all waiters) after changing the state, preferably while holding the mutex.
+ * Wakeups can be spurious, so the state always has to be rechecked in a loop:
+ * 
+ * @code{.c}
+ * libos_mutex_lock(mutex, timeout);
+ * while (!ready)
+ * {
+ *   if (libos_condvar_wait(condvar, mutex, timeout) == LIBOS_ERR_TIMEOUT)
+ *   {
+ *     break;
+ *   }
+ * }
+ * libos_mutex_unlock(mutex);
+ * @endcode
+ * 
+ * The API is shaped like the mutex API. If the platform supports it, static
+ * and dynamic allocations are supported. If only dynamic allocations are
+ * supported the system is allowed to wrap static allocations to dynamic
+ * allocations. This is with the requirement that libos_condvar_t typedef is
+ * still defined.
+ * 
+ * 
+ * IMPLEMENTORS:
+ * For the implementor it is required to provide a
+ * libos/platform/concurrent/condvar.h header. This header has to provide the
+ * following types:
+ * * libos_condvar_handle_t
+ * * libos_condvar_t (optional)
+ * 
+ * The libos_condvar_handle_t is a type that refers to a condition variable in
+ * the system. This is often a pointer but is not required to be one. The
+ * libos_condvar_t type is only required if the platform supports static
+ * allocations of condition variables.
+ * 
+ * The header implementation can provide the
+ * LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION and
+ * LIBOS_CONDVAR_ENABLE_DYNAMIC_ALLOCATION macros. They follow the same rules
+ * as the LIBOS_MUTEX_ENABLE_* variants. If the header doesn't define them, they
+ * will default to the value of the mutex variant. A implementation must at
+ * least provide 1 initialization method.
+ * 
+ * The wait has to work with every mutex created with one of the non
+ * recursive libos_mutex_create_* functions, including the adaptive ones. If
+ * the platform has no native condition variable, it can be built from a
+ * semaphore per waiter (or a counting semaphore and a waiter count) next to
+ * the mutex. The unlock of the mutex and the start of the wait must be atomic
+ * with respect to a signal, a signal given after the mutex is unlocked by the
+ * wait may not be lost.
+ * Waiting with a recursive mutex is not supported.
+ * 
+ * If the platform provides library functions they should be enclosed
+ * in a extern "C" block like:
+ * 
+ * @code
+ * #ifdef __cplusplus
+ * extern "C" {
+ * #endif // __cplusplus
+ * 
+ * // Functions
+ * 
+ * #ifdef __cplusplus
+ * }
+ * #endif // __cplusplus
+ * 
+ * @endcode
+ * 
+ * Or, if it does not have a block, each function should be marked as
+ * @code
+ * extern "C"
+ * @endcode
+ * . The general API header for the condition variable places all the
+ * functions in a extern "C" code block.
+ */
+
+#pragma once
+#ifndef LIBOS_CONCURRENT_CONDVAR_H
+#define LIBOS_CONCURRENT_CONDVAR_H
+
+#include "libos/error.h"
+#include "libos/time.h"
+#include "libos/concurrent/mutex.h"
+
+#include "libos/platform/concurrent/condvar.h"
+
+#ifndef LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION
+#define LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION
+#endif // LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION
+
+#ifndef LIBOS_CONDVAR_ENABLE_DYNAMIC_ALLOCATION
+#define LIBOS_CONDVAR_ENABLE_DYNAMIC_ALLOCATION LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION
+#endif // LIBOS_CONDVAR_ENABLE_DYNAMIC_ALLOCATION
+
+#if LIBOS_CONDVAR_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION!=1
+#error "The platform doesn't provide either a static or dynamic initialization method for condition variables."
+#endif // LIBOS_CONDVAR_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION!=1
+
+/**
+ * @def LIBOS_CONDVAR_STATIC_DATA_STRUCT(name)
+ * @brief Define a variable of libos_condvar_t with @ref name if static allocation is supported
+ * 
+ * @param[in] name The name of of the variable if defined.
+ */
+
+#if LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_CONDVAR_STATIC_DATA_STRUCT(name) libos_condvar_t name
+#else // LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION==1
+// Don't define struct
+#define LIBOS_CONDVAR_STATIC_DATA_STRUCT(static_data_name)
+#endif // LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @def LIBOS_CONDVAR_CREATE_PREFER_STATIC(static_data_name, handle)
+ * @brief Call libos_condvar_create_static if static allocation is supported, otherwise call libos_condvar_create_dynamic.
+ * 
+ * @details
+ * Conditional implementation for when static allocation is supported or not.
+ * The parameter are names for the variables, they are NOT pointers yet.
+ * 
+ * Example:
+ * @code{.c}
+ * LIBOS_CONDVAR_STATIC_DATA_STRUCT(static_condvar);
+ * libos_condvar_handle_t handle;
+ * 
+ * if (LIBOS_CONDVAR_CREATE_PREFER_STATIC(static_condvar, handle) != LIBOS_ERR_OK)
+ * {
+ *   // Do stuff
+ * }
+ * @endcode
+ * 
+ * 
+ * @param[in] static_data_name The name of of the variable for the static data struct.
+ * @param[in] handle The name of the variable to place the resulting handle in.
+ */
+#if LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_CONDVAR_CREATE_PREFER_STATIC(static_data_name, handle) libos_condvar_create_static(&(static_data_name),&(handle))
+#else // LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_CONDVAR_CREATE_PREFER_STATIC(static_data_name, handle) libos_condvar_create_dynamic(&(handle))
+#endif // LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION==1
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Unlocks the mutex and waits for a signal within the given time.
+ * 
+ * @details
+ * The calling task has to hold @ref mutex. The mutex is unlocked and the task
+ * starts waiting in one atomic step, and the mutex is locked again before
+ * the function returns, also on a timeout. The time to relock the mutex is
+ * not bounded by the timeout. The function can return LIBOS_ERR_OK without a
+ * signal (a spurious wakeup), so the caller has to recheck its condition.
+ * 
+ * On LIBOS_ERR_INVALID_ARG the mutex is not touched, on LIBOS_ERR_FAIL it is
+ * unspecified if the mutex is held.
+ * 
+ * @param[in] handle The condition variable to wait on.
+ * @param[in] mutex The mutex that protects the condition, locked by the caller.
+ * @param[in] timeout The time (in platform ticks) to wait for a signal.
+ * 
+ * @retval LIBOS_ERR_OK The task is woken up, the mutex is locked.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle or @ref mutex is NULL.
+ * @retval LIBOS_ERR_TIMEOUT No signal arrived before the end of the timeout, the mutex is locked.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for waiting on the condition variable.
+ */
+libos_err_t libos_condvar_wait(libos_condvar_handle_t handle, libos_mutex_handle_t mutex, libos_time_t timeout);
+
+/**
+ * @brief Wakes up one task waiting on the condition variable.
+ * 
+ * @details
+ * Does nothing when no task is waiting, the signal is not stored for a
+ * future wait.
+ * 
+ * @param[in] handle The condition variable to signal.
+ * 
+ * @retval LIBOS_ERR_OK The condition variable is signalled.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for signalling the condition variable.
+ */
+libos_err_t libos_condvar_signal(libos_condvar_handle_t handle);
+
+/**
+ * @brief Wakes up all tasks waiting on the condition variable.
+ * 
+ * @details
+ * The woken tasks relock the mutex one after the other. Use this when the
+ * change in state can satisfy more than one waiter, or when the waiters wait
+ * for different conditions on the same condition variable.
+ * 
+ * @param[in] handle The condition variable to broadcast.
+ * 
+ * @retval LIBOS_ERR_OK The condition variable is broadcasted.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for broadcasting the condition variable.
+ */
+libos_err_t libos_condvar_broadcast(libos_condvar_handle_t handle);
+
+#if LIBOS_CONDVAR_ENABLE_DYNAMIC_ALLOCATION==1
+
+/**
+ * @brief Allocate memory for a new condition variable and initialize it.
+ * 
+ * @param[out] handle The handle to the new condition variable.
+ * 
+ * @retval LIBOS_ERR_OK The condition variable is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_NO_MEM Failed to allocate memory for the condition variable.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for allocating and initialing the condition variable.
+ */
+libos_err_t libos_condvar_create_dynamic(libos_condvar_handle_t *handle);
+
+#endif // LIBOS_CONDVAR_ENABLE_DYNAMIC_ALLOCATION==1
+
+#if LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @brief Initializes the given condition variable.
+ * 
+ * @param[in] condvar The data structure for the condition variable.
+ * @param[out] handle The handle to the condition variable.
+ * 
+ * @retval LIBOS_ERR_OK The condition variable is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref condvar and/or @ref handle is NULL.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for initialing the condition variable.
+ */
+libos_err_t libos_condvar_create_static(libos_condvar_t *condvar, libos_condvar_handle_t *handle);
+
+#endif // LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @brief Deletes the previously initialized condition variable (and deallocates if dynamic).
+ * 
+ * @details
+ * No task may be waiting on the condition variable.
+ * 
+ * @param[in] handle The condition variable to delete.
+ */
+void libos_condvar_delete(libos_condvar_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_CONCURRENT_CONDVAR_H
@@ -0,0 +1,284 @@
+/**
+ * @file event_group.h
+ * @brief Abstract API for a event group (event flags) object.
+ * 
+ * @details
+ * This header provides the API to a system native event group
+ * synchronisation primitive. A event group holds a set of flags (bits) that
+ * can be set and cleared. Tasks can wait until any, or all, of the flags in a
+ * mask are set. One call to set flags wakes up all the waiters whose
+ * condition is satisfied by the new flags, so a single event can release
+ * multiple tasks at once.
+ * 
+ * The flags are passed as a libos_event_bits_t mask, the bits.h macros can be
+ * used to build and inspect them (for example SET_FLAG and HAS_FLAG). Not all
+ * platforms support all 32 bits, LIBOS_EVENT_GROUP_USABLE_BITS is the mask of
+ * the bits that can be used.
+ * 
+ * Example:
+ * @code{.c}
+ * #define EVENT_RX_DONE 0
+ * #define EVENT_TX_DONE 1
+ * 
+ * libos_event_bits_t bits = 0;
+ * SET_FLAG(bits, EVENT_RX_DONE);
+ * SET_FLAG(bits, EVENT_TX_DONE);
+ * libos_event_bits_t result;
+ * if (libos_event_group_wait(handle, bits, true, true, timeout, &result) == LIBOS_ERR_OK) {
+ *   // Both transfers are done.
+ * }
+ * @endcode
+ * 
+ * The API is shaped like the mutex API (see libos/concurrent/mutex.h). If the
+ * platform supports it, static and dynamic allocations are supported. If only
+ * dynamic allocations are supported the system is allowed to wrap static
+ * allocations to dynamic allocations. This is with the requirement that
+ * libos_event_group_t typedef is still defined.
+ * 
+ * 
+ * IMPLEMENTORS:
+ * For the implementor it is required to provide a
+ * libos/platform/concurrent/event_group.h header. This header has to provide
+ * the following types:
+ * * libos_event_group_handle_t
+ * * libos_event_group_t (optional)
+ * 
+ * The libos_event_group_handle_t is a type that refers to a event group in the
+ * system. This is often a pointer but is not required to be one. The
+ * libos_event_group_t type is only required if the platform supports static
+ * allocations of event groups.
+ * The header can define LIBOS_EVENT_GROUP_USABLE_BITS if the native primitive
+ * has less than 32 flags (for example 24 on FreeRTOS with 32-bit ticks).
+ * 
+ * The header implementation can provide the
+ * LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION and
+ * LIBOS_EVENT_GROUP_ENABLE_DYNAMIC_ALLOCATION macros. They follow the same
+ * rules as the LIBOS_MUTEX_ENABLE_* variants. If the header doesn't define
+ * them, they will default to the value of the mutex variant. A implementation
+ * must at least provide 1 initialization method.
+ * 
+ * A implementation that emulates the event group on top of other primitives
+ * can use libos_event_group_is_satisfied to evaluate the wait conditions, such
+ * that every platform has the same any/all semantics.
+ * 
+ * If the platform provides library functions they should be enclosed
+ * in a extern "C" block like:
+ * 
+ * @code
+ * #ifdef __cplusplus
+ * extern "C" {
+ * #endif // __cplusplus
+ * 
+ * // Functions
+ * 
+ * #ifdef __cplusplus
+ * }
+ * #endif // __cplusplus
+ * 
+ * @endcode
+ * 
+ * Or, if it does not have a block, each function should be marked as
+ * @code
+ * extern "C"
+ * @endcode
+ * . The general API header for the event group places all the functions in a
+ * extern "C" code block.
+ */
+
+#pragma once
+#ifndef LIBOS_CONCURRENT_EVENT_GROUP_H
+#define LIBOS_CONCURRENT_EVENT_GROUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "libos/bits.h"
+#include "libos/error.h"
+#include "libos/time.h"
+#include "libos/concurrent/mutex.h"
+
+/**
+ * @brief The type of the set of flags in a event group.
+ */
+typedef uint32_t libos_event_bits_t;
+
+#include "libos/platform/concurrent/event_group.h"
+
+#ifndef LIBOS_EVENT_GROUP_USABLE_BITS
+
+/**
+ * @brief The mask of flags that can be used in a event group on this platform.
+ */
+#define LIBOS_EVENT_GROUP_USABLE_BITS ((libos_event_bits_t)0xFFFFFFFF)
+#endif // LIBOS_EVENT_GROUP_USABLE_BITS
+
+#ifndef LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION
+#define LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION
+#endif // LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION
+
+#ifndef LIBOS_EVENT_GROUP_ENABLE_DYNAMIC_ALLOCATION
+#define LIBOS_EVENT_GROUP_ENABLE_DYNAMIC_ALLOCATION LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION
+#endif // LIBOS_EVENT_GROUP_ENABLE_DYNAMIC_ALLOCATION
+
+#if LIBOS_EVENT_GROUP_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION!=1
+#error "The platform doesn't provide either a static or dynamic initialization method for event groups."
+#endif // LIBOS_EVENT_GROUP_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION!=1
+
+/**
+ * @def LIBOS_EVENT_GROUP_STATIC_DATA_STRUCT(name)
+ * @brief Define a variable of libos_event_group_t with @ref name if static allocation is supported
+ * 
+ * @param[in] name The name of of the variable if defined.
+ */
+
+#if LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_EVENT_GROUP_STATIC_DATA_STRUCT(name) libos_event_group_t name
+#else // LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION==1
+// Don't define struct
+#define LIBOS_EVENT_GROUP_STATIC_DATA_STRUCT(static_data_name)
+#endif // LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @def LIBOS_EVENT_GROUP_CREATE_PREFER_STATIC(static_data_name, handle)
+ * @brief Call libos_event_group_create_static if static allocation is supported, otherwise call libos_event_group_create_dynamic.
+ * 
+ * @details
+ * Conditional implementation for when static allocation is supported or not.
+ * The parameter are names for the variables, they are NOT pointers yet.
+ * 
+ * @param[in] static_data_name The name of of the variable for the static data struct.
+ * @param[in] handle The name of the variable to place the resulting handle in.
+ */
+#if LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_EVENT_GROUP_CREATE_PREFER_STATIC(static_data_name, handle) libos_event_group_create_static(&(static_data_name),&(handle))
+#else // LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_EVENT_GROUP_CREATE_PREFER_STATIC(static_data_name, handle) libos_event_group_create_dynamic(&(handle))
+#endif // LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION==1
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Checks if the flags satisfy the wait condition.
+ * 
+ * @param[in] current The flags that are currently set.
+ * @param[in] wait_bits The flags that are waited for.
+ * @param[in] wait_all If true all @ref wait_bits must be set, otherwise any of them.
+ * 
+ * @retval true The condition is satisfied.
+ * @retval false The condition is not satisfied (always for a empty @ref wait_bits).
+ */
+static inline bool libos_event_group_is_satisfied(libos_event_bits_t current, libos_event_bits_t wait_bits, bool wait_all)
+{
+    if (wait_all)
+    {
+        return HAS_MASK(current, wait_bits);
+    }
+    return GET_MASK(current, wait_bits) != 0;
+}
+
+/**
+ * @brief Sets the flags in the event group and wakes up all waiters that are satisfied.
+ * 
+ * @param[in] handle The event group to set the flags in.
+ * @param[in] bits The flags to set.
+ * 
+ * @retval LIBOS_ERR_OK The flags are set.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL or @ref bits contains unusable flags.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for setting the flags.
+ */
+libos_err_t libos_event_group_set(libos_event_group_handle_t handle, libos_event_bits_t bits);
+
+/**
+ * @brief Clears the flags in the event group.
+ * 
+ * @param[in] handle The event group to clear the flags in.
+ * @param[in] bits The flags to clear.
+ * 
+ * @retval LIBOS_ERR_OK The flags are cleared.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL or @ref bits contains unusable flags.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for clearing the flags.
+ */
+libos_err_t libos_event_group_clear(libos_event_group_handle_t handle, libos_event_bits_t bits);
+
+/**
+ * @brief Returns the flags that are currently set.
+ * 
+ * @param[in] handle The event group to get the flags of.
+ * 
+ * @return libos_event_bits_t The flags that are set (0 if @ref handle is NULL).
+ */
+libos_event_bits_t libos_event_group_get(libos_event_group_handle_t handle);
+
+/**
+ * @brief Waits until any or all of the given flags are set, within the given time.
+ * 
+ * @param[in] handle The event group to wait on.
+ * @param[in] wait_bits The flags to wait for.
+ * @param[in] wait_all If true, wait until all @ref wait_bits are set, otherwise until any of them is set.
+ * @param[in] clear_on_exit If true, the @ref wait_bits are atomically cleared when the condition is satisfied.
+ * @param[in] timeout The time (in platform ticks) to allow to wait for the flags.
+ * @param[out] bits The flags that were set when the wait ended (before clearing), can be NULL.
+ * 
+ * @retval LIBOS_ERR_OK The condition is satisfied.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL or @ref wait_bits is empty or contains unusable flags.
+ * @retval LIBOS_ERR_TIMEOUT The condition was not satisfied before the end of the timeout.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for waiting on the flags.
+ */
+libos_err_t libos_event_group_wait(libos_event_group_handle_t handle, libos_event_bits_t wait_bits, bool wait_all, bool clear_on_exit, libos_time_t timeout, libos_event_bits_t *bits);
+
+#if LIBOS_EVENT_GROUP_ENABLE_DYNAMIC_ALLOCATION==1
+
+/**
+ * @brief Allocate memory for a new event group and initialize it with all flags cleared.
+ * 
+ * @param[out] handle The handle to the new event group.
+ * 
+ * @retval LIBOS_ERR_OK The event group is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_NO_MEM Failed to allocate memory for the event group.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for allocating and initialing the event group.
+ */
+libos_err_t libos_event_group_create_dynamic(libos_event_group_handle_t *handle);
+
+#endif // LIBOS_EVENT_GROUP_ENABLE_DYNAMIC_ALLOCATION==1
+
+#if LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @brief Initializes the given event group with all flags cleared.
+ * 
+ * @param[in] event_group The data structure for the event group.
+ * @param[out] handle The handle to the event group.
+ * 
+ * @retval LIBOS_ERR_OK The event group is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref event_group and/or @ref handle is NULL.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for initialing the event group.
+ */
+libos_err_t libos_event_group_create_static(libos_event_group_t *event_group, libos_event_group_handle_t *handle);
+
+#endif // LIBOS_EVENT_GROUP_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @brief Deletes the previously initialized event group (and deallocates if dynamic).
+ * 
+ * @param[in] handle The event group to delete.
+ */
+void libos_event_group_delete(libos_event_group_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_CONCURRENT_EVENT_GROUP_H
@@ -17,6 +17,11 @@
  * prototype also needs to be defined to the actual recursive mutex type). It
  * is the user of the mutex to ensure no recursive lock are done mutexes that
  * may or may not be recursive.
+ * If the platform supports adaptive mutexes the prototypes for the adaptive
+ * constructors are enabled. A adaptive mutex spins for a limited number of
+ * attempts (the spin budget) when the mutex is already taken, before it falls
+ * back to blocking on the platform primitive. This avoids a context switch for
+ * very short critical sections on multi-core systems.
  * 
  * This header also provides some convience macros to deal with initializing
  * mutexes while supporting both static and dynamic allocations.
@@ -34,6 +39,33 @@
  * type is only required if the platform supports static allocations of
  * mutexes. If it only supports dynamic allocations, it MAY wrap static
  * allocations in a dynamic allocation.
+ * The platform has to provide libos_mutex_try_lock, either as a function or
+ * as a function-like macro or static inline function defined under that name.
+ * It should make sure that the uncontended path does not do any system call
+ * and never queries the current time. A port without a native try-lock can
+ * set LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK to 1 instead, to get a default that
+ * calls libos_mutex_lock with a zero timeout.
+ * 
+ * If LIBOS_MUTEX_ENABLE_STATS is defined as 1, the implementation has to keep
+ * contention statistics for each mutex. The libos_mutex_t (or whatever the
+ * handle refers to) should contain a LIBOS_MUTEX_STATS_DATA_STRUCT member for
+ * this. The lock implementation must call LIBOS_MUTEX_STATS_ACQUIRED once the
+ * mutex is taken, and the unlock implementation must call
+ * LIBOS_MUTEX_STATS_RELEASED right before the mutex is given back. Both are
+ * called while the mutex is held, so the statistics are protected by the mutex
+ * itself. For a recursive mutex, only the outermost lock and unlock are
+ * recorded. The libos_mutex_stats_get and libos_mutex_stats_reset functions
+ * have to be provided as well. When the statistics are disabled these macros
+ * expand to nothing.
+ * 
+ * For the trace recorder (see libos/trace.h), the lock implementation calls
+ * LIBOS_MUTEX_TRACE_WAIT_BEGIN right before it blocks on a contended mutex,
+ * LIBOS_MUTEX_TRACE_WAIT_END when the blocking ends (locked or timed out) and
+ * LIBOS_MUTEX_TRACE_LOCKED once the mutex is taken (also on the uncontended
+ * path). The unlock implementation calls LIBOS_MUTEX_TRACE_UNLOCKED right
+ * before the mutex is given back. These expand to nothing unless
+ * LIBOS_ENABLE_TRACE and LIBOS_TRACE_ENABLE_MUTEX are 1.
+ * 
  * The recursive mutex must have the same handle type as the regular mutex.
  * To a consumer of the mutex this difference is not visible. If the
  * implementation needs to differentiate between them, this needs be handled
@@ -48,6 +80,12 @@
  * The header also provides LIBOS_MUTEX_ENABLE_RECURSIVE macro. If the value is
  * defined as 1, the platform supports recursive mutexes, any other value, or
  * not defined will indicate no support.
+ * The same goes for the LIBOS_MUTEX_ENABLE_ADAPTIVE macro and adaptive
+ * mutexes. A adaptive mutex must have the same handle type as the regular
+ * mutex. On single core systems spinning is pointless, the implementation is
+ * allowed to ignore the spin budget and create a regular mutex instead. The
+ * implementation should use LIBOS_CPU_RELAX() between spin attempts, and can
+ * override it with a better suited hint for the architecture.
  * 
  * If the platform provides library functions they should be enclosed
  * in a extern "C" block like: 
@@ -77,9 +115,117 @@
 #ifndef LIBOS_CONCURRENT_MUTEX_H
 #define LIBOS_CONCURRENT_MUTEX_H
 
+#include <stdint.h>
+
 #include "libos/error.h"
 #include "libos/time.h"
 
+#ifndef LIBOS_MUTEX_ENABLE_STATS
+#define LIBOS_MUTEX_ENABLE_STATS 0
+#endif // LIBOS_MUTEX_ENABLE_STATS
+
+#if LIBOS_MUTEX_ENABLE_STATS==1
+
+/**
+ * @brief Contention and hold time statistics of a single mutex.
+ * 
+ * @details
+ * Defined before the platform header is included, such that the platform can
+ * embed it into the libos_mutex_t type.
+ */
+typedef struct {
+    uint32_t acquire_count;                         ///< The number of times the mutex was taken.
+    uint32_t contended_count;                       ///< The number of times the mutex was already taken when trying to lock it.
+    libos_time_microseconds_t total_wait_time_us;   ///< The total time spent waiting on the mutex.
+    libos_time_microseconds_t max_wait_time_us;     ///< The longest wait for the mutex.
+    libos_time_microseconds_t max_hold_time_us;     ///< The longest time the mutex was held.
+    libos_time_t acquired_at;                       ///< Implementation detail: when the mutex was last taken.
+} libos_mutex_stats_t;
+
+/**
+ * @brief Define a variable of libos_mutex_stats_t with @ref name if the statistics are enabled.
+ * 
+ * @param[in] name The name of of the variable if defined.
+ */
+#define LIBOS_MUTEX_STATS_DATA_STRUCT(name) libos_mutex_stats_t name
+
+/**
+ * @brief Records that the mutex is taken, to be called by the lock implementation.
+ * 
+ * @param[in] stats Pointer to the statistics of the mutex.
+ * @param[in] contended True if the mutex was taken by someone else when trying to take it.
+ * @param[in] wait_start The time when the waiting began (only evaluated if @ref contended is true).
+ */
+#define LIBOS_MUTEX_STATS_ACQUIRED(stats, contended, wait_start) libos_mutex_stats_record_acquired((stats), (contended), (contended) ? (wait_start) : libos_time_from_ms(0))
+
+/**
+ * @brief Records that the mutex will be given back, to be called by the unlock implementation.
+ * 
+ * @param[in] stats Pointer to the statistics of the mutex.
+ */
+#define LIBOS_MUTEX_STATS_RELEASED(stats) libos_mutex_stats_record_released((stats))
+
+static inline void libos_mutex_stats_record_acquired(libos_mutex_stats_t *stats, bool contended, libos_time_t wait_start)
+{
+    libos_time_t now = libos_time_get_now();
+    stats->acquire_count++;
+    if (contended)
+    {
+        libos_time_microseconds_t wait = libos_time_difference_us(wait_start, now);
+        stats->contended_count++;
+        stats->total_wait_time_us += wait;
+        if (wait > stats->max_wait_time_us)
+        {
+            stats->max_wait_time_us = wait;
+        }
+    }
+    stats->acquired_at = now;
+}
+
+static inline void libos_mutex_stats_record_released(libos_mutex_stats_t *stats)
+{
+    libos_time_microseconds_t hold = libos_time_difference_us(stats->acquired_at, libos_time_get_now());
+    if (hold > stats->max_hold_time_us)
+    {
+        stats->max_hold_time_us = hold;
+    }
+}
+
+#else // LIBOS_MUTEX_ENABLE_STATS==1
+#define LIBOS_MUTEX_STATS_DATA_STRUCT(name)
+#define LIBOS_MUTEX_STATS_ACQUIRED(stats, contended, wait_start) do { } while(0)
+#define LIBOS_MUTEX_STATS_RELEASED(stats) do { } while(0)
+#endif // LIBOS_MUTEX_ENABLE_STATS==1
+
+#include "libos/trace.h"
+
+#if LIBOS_TRACE_ENABLE_MUTEX==1
+/**
+ * @brief Records the start of a wait for a contended mutex, to be called by the lock implementation.
+ */
+#define LIBOS_MUTEX_TRACE_WAIT_BEGIN(handle) LIBOS_TRACE_EVENT(LIBOS_TRACE_TYPE_BEGIN, "libos_mutex_wait", (uintptr_t)(handle))
+
+/**
+ * @brief Records the end of a wait for a contended mutex, to be called by the lock implementation.
+ */
+#define LIBOS_MUTEX_TRACE_WAIT_END(handle) LIBOS_TRACE_EVENT(LIBOS_TRACE_TYPE_END, "libos_mutex_wait", (uintptr_t)(handle))
+
+/**
+ * @brief Records that the mutex is taken, to be called by the lock implementation.
+ */
+#define LIBOS_MUTEX_TRACE_LOCKED(handle) LIBOS_TRACE_EVENT(LIBOS_TRACE_TYPE_INSTANT, "libos_mutex_lock", (uintptr_t)(handle))
+
+/**
+ * @brief Records that the mutex will be given back, to be called by the unlock implementation.
+ */
+#define LIBOS_MUTEX_TRACE_UNLOCKED(handle) LIBOS_TRACE_EVENT(LIBOS_TRACE_TYPE_INSTANT, "libos_mutex_unlock", (uintptr_t)(handle))
+#else // LIBOS_TRACE_ENABLE_MUTEX==1
+#define LIBOS_MUTEX_TRACE_WAIT_BEGIN(handle) do { } while(0)
+#define LIBOS_MUTEX_TRACE_WAIT_END(handle) do { } while(0)
+#define LIBOS_MUTEX_TRACE_LOCKED(handle) do { } while(0)
+#define LIBOS_MUTEX_TRACE_UNLOCKED(handle) do { } while(0)
+#endif // LIBOS_TRACE_ENABLE_MUTEX==1
+
 #include "libos/platform/concurrent/mutex.h"
 
 #ifndef LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION
@@ -94,10 +240,63 @@
 #define LIBOS_MUTEX_ENABLE_RECURSIVE 0
 #endif // LIBOS_MUTEX_ENABLE_RECURSIVE
 
+#ifndef LIBOS_MUTEX_ENABLE_ADAPTIVE
+#define LIBOS_MUTEX_ENABLE_ADAPTIVE 0
+#endif // LIBOS_MUTEX_ENABLE_ADAPTIVE
+
+#ifndef LIBOS_MUTEX_ENABLE_POOL_ALLOCATION
+#define LIBOS_MUTEX_ENABLE_POOL_ALLOCATION 0
+#endif // LIBOS_MUTEX_ENABLE_POOL_ALLOCATION
+
+#ifndef LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK
+#define LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK 0
+#endif // LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK
+
+#ifndef LIBOS_MUTEX_ADAPTIVE_DEFAULT_SPIN_COUNT
+
+/**
+ * @brief The default spin budget for adaptive mutexes.
+ * 
+ * @details
+ * A reasonable number of attempts to lock a taken mutex before blocking. The
+ * application can override this by defining it as a command line symbol.
+ */
+#define LIBOS_MUTEX_ADAPTIVE_DEFAULT_SPIN_COUNT 100
+#endif // LIBOS_MUTEX_ADAPTIVE_DEFAULT_SPIN_COUNT
+
+#ifndef LIBOS_CPU_RELAX
+
+/**
+ * @brief Hints the CPU that the caller is in a spin-wait loop.
+ * 
+ * @details
+ * This lowers the power usage and the pressure on the memory bus of the
+ * spinning core, and on SMT cores it gives the sibling thread more execution
+ * resources. It has no other (functional) effect. If the architecture is not
+ * known it expands to nothing.
+ */
+#if defined(__i386__) || defined(__x86_64__)
+#define LIBOS_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+#define LIBOS_CPU_RELAX() __asm__ __volatile__("yield" ::: "memory")
+#elif defined(__XTENSA__) || defined(__riscv)
+#define LIBOS_CPU_RELAX() __asm__ __volatile__("nop" ::: "memory")
+#else
+#define LIBOS_CPU_RELAX() do { } while(0)
+#endif
+#endif // LIBOS_CPU_RELAX
+
 #if LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION!=1
 #error "The platform doesn't provide either a static or dynamic initialization method for mutexes. How are you suppose to initialize mutexes?"
 #endif // LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION!=1
 
+#if LIBOS_MUTEX_ENABLE_POOL_ALLOCATION==1
+#if LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION!=1
+#error "Pool allocation of mutexes requires the static initialization method of the platform."
+#endif // LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION!=1
+#include "libos/memory/pool.h"
+#endif // LIBOS_MUTEX_ENABLE_POOL_ALLOCATION==1
+
 /**
  * @def LIBOS_MUTEX_STATIC_DATA_STRUCT(name)
  * @brief Define a variable of libos_mutex_t with @ref name if static allocation is supported
@@ -194,6 +393,44 @@
     // Not supported, so don't define so it gives a compile error when not generating doxygen.
 #endif // LIBOS_MUTEX_ENABLE_RECURSIVE==1
 
+/**
+ * @def LIBOS_MUTEX_CREATE_ADAPTIVE_PREFER_STATIC(static_data_name, handle, spin_count)
+ * @brief Call libos_mutex_create_adaptive_static if static allocation is supported, otherwise call libos_mutex_create_adaptive_dynamic.
+ * 
+ * @details
+ * Conditional implementation for when static allocation is supported or not.
+ * The parameter are names for the variables, they are NOT pointers yet.
+ * 
+ * Example:
+ * @code{.c}
+ * LIBOS_MUTEX_STATIC_DATA_STRUCT(static_mutex);
+ * libos_mutex_handle_t handle;
+ * 
+ * if (LIBOS_MUTEX_CREATE_ADAPTIVE_PREFER_STATIC(static_mutex, handle, LIBOS_MUTEX_ADAPTIVE_DEFAULT_SPIN_COUNT) != LIBOS_ERR_OK)
+ * {
+ *   // Do stuff
+ * }
+ * @endcode
+ * 
+ * 
+ * @param[in] static_data_name The name of of the variable for the static data struct.
+ * @param[in] handle The name of the variable to place the resulting handle in.
+ * @param[in] spin_count The number of attempts to lock the mutex before blocking.
+ */
+
+#if LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+    #if LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
+    #define LIBOS_MUTEX_CREATE_ADAPTIVE_PREFER_STATIC(static_data_name, handle, spin_count) libos_mutex_create_adaptive_static(&(static_data_name),&(handle),(spin_count))
+    #else // LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
+    #define LIBOS_MUTEX_CREATE_ADAPTIVE_PREFER_STATIC(static_data_name, handle, spin_count) libos_mutex_create_adaptive_dynamic(&(handle),(spin_count))
+    #endif // LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
+#else // LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+    #ifdef _DOXYGEN_
+    #define LIBOS_MUTEX_CREATE_ADAPTIVE_PREFER_STATIC(static_data_name, handle, spin_count)
+    #endif // _DOXYGEN_
+    // Not supported, so don't define so it gives a compile error when not generating doxygen.
+#endif // LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+
 /**
  * @brief Attempts to lock the mutex within the given time.
  * 
@@ -209,6 +446,42 @@
  */
 libos_err_t libos_mutex_lock(libos_mutex_handle_t handle, libos_time_t timeout);
 
+#ifndef libos_mutex_try_lock
+
+/**
+ * @brief Attempts to lock the mutex without waiting for it.
+ * 
+ * @details
+ * This is the fast path to probe a mutex. In contrary to @ref libos_mutex_lock
+ * it does not take a timeout, which means that no timeout has to be computed or
+ * compared against the current time. Platform implementations guarantee that
+ * acquiring a free mutex is done without any system call. Only when the mutex
+ * is taken a platform may need a system call to find that out.
+ * 
+ * With LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK set to 1 this defers to
+ * @ref libos_mutex_lock with a zero timeout instead, which does go through
+ * the timeout handling of the platform.
+ * 
+ * @param[in] handle The mutex to lock
+ * 
+ * @retval LIBOS_ERR_OK The mutex is successfully locked.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_BUSY The mutex is already taken.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for locking mutex.
+ */
+#if LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK==1
+static inline libos_err_t libos_mutex_try_lock(libos_mutex_handle_t handle)
+{
+    libos_err_t err = libos_mutex_lock(handle, libos_time_from_ms(0));
+    return (err == LIBOS_ERR_TIMEOUT) ? LIBOS_ERR_BUSY : err;
+}
+#else // LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK==1
+libos_err_t libos_mutex_try_lock(libos_mutex_handle_t handle);
+#endif // LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK==1
+#endif // libos_mutex_try_lock
+
 /**
  * @brief Unlocks the mutex.
  * 
@@ -257,6 +530,25 @@ libos_err_t libos_mutex_create_recursive_dynamic(libos_mutex_handle_t *handle);
 
 #endif // LIBOS_MUTEX_ENABLE_RECURSIVE==1
 
+#if LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+
+/**
+ * @brief Allocate memory for a new mutex and initialize a adaptive (spin-then-block) mutex.
+ * 
+ * @param[out] handle The handle to the new adaptive mutex.
+ * @param[in] spin_count The number of attempts to lock a taken mutex before blocking (0 never spins).
+ * 
+ * @retval LIBOS_ERR_OK The mutex is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_NO_MEM Failed to allocate memory for the mutex.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for allocating and initialing the adaptive mutex.
+ */
+libos_err_t libos_mutex_create_adaptive_dynamic(libos_mutex_handle_t *handle, uint32_t spin_count);
+
+#endif // LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+
 #endif // LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION==1
 
 #if LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
@@ -293,6 +585,25 @@ libos_err_t libos_mutex_create_recursive_static(libos_mutex_t *mutex, libos_mute
 
 #endif // LIBOS_MUTEX_ENABLE_RECURSIVE==1
 
+#if LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+
+/**
+ * @brief Initializes the given mutex as a adaptive (spin-then-block) mutex.
+ * 
+ * @param[in] mutex The data structure for mutex.
+ * @param[out] handle The handle to the mutex.
+ * @param[in] spin_count The number of attempts to lock a taken mutex before blocking (0 never spins).
+ * 
+ * @retval LIBOS_ERR_OK The mutex is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref mutex and/or @ref handle is NULL.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for initialing the adaptive mutex.
+ */
+libos_err_t libos_mutex_create_adaptive_static(libos_mutex_t *mutex, libos_mutex_handle_t *handle, uint32_t spin_count);
+
+#endif // LIBOS_MUTEX_ENABLE_ADAPTIVE==1
+
 #endif // LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
 
 /**
@@ -302,4 +613,105 @@ libos_err_t libos_mutex_create_recursive_static(libos_mutex_t *mutex, libos_mute
  */
 void libos_mutex_delete(libos_mutex_handle_t handle);
 
+#if LIBOS_MUTEX_ENABLE_POOL_ALLOCATION==1
+
+/**
+ * @def LIBOS_MUTEX_POOL_STATIC_DATA_STRUCT(name, count)
+ * @brief Define the storage with @ref name for a pool of @ref count mutexes.
+ * 
+ * @details
+ * The storage is used with LIBOS_POOL_CREATE_STATIC(name, pool, sizeof(libos_mutex_t), true).
+ * 
+ * @param[in] name The name of the storage variable.
+ * @param[in] count The maximum number of mutexes in the pool.
+ */
+#define LIBOS_MUTEX_POOL_STATIC_DATA_STRUCT(name, count) LIBOS_POOL_STATIC_DATA_STRUCT(name, sizeof(libos_mutex_t), count)
+
+/**
+ * @brief Creates a mutex with the data structure taken from the pool.
+ * 
+ * @details
+ * This is a replacement for libos_mutex_create_dynamic with a bounded
+ * latency and without heap fragmentation. The block is initialized with
+ * libos_mutex_create_static.
+ * 
+ * @param[in] pool The pool to take the data structure from, with blocks of at least sizeof(libos_mutex_t).
+ * @param[out] mutex The data structure taken from the pool, needed for libos_mutex_delete_pooled.
+ * @param[out] handle The handle to the mutex.
+ * 
+ * @retval LIBOS_ERR_OK The mutex is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref pool, @ref mutex and/or @ref handle is NULL, or the blocks are too small.
+ * @retval LIBOS_ERR_NO_MEM The pool has no free blocks.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for creating the mutex.
+ */
+static inline libos_err_t libos_mutex_create_pooled(libos_pool_t *pool, libos_mutex_t **mutex, libos_mutex_handle_t *handle)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(pool);
+    LIBOS_ERR_RET_ARG_NOT_NULL(mutex);
+    LIBOS_ERR_RET_ARG_NOT_NULL(handle);
+    LIBOS_ERR_RET_ON_TRUE(libos_pool_block_size(pool) < sizeof(libos_mutex_t), LIBOS_ERR_INVALID_ARG);
+
+    libos_mutex_t *data = (libos_mutex_t*)libos_pool_alloc(pool);
+    LIBOS_ERR_RET_MEMORY_NOT_NULL(data);
+
+    libos_err_t res = libos_mutex_create_static(data, handle);
+    if (res != LIBOS_ERR_OK)
+    {
+        (void)libos_pool_free(pool, data);
+        return res;
+    }
+    *mutex = data;
+    return LIBOS_ERR_OK;
+}
+
+/**
+ * @brief Deletes a mutex created with libos_mutex_create_pooled and gives the data structure back to the pool.
+ * 
+ * @param[in] pool The pool the mutex was taken from.
+ * @param[in] mutex The data structure returned by libos_mutex_create_pooled.
+ * @param[in] handle The mutex to delete.
+ */
+static inline void libos_mutex_delete_pooled(libos_pool_t *pool, libos_mutex_t *mutex, libos_mutex_handle_t handle)
+{
+    libos_mutex_delete(handle);
+    (void)libos_pool_free(pool, mutex);
+}
+
+#endif // LIBOS_MUTEX_ENABLE_POOL_ALLOCATION==1
+
+#if LIBOS_MUTEX_ENABLE_STATS==1
+
+/**
+ * @brief Takes a snapshot of the statistics of the mutex.
+ * 
+ * @details
+ * The snapshot is taken without locking the mutex, so the values can be torn
+ * when the mutex is used at the same time. This is a diagnostic tool.
+ * 
+ * @param[in] handle The mutex to get the statistics of.
+ * @param[out] stats The place to copy the statistics to.
+ * 
+ * @retval LIBOS_ERR_OK The statistics are copied.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle and/or @ref stats is NULL.
+ * 
+ * @return libos_err_t The libos standard success code for copying the statistics.
+ */
+libos_err_t libos_mutex_stats_get(libos_mutex_handle_t handle, libos_mutex_stats_t *stats);
+
+/**
+ * @brief Resets all the statistics of the mutex to 0.
+ * 
+ * @param[in] handle The mutex to reset the statistics of.
+ * 
+ * @retval LIBOS_ERR_OK The statistics are reset.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * 
+ * @return libos_err_t The libos standard success code for resetting the statistics.
+ */
+libos_err_t libos_mutex_stats_reset(libos_mutex_handle_t handle);
+
+#endif // LIBOS_MUTEX_ENABLE_STATS==1
+
 #endif // LIBOS_CONCURRENT_MUTEX_H
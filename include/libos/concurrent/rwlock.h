@@ -0,0 +1,267 @@
+/**
+ * @file rwlock.h
+ * @brief Abstract API for a reader-writer lock object.
+ * 
+ * @details
+ * This header provides the API to a system native reader-writer lock
+ * synchronisation primitive. Multiple readers can hold the lock at the same
+ * time, while a writer always has exclusive access. This allows read-mostly
+ * data to be accessed in parallel from multiple cores, where a mutex would
+ * serialize all the readers.
+ * 
+ * The API is shaped like the mutex API (see libos/concurrent/mutex.h). It
+ * provides lock with timeout and unlock methods for both readers and writers,
+ * and, if the platform supports it, static and dynamic allocations. If only
+ * dynamic allocations are supported the system is allowed to wrap static
+ * allocations to dynamic allocations. This is with the requirement that
+ * libos_rwlock_t typedef is still defined.
+ * 
+ * On creation the lock can be configured to prefer writers. A writer
+ * preferring lock does not hand out new read locks while a writer is waiting,
+ * such that a steady stream of readers can't starve the writers. Without the
+ * preference readers are allowed to keep entering while a writer waits, which
+ * gives the best read throughput.
+ * 
+ * This header also provides some convience macros to deal with initializing
+ * reader-writer locks while supporting both static and dynamic allocations.
+ * 
+ * 
+ * IMPLEMENTORS:
+ * For the implementor it is required to provide a
+ * libos/platform/concurrent/rwlock.h header. This header has to provide the
+ * following types:
+ * * libos_rwlock_handle_t
+ * * libos_rwlock_t (optional)
+ * 
+ * The libos_rwlock_handle_t is a type that refers to a reader-writer lock in
+ * the system. This is often a pointer but is not required to be one. The
+ * libos_rwlock_t type is only required if the platform supports static
+ * allocations of reader-writer locks.
+ * 
+ * The header implementation can provide the
+ * LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION and
+ * LIBOS_RWLOCK_ENABLE_DYNAMIC_ALLOCATION macros. They follow the same rules as
+ * the LIBOS_MUTEX_ENABLE_* variants. If the header doesn't define them, they
+ * will default to the value of the mutex variant. A implementation must at
+ * least provide 1 initialization method.
+ * If the platform has no preference support, it is allowed to ignore the
+ * writer preference. This must be clearly documented in the platform
+ * implementation documentation.
+ * 
+ * If the platform provides library functions they should be enclosed
+ * in a extern "C" block like:
+ * 
+ * @code
+ * #ifdef __cplusplus
+ * extern "C" {
+ * #endif // __cplusplus
+ * 
+ * // Functions
+ * 
+ * #ifdef __cplusplus
+ * }
+ * #endif // __cplusplus
+ * 
+ * @endcode
+ * 
+ * Or, if it does not have a block, each function should be marked as
+ * @code
+ * extern "C"
+ * @endcode
+ * . The general API header for the reader-writer lock places all the
+ * functions in a extern "C" code block.
+ */
+
+#pragma once
+#ifndef LIBOS_CONCURRENT_RWLOCK_H
+#define LIBOS_CONCURRENT_RWLOCK_H
+
+#include <stdbool.h>
+
+#include "libos/error.h"
+#include "libos/time.h"
+#include "libos/concurrent/mutex.h"
+
+#include "libos/platform/concurrent/rwlock.h"
+
+#ifndef LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION
+#define LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION
+#endif // LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION
+
+#ifndef LIBOS_RWLOCK_ENABLE_DYNAMIC_ALLOCATION
+#define LIBOS_RWLOCK_ENABLE_DYNAMIC_ALLOCATION LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION
+#endif // LIBOS_RWLOCK_ENABLE_DYNAMIC_ALLOCATION
+
+#if LIBOS_RWLOCK_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION!=1
+#error "The platform doesn't provide either a static or dynamic initialization method for reader-writer locks."
+#endif // LIBOS_RWLOCK_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION!=1
+
+/**
+ * @def LIBOS_RWLOCK_STATIC_DATA_STRUCT(name)
+ * @brief Define a variable of libos_rwlock_t with @ref name if static allocation is supported
+ * 
+ * Example:
+ * @code{.c}
+ * struct a {
+ *   int ab;
+ *   LIBOS_RWLOCK_STATIC_DATA_STRUCT(rwlock_data);
+ * }
+ * @endcode
+ * 
+ * @param[in] name The name of of the variable if defined.
+ */
+
+#if LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_RWLOCK_STATIC_DATA_STRUCT(name) libos_rwlock_t name
+#else // LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION==1
+// Don't define struct
+#define LIBOS_RWLOCK_STATIC_DATA_STRUCT(static_data_name)
+#endif // LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @def LIBOS_RWLOCK_CREATE_PREFER_STATIC(static_data_name, handle, prefer_writers)
+ * @brief Call libos_rwlock_create_static if static allocation is supported, otherwise call libos_rwlock_create_dynamic.
+ * 
+ * @details
+ * Conditional implementation for when static allocation is supported or not.
+ * The parameter are names for the variables, they are NOT pointers yet.
+ * 
+ * Example:
+ * @code{.c}
+ * LIBOS_RWLOCK_STATIC_DATA_STRUCT(static_rwlock);
+ * libos_rwlock_handle_t handle;
+ * 
+ * if (LIBOS_RWLOCK_CREATE_PREFER_STATIC(static_rwlock, handle, false) != LIBOS_ERR_OK)
+ * {
+ *   // Do stuff
+ * }
+ * @endcode
+ * 
+ * 
+ * @param[in] static_data_name The name of of the variable for the static data struct.
+ * @param[in] handle The name of the variable to place the resulting handle in.
+ * @param[in] prefer_writers If true, waiting writers block new readers.
+ */
+#if LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_RWLOCK_CREATE_PREFER_STATIC(static_data_name, handle, prefer_writers) libos_rwlock_create_static(&(static_data_name),&(handle),(prefer_writers))
+#else // LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_RWLOCK_CREATE_PREFER_STATIC(static_data_name, handle, prefer_writers) libos_rwlock_create_dynamic(&(handle),(prefer_writers))
+#endif // LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION==1
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Attempts to lock the reader-writer lock for reading within the given time.
+ * 
+ * @details
+ * Multiple readers can hold the lock at the same time. The lock is only
+ * unavailable for readers when it is held by a writer (or, if writers are
+ * preferred, a writer is waiting for it).
+ * 
+ * @param[in] handle The reader-writer lock to lock.
+ * @param[in] timeout The time (in platform ticks) to allow to take the lock.
+ * 
+ * @retval LIBOS_ERR_OK The lock is successfully locked for reading.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_TIMEOUT Failed to lock before the end of the timeout.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for locking for reading.
+ */
+libos_err_t libos_rwlock_read_lock(libos_rwlock_handle_t handle, libos_time_t timeout);
+
+/**
+ * @brief Releases a read lock.
+ * 
+ * @param[in] handle The reader-writer lock to unlock.
+ * 
+ * @retval LIBOS_ERR_OK The read lock is successfully released.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_INVALID_STATE Failed to unlock. Usually means no read lock was held.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for releasing a read lock.
+ */
+libos_err_t libos_rwlock_read_unlock(libos_rwlock_handle_t handle);
+
+/**
+ * @brief Attempts to lock the reader-writer lock exclusively for writing within the given time.
+ * 
+ * @param[in] handle The reader-writer lock to lock.
+ * @param[in] timeout The time (in platform ticks) to allow to take the lock.
+ * 
+ * @retval LIBOS_ERR_OK The lock is successfully locked for writing.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_TIMEOUT Failed to lock before the end of the timeout.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for locking for writing.
+ */
+libos_err_t libos_rwlock_write_lock(libos_rwlock_handle_t handle, libos_time_t timeout);
+
+/**
+ * @brief Releases a write lock.
+ * 
+ * @param[in] handle The reader-writer lock to unlock.
+ * 
+ * @retval LIBOS_ERR_OK The write lock is successfully released.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_INVALID_STATE Failed to unlock. Usually means the write lock wasn't held.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for releasing a write lock.
+ */
+libos_err_t libos_rwlock_write_unlock(libos_rwlock_handle_t handle);
+
+#if LIBOS_RWLOCK_ENABLE_DYNAMIC_ALLOCATION==1
+
+/**
+ * @brief Allocate memory for a new reader-writer lock and initialize it.
+ * 
+ * @param[out] handle The handle to the new reader-writer lock.
+ * @param[in] prefer_writers If true, waiting writers block new readers.
+ * 
+ * @retval LIBOS_ERR_OK The reader-writer lock is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_NO_MEM Failed to allocate memory for the reader-writer lock.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for allocating and initialing the reader-writer lock.
+ */
+libos_err_t libos_rwlock_create_dynamic(libos_rwlock_handle_t *handle, bool prefer_writers);
+
+#endif // LIBOS_RWLOCK_ENABLE_DYNAMIC_ALLOCATION==1
+
+#if LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @brief Initializes the given reader-writer lock.
+ * 
+ * @param[in] rwlock The data structure for the reader-writer lock.
+ * @param[out] handle The handle to the reader-writer lock.
+ * @param[in] prefer_writers If true, waiting writers block new readers.
+ * 
+ * @retval LIBOS_ERR_OK The reader-writer lock is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref rwlock and/or @ref handle is NULL.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for initialing the reader-writer lock.
+ */
+libos_err_t libos_rwlock_create_static(libos_rwlock_t *rwlock, libos_rwlock_handle_t *handle, bool prefer_writers);
+
+#endif // LIBOS_RWLOCK_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @brief Deletes the previously initialized reader-writer lock (and deallocates if dynamic).
+ * 
+ * @param[in] handle The reader-writer lock to delete.
+ */
+void libos_rwlock_delete(libos_rwlock_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_CONCURRENT_RWLOCK_H
@@ -0,0 +1,279 @@
+/**
+ * @file semaphore.h
+ * @brief Abstract API for a counting semaphore object.
+ * 
+ * @details
+ * This header provides the API to a system native counting semaphore
+ * synchronisation primitive. A semaphore holds a number of permits (up to a
+ * maximum count). Taking a permit blocks (up to the timeout) when there are
+ * no permits left, giving a permit wakes up a waiting taker.
+ * 
+ * In contrary to a mutex, a semaphore has no owner, so the permits can be
+ * given by a different task than the one that takes them. This makes it the
+ * primitive to signal between a producer and a consumer. Both the take and
+ * give operations can operate on multiple permits in one call. Giving N
+ * permits in one call is a single operation on the platform primitive, which
+ * is cheaper than N separate calls and allows the platform to wake all the
+ * waiters in one go.
+ * 
+ * The API is shaped like the mutex API (see libos/concurrent/mutex.h). If the
+ * platform supports it, static and dynamic allocations are supported. If only
+ * dynamic allocations are supported the system is allowed to wrap static
+ * allocations to dynamic allocations. This is with the requirement that
+ * libos_semaphore_t typedef is still defined.
+ * 
+ * 
+ * IMPLEMENTORS:
+ * For the implementor it is required to provide a
+ * libos/platform/concurrent/semaphore.h header. This header has to provide the
+ * following types:
+ * * libos_semaphore_handle_t
+ * * libos_semaphore_t (optional)
+ * 
+ * The libos_semaphore_handle_t is a type that refers to a semaphore in the
+ * system. This is often a pointer but is not required to be one. The
+ * libos_semaphore_t type is only required if the platform supports static
+ * allocations of semaphores.
+ * 
+ * The header implementation can provide the
+ * LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION and
+ * LIBOS_SEMAPHORE_ENABLE_DYNAMIC_ALLOCATION macros. They follow the same rules
+ * as the LIBOS_MUTEX_ENABLE_* variants. If the header doesn't define them, they
+ * will default to the value of the mutex variant. A implementation must at
+ * least provide 1 initialization method.
+ * 
+ * Taking multiple permits is all-or-nothing, a taker never holds a part of
+ * the requested permits while waiting for the rest. If the platform primitive
+ * only supports single permits, the implementation has to make sure of this
+ * itself (for example with a internal lock around the take loop).
+ * If giving permits is allowed from a interrupt service routine, this must be
+ * clearly documented in the platform implementation documentation.
+ * 
+ * If the platform provides library functions they should be enclosed
+ * in a extern "C" block like:
+ * 
+ * @code
+ * #ifdef __cplusplus
+ * extern "C" {
+ * #endif // __cplusplus
+ * 
+ * // Functions
+ * 
+ * #ifdef __cplusplus
+ * }
+ * #endif // __cplusplus
+ * 
+ * @endcode
+ * 
+ * Or, if it does not have a block, each function should be marked as
+ * @code
+ * extern "C"
+ * @endcode
+ * . The general API header for the semaphore places all the functions in a
+ * extern "C" code block.
+ */
+
+#pragma once
+#ifndef LIBOS_CONCURRENT_SEMAPHORE_H
+#define LIBOS_CONCURRENT_SEMAPHORE_H
+
+#include <stdint.h>
+
+#include "libos/error.h"
+#include "libos/time.h"
+#include "libos/concurrent/mutex.h"
+
+#include "libos/platform/concurrent/semaphore.h"
+
+#ifndef LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION
+#define LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION
+#endif // LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION
+
+#ifndef LIBOS_SEMAPHORE_ENABLE_DYNAMIC_ALLOCATION
+#define LIBOS_SEMAPHORE_ENABLE_DYNAMIC_ALLOCATION LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION
+#endif // LIBOS_SEMAPHORE_ENABLE_DYNAMIC_ALLOCATION
+
+#if LIBOS_SEMAPHORE_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION!=1
+#error "The platform doesn't provide either a static or dynamic initialization method for semaphores."
+#endif // LIBOS_SEMAPHORE_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION!=1
+
+/**
+ * @def LIBOS_SEMAPHORE_STATIC_DATA_STRUCT(name)
+ * @brief Define a variable of libos_semaphore_t with @ref name if static allocation is supported
+ * 
+ * @param[in] name The name of of the variable if defined.
+ */
+
+#if LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_SEMAPHORE_STATIC_DATA_STRUCT(name) libos_semaphore_t name
+#else // LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION==1
+// Don't define struct
+#define LIBOS_SEMAPHORE_STATIC_DATA_STRUCT(static_data_name)
+#endif // LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @def LIBOS_SEMAPHORE_CREATE_PREFER_STATIC(static_data_name, handle, max_count, initial_count)
+ * @brief Call libos_semaphore_create_static if static allocation is supported, otherwise call libos_semaphore_create_dynamic.
+ * 
+ * @details
+ * Conditional implementation for when static allocation is supported or not.
+ * The parameter are names for the variables, they are NOT pointers yet.
+ * 
+ * Example:
+ * @code{.c}
+ * LIBOS_SEMAPHORE_STATIC_DATA_STRUCT(static_semaphore);
+ * libos_semaphore_handle_t handle;
+ * 
+ * if (LIBOS_SEMAPHORE_CREATE_PREFER_STATIC(static_semaphore, handle, 16, 0) != LIBOS_ERR_OK)
+ * {
+ *   // Do stuff
+ * }
+ * @endcode
+ * 
+ * 
+ * @param[in] static_data_name The name of of the variable for the static data struct.
+ * @param[in] handle The name of the variable to place the resulting handle in.
+ * @param[in] max_count The maximum number of permits.
+ * @param[in] initial_count The number of permits available after creation.
+ */
+#if LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_SEMAPHORE_CREATE_PREFER_STATIC(static_data_name, handle, max_count, initial_count) libos_semaphore_create_static(&(static_data_name),&(handle),(max_count),(initial_count))
+#else // LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_SEMAPHORE_CREATE_PREFER_STATIC(static_data_name, handle, max_count, initial_count) libos_semaphore_create_dynamic(&(handle),(max_count),(initial_count))
+#endif // LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION==1
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Attempts to take @ref count permits within the given time.
+ * 
+ * @details
+ * Either all @ref count permits are taken, or none.
+ * 
+ * @param[in] handle The semaphore to take the permits from.
+ * @param[in] count The number of permits to take (at least 1, at most the maximum count).
+ * @param[in] timeout The time (in platform ticks) to allow to take the permits.
+ * 
+ * @retval LIBOS_ERR_OK The permits are successfully taken.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL or @ref count is out of range.
+ * @retval LIBOS_ERR_TIMEOUT Not enough permits were available before the end of the timeout.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for taking the permits.
+ */
+libos_err_t libos_semaphore_take_n(libos_semaphore_handle_t handle, uint32_t count, libos_time_t timeout);
+
+/**
+ * @brief Gives @ref count permits back to the semaphore.
+ * 
+ * @details
+ * This wakes up as many waiters as can be satisfied with the new permits
+ * in one go. If the permits would exceed the maximum count, none are given.
+ * 
+ * @param[in] handle The semaphore to give the permits to.
+ * @param[in] count The number of permits to give (at least 1).
+ * 
+ * @retval LIBOS_ERR_OK The permits are successfully given.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL or @ref count is 0.
+ * @retval LIBOS_ERR_INVALID_STATE Giving the permits would exceed the maximum count.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for giving the permits.
+ */
+libos_err_t libos_semaphore_give_n(libos_semaphore_handle_t handle, uint32_t count);
+
+/**
+ * @brief Attempts to take a single permit within the given time.
+ * 
+ * @param[in] handle The semaphore to take the permit from.
+ * @param[in] timeout The time (in platform ticks) to allow to take the permit.
+ * 
+ * @retval LIBOS_ERR_OK The permit is successfully taken.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_TIMEOUT No permit was available before the end of the timeout.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for taking the permit.
+ */
+libos_err_t libos_semaphore_take(libos_semaphore_handle_t handle, libos_time_t timeout);
+
+/**
+ * @brief Gives a single permit back to the semaphore.
+ * 
+ * @param[in] handle The semaphore to give the permit to.
+ * 
+ * @retval LIBOS_ERR_OK The permit is successfully given.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_INVALID_STATE The semaphore already holds the maximum count.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for giving the permit.
+ */
+libos_err_t libos_semaphore_give(libos_semaphore_handle_t handle);
+
+/**
+ * @brief Returns the number of permits that are currently available.
+ * 
+ * @details
+ * This is only a snapshot, the count can change right after the call.
+ * 
+ * @param[in] handle The semaphore to get the count of.
+ * 
+ * @return uint32_t The number of available permits (0 if @ref handle is NULL).
+ */
+uint32_t libos_semaphore_get_count(libos_semaphore_handle_t handle);
+
+#if LIBOS_SEMAPHORE_ENABLE_DYNAMIC_ALLOCATION==1
+
+/**
+ * @brief Allocate memory for a new semaphore and initialize it.
+ * 
+ * @param[out] handle The handle to the new semaphore.
+ * @param[in] max_count The maximum number of permits (at least 1).
+ * @param[in] initial_count The number of permits available after creation.
+ * 
+ * @retval LIBOS_ERR_OK The semaphore is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL or the counts are out of range.
+ * @retval LIBOS_ERR_NO_MEM Failed to allocate memory for the semaphore.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for allocating and initialing the semaphore.
+ */
+libos_err_t libos_semaphore_create_dynamic(libos_semaphore_handle_t *handle, uint32_t max_count, uint32_t initial_count);
+
+#endif // LIBOS_SEMAPHORE_ENABLE_DYNAMIC_ALLOCATION==1
+
+#if LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @brief Initializes the given semaphore.
+ * 
+ * @param[in] semaphore The data structure for the semaphore.
+ * @param[out] handle The handle to the semaphore.
+ * @param[in] max_count The maximum number of permits (at least 1).
+ * @param[in] initial_count The number of permits available after creation.
+ * 
+ * @retval LIBOS_ERR_OK The semaphore is successfully created.
+ * @retval LIBOS_ERR_INVALID_ARG @ref semaphore and/or @ref handle is NULL, or the counts are out of range.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for initialing the semaphore.
+ */
+libos_err_t libos_semaphore_create_static(libos_semaphore_t *semaphore, libos_semaphore_handle_t *handle, uint32_t max_count, uint32_t initial_count);
+
+#endif // LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @brief Deletes the previously initialized semaphore (and deallocates if dynamic).
+ * 
+ * @param[in] handle The semaphore to delete.
+ */
+void libos_semaphore_delete(libos_semaphore_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_CONCURRENT_SEMAPHORE_H
@@ -0,0 +1,330 @@
+/**
+ * @file spsc_ring.h
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ * 
+ * @details
+ * This header provides a bounded ring buffer of fixed size elements that
+ * can be shared between exactly one producer and exactly one consumer
+ * without any lock. Only atomic loads and stores are used, so this can be
+ * used to move data from a interrupt service routine to a task, or between
+ * two tasks, without the cost of a mutex per element. When there is more
+ * than one producer or more than one consumer, the accesses of those have to
+ * be serialized by the user (for example with a mutex).
+ * 
+ * The ring does not allocate any memory. The storage of the elements is
+ * provided by the user, this can be done with the
+ * LIBOS_SPSC_RING_STATIC_DATA_STRUCT and LIBOS_SPSC_RING_CREATE_STATIC macros
+ * (in the same style as the mutex) or by calling libos_spsc_ring_init with a
+ * user provided buffer. The capacity has to be a power of two, such that the
+ * wrap around of the indices is a simple mask.
+ * 
+ * The producer and consumer indices are placed in their own cache line
+ * (see LIBOS_CACHE_LINE_SIZE) to prevent false sharing between the producer
+ * and consumer cores. Each side also keeps a cached copy of the index of the
+ * other side, which means that the index of the other side is only read when
+ * the ring looks full (producer) or empty (consumer).
+ * 
+ * Example:
+ * @code{.c}
+ * static LIBOS_SPSC_RING_STATIC_DATA_STRUCT(sample_data, uint16_t, 64);
+ * static libos_spsc_ring_t samples;
+ * 
+ * void init(void) {
+ *   LIBOS_SPSC_RING_CREATE_STATIC(sample_data, samples);
+ * }
+ * 
+ * void isr(void) {
+ *   uint16_t sample = read_adc();
+ *   (void)libos_spsc_ring_push(&samples, &sample);
+ * }
+ * 
+ * void task(void) {
+ *   uint16_t buffer[16];
+ *   size_t count = libos_spsc_ring_pop_n(&samples, buffer, 16);
+ *   // process count samples
+ * }
+ * @endcode
+ * 
+ * The implementation is fully in this header, and only depends on the
+ * platform for the error codes and atomics.
+ */
+
+#pragma once
+#ifndef LIBOS_CONCURRENT_SPSC_RING_H
+#define LIBOS_CONCURRENT_SPSC_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "libos/error.h"
+#include "libos/concurrent/atomic.h"
+
+#ifndef LIBOS_CACHE_LINE_SIZE
+
+/**
+ * @brief The size (in bytes) of a cache line, used to prevent false sharing.
+ * 
+ * @details
+ * The platform or application can define it (as a command line symbol) to
+ * the actual size of the target. Too large only wastes a bit of memory, too
+ * small can have a big performance impact.
+ */
+#define LIBOS_CACHE_LINE_SIZE 64
+#endif // LIBOS_CACHE_LINE_SIZE
+
+#ifdef __cplusplus
+#define LIBOS_SPSC_RING_ALIGNED_ alignas(LIBOS_CACHE_LINE_SIZE)
+#else // __cplusplus
+#define LIBOS_SPSC_RING_ALIGNED_ _Alignas(LIBOS_CACHE_LINE_SIZE)
+#endif // __cplusplus
+
+/**
+ * @brief The ring buffer control structure.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly. The indices are free running counters, the position in the
+ * buffer is the index masked with the capacity.
+ */
+typedef struct {
+    LIBOS_SPSC_RING_ALIGNED_ libos_atomic_size_t head;  ///< Written by the producer only.
+    size_t cached_tail;                                 ///< Producer's copy of the tail.
+    LIBOS_SPSC_RING_ALIGNED_ libos_atomic_size_t tail;  ///< Written by the consumer only.
+    size_t cached_head;                                 ///< Consumer's copy of the head.
+    LIBOS_SPSC_RING_ALIGNED_ uint8_t *buffer;           ///< The element storage.
+    size_t element_size;                                ///< The size of a single element in bytes.
+    size_t mask;                                        ///< The capacity minus one.
+} libos_spsc_ring_t;
+
+/**
+ * @def LIBOS_SPSC_RING_STATIC_DATA_STRUCT(name, element_type, capacity)
+ * @brief Define the storage for @ref capacity elements of @ref element_type with @ref name.
+ * 
+ * @details
+ * This can be used in a struct, or as a global or local variable. The ring
+ * itself is a separate libos_spsc_ring_t variable that is initialized with
+ * LIBOS_SPSC_RING_CREATE_STATIC.
+ * 
+ * @param[in] name The name of the storage variable.
+ * @param[in] element_type The type of the elements in the ring.
+ * @param[in] capacity The number of elements the ring can hold (must be a power of two).
+ */
+#define LIBOS_SPSC_RING_STATIC_DATA_STRUCT(name, element_type, capacity) element_type name[(capacity)]
+
+/**
+ * @def LIBOS_SPSC_RING_CREATE_STATIC(static_data_name, ring)
+ * @brief Initializes the ring with the storage defined by LIBOS_SPSC_RING_STATIC_DATA_STRUCT.
+ * 
+ * @details
+ * The parameter are names for the variables, they are NOT pointers yet.
+ * 
+ * @param[in] static_data_name The name of of the variable for the storage.
+ * @param[in] ring The name of the libos_spsc_ring_t variable to initialize.
+ * 
+ * @return libos_err_t The result of libos_spsc_ring_init.
+ */
+#define LIBOS_SPSC_RING_CREATE_STATIC(static_data_name, ring) libos_spsc_ring_init(&(ring), (static_data_name), sizeof((static_data_name)[0]), sizeof(static_data_name) / sizeof((static_data_name)[0]))
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initializes the ring with the given storage.
+ * 
+ * @details
+ * The ring starts empty. This is not thread safe, the ring can only be used
+ * by the producer and consumer after the initialization is done.
+ * 
+ * @param[out] ring The ring to initialize.
+ * @param[in] storage The memory for the elements, at least element_size * capacity bytes.
+ * @param[in] element_size The size of a single element in bytes.
+ * @param[in] capacity The number of elements, must be a power of two.
+ * 
+ * @retval LIBOS_ERR_OK The ring is initialized.
+ * @retval LIBOS_ERR_INVALID_ARG @ref ring or @ref storage is NULL, @ref element_size is 0 or @ref capacity is not a power of two.
+ * 
+ * @return libos_err_t The libos standard success code for initializing the ring.
+ */
+static inline libos_err_t libos_spsc_ring_init(libos_spsc_ring_t *ring, void *storage, size_t element_size, size_t capacity)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(ring);
+    LIBOS_ERR_RET_ARG_NOT_NULL(storage);
+    LIBOS_ERR_RET_ON_TRUE(element_size == 0, LIBOS_ERR_INVALID_ARG);
+    LIBOS_ERR_RET_ON_TRUE(capacity == 0 || (capacity & (capacity - 1)) != 0, LIBOS_ERR_INVALID_ARG);
+
+    LIBOS_ATOMIC_INIT(&ring->head, 0);
+    LIBOS_ATOMIC_INIT(&ring->tail, 0);
+    ring->cached_tail = 0;
+    ring->cached_head = 0;
+    ring->buffer = (uint8_t*)storage;
+    ring->element_size = element_size;
+    ring->mask = capacity - 1;
+    return LIBOS_ERR_OK;
+}
+
+/**
+ * @brief Returns the number of elements the ring can hold.
+ * 
+ * @param[in] ring The ring.
+ * 
+ * @return size_t The capacity of the ring.
+ */
+static inline size_t libos_spsc_ring_capacity(const libos_spsc_ring_t *ring)
+{
+    return ring->mask + 1;
+}
+
+/**
+ * @brief Returns the number of elements in the ring.
+ * 
+ * @details
+ * This can be called from either side, but when called while the other side
+ * is active the result is only a snapshot.
+ * 
+ * @param[in] ring The ring.
+ * 
+ * @return size_t The number of elements that are ready to be popped.
+ */
+static inline size_t libos_spsc_ring_size(libos_spsc_ring_t *ring)
+{
+    size_t tail = LIBOS_ATOMIC_LOAD(&ring->tail, LIBOS_ATOMIC_ACQUIRE);
+    size_t head = LIBOS_ATOMIC_LOAD(&ring->head, LIBOS_ATOMIC_ACQUIRE);
+    return head - tail;
+}
+
+// Copies count elements between the ring position and the linear memory, handling the wrap around of the ring.
+static inline void libos_spsc_ring_copy_(libos_spsc_ring_t *ring, size_t index, uint8_t *linear, size_t count, bool to_ring)
+{
+    size_t offset = index & ring->mask;
+    size_t first = ring->mask + 1 - offset;
+    if (first > count)
+    {
+        first = count;
+    }
+
+    uint8_t *slot = ring->buffer + (offset * ring->element_size);
+    size_t first_bytes = first * ring->element_size;
+    size_t second_bytes = (count - first) * ring->element_size;
+    if (to_ring)
+    {
+        memcpy(slot, linear, first_bytes);
+        memcpy(ring->buffer, linear + first_bytes, second_bytes);
+    }
+    else
+    {
+        memcpy(linear, slot, first_bytes);
+        memcpy(linear + first_bytes, ring->buffer, second_bytes);
+    }
+}
+
+/**
+ * @brief Pushes up to @ref count elements in the ring (producer only).
+ * 
+ * @details
+ * The elements are copied as at most 2 contiguous spans (before and after
+ * the wrap around). The elements become visible to the consumer all at once.
+ * 
+ * @param[in] ring The ring to push to.
+ * @param[in] elements Pointer to @ref count consecutive elements.
+ * @param[in] count The number of elements to push.
+ * 
+ * @return size_t The number of elements that are pushed, less than @ref count if the ring got full.
+ */
+static inline size_t libos_spsc_ring_push_n(libos_spsc_ring_t *ring, const void *elements, size_t count)
+{
+    size_t head = LIBOS_ATOMIC_LOAD(&ring->head, LIBOS_ATOMIC_RELAXED);
+    size_t capacity = ring->mask + 1;
+    size_t free_slots = capacity - (head - ring->cached_tail);
+    if (free_slots < count)
+    {
+        ring->cached_tail = LIBOS_ATOMIC_LOAD(&ring->tail, LIBOS_ATOMIC_ACQUIRE);
+        free_slots = capacity - (head - ring->cached_tail);
+    }
+
+    if (count > free_slots)
+    {
+        count = free_slots;
+    }
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    libos_spsc_ring_copy_(ring, head, (uint8_t*)elements, count, true);
+    LIBOS_ATOMIC_STORE(&ring->head, head + count, LIBOS_ATOMIC_RELEASE);
+    return count;
+}
+
+/**
+ * @brief Pops up to @ref count elements from the ring (consumer only).
+ * 
+ * @details
+ * The elements are copied as at most 2 contiguous spans (before and after
+ * the wrap around). The slots are given back to the producer all at once.
+ * 
+ * @param[in] ring The ring to pop from.
+ * @param[out] elements Pointer to the memory for @ref count consecutive elements.
+ * @param[in] count The maximum number of elements to pop.
+ * 
+ * @return size_t The number of elements that are popped, less than @ref count if the ring got empty.
+ */
+static inline size_t libos_spsc_ring_pop_n(libos_spsc_ring_t *ring, void *elements, size_t count)
+{
+    size_t tail = LIBOS_ATOMIC_LOAD(&ring->tail, LIBOS_ATOMIC_RELAXED);
+    size_t available = ring->cached_head - tail;
+    if (available < count)
+    {
+        ring->cached_head = LIBOS_ATOMIC_LOAD(&ring->head, LIBOS_ATOMIC_ACQUIRE);
+        available = ring->cached_head - tail;
+    }
+
+    if (count > available)
+    {
+        count = available;
+    }
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    libos_spsc_ring_copy_(ring, tail, (uint8_t*)elements, count, false);
+    LIBOS_ATOMIC_STORE(&ring->tail, tail + count, LIBOS_ATOMIC_RELEASE);
+    return count;
+}
+
+/**
+ * @brief Pushes a single element in the ring (producer only).
+ * 
+ * @param[in] ring The ring to push to.
+ * @param[in] element Pointer to the element to copy in the ring.
+ * 
+ * @retval true The element is pushed.
+ * @retval false The ring is full.
+ */
+static inline bool libos_spsc_ring_push(libos_spsc_ring_t *ring, const void *element)
+{
+    return libos_spsc_ring_push_n(ring, element, 1) == 1;
+}
+
+/**
+ * @brief Pops a single element from the ring (consumer only).
+ * 
+ * @param[in] ring The ring to pop from.
+ * @param[out] element Pointer to the memory to copy the element to.
+ * 
+ * @retval true A element is popped.
+ * @retval false The ring is empty.
+ */
+static inline bool libos_spsc_ring_pop(libos_spsc_ring_t *ring, void *element)
+{
+    return libos_spsc_ring_pop_n(ring, element, 1) == 1;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_CONCURRENT_SPSC_RING_H
@@ -0,0 +1,332 @@
+/**
+ * @file thread.h
+ * @brief Abstract API for creating and joining threads (tasks).
+ * 
+ * @details
+ * This header provides the API to create a system native thread, with a
+ * name, stack size, priority and the core it runs on, and to wait for it to
+ * finish. Placing threads on a specific core keeps hot threads from
+ * thrashing each other's caches, and keeps them away from cores that are
+ * busy with something else.
+ * 
+ * The API is shaped like the mutex API (see libos/concurrent/mutex.h). If the
+ * platform supports it, static and dynamic allocations are supported. A
+ * static thread uses a control block and stack provided by the caller, see
+ * LIBOS_THREAD_STATIC_DATA_STRUCT. A dynamic thread allocates both.
+ * 
+ * Every thread has to be joined with libos_thread_join, which also releases
+ * the resources of the thread. The function of a thread returns to end it,
+ * a thread can't be stopped from the outside.
+ * 
+ * @code{.c}
+ * static LIBOS_THREAD_STATIC_DATA_STRUCT(sampler_thread, 4096);
+ * 
+ * libos_thread_config_t config = LIBOS_THREAD_CONFIG_DEFAULT("sampler");
+ * config.core = 1;
+ * libos_thread_handle_t handle;
+ * 
+ * if (LIBOS_THREAD_CREATE_PREFER_STATIC(sampler_thread, handle, &config, sampler_run, NULL) != LIBOS_ERR_OK)
+ * {
+ *   // Do stuff
+ * }
+ * @endcode
+ * 
+ * 
+ * IMPLEMENTORS:
+ * For the implementor it is required to provide a
+ * libos/platform/concurrent/thread.h header. This header has to provide the
+ * following types:
+ * * libos_thread_handle_t
+ * * libos_thread_t (optional)
+ * 
+ * The libos_thread_handle_t is a type that refers to a thread in the system.
+ * This is often a pointer but is not required to be one. The libos_thread_t
+ * type is the control block of the thread, and only required if the platform
+ * supports static allocations of threads.
+ * 
+ * The header implementation can provide the
+ * LIBOS_THREAD_ENABLE_STATIC_ALLOCATION and
+ * LIBOS_THREAD_ENABLE_DYNAMIC_ALLOCATION macros. They follow the same rules
+ * as the LIBOS_MUTEX_ENABLE_* variants. If the header doesn't define them, they
+ * will default to the value of the mutex variant. A implementation must at
+ * least provide 1 initialization method.
+ * 
+ * The priorities are integers from LIBOS_THREAD_PRIORITY_MIN to
+ * LIBOS_THREAD_PRIORITY_MAX, a higher number is more urgent. The platform
+ * defines the range and LIBOS_THREAD_PRIORITY_DEFAULT, and maps it to its
+ * own priorities. A platform without priorities (like the default scheduler
+ * of POSIX) can leave them out, so all three are 0.
+ * 
+ * The platform can define LIBOS_THREAD_STACK_DEFINE if its stack has to have
+ * a specific type or alignment, and LIBOS_THREAD_STACK_SIZE_DEFAULT and
+ * LIBOS_THREAD_STACK_SIZE_MIN for its stack sizes. The stack size given to
+ * the creation functions is in bytes.
+ * 
+ * A thread with a core other than LIBOS_THREAD_CORE_ANY is only ever run on
+ * that core. When the platform can't pin a thread to a core, the creation
+ * has to fail with LIBOS_ERR_NOTSUP, rather than silently running the thread
+ * anywhere.
+ * 
+ * If the platform provides library functions they should be enclosed
+ * in a extern "C" block like:
+ * 
+ * @code
+ * #ifdef __cplusplus
+ * extern "C" {
+ * #endif // __cplusplus
+ * 
+ * // Functions
+ * 
+ * #ifdef __cplusplus
+ * }
+ * #endif // __cplusplus
+ * 
+ * @endcode
+ * 
+ * Or, if it does not have a block, each function should be marked as
+ * @code
+ * extern "C"
+ * @endcode
+ * . The general API header for the thread places all the functions in a
+ * extern "C" code block.
+ */
+
+#pragma once
+#ifndef LIBOS_CONCURRENT_THREAD_H
+#define LIBOS_CONCURRENT_THREAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "libos/error.h"
+#include "libos/concurrent/mutex.h"
+
+#include "libos/platform/concurrent/thread.h"
+
+#ifndef LIBOS_THREAD_ENABLE_STATIC_ALLOCATION
+#define LIBOS_THREAD_ENABLE_STATIC_ALLOCATION LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION
+#endif // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION
+
+#ifndef LIBOS_THREAD_ENABLE_DYNAMIC_ALLOCATION
+#define LIBOS_THREAD_ENABLE_DYNAMIC_ALLOCATION LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION
+#endif // LIBOS_THREAD_ENABLE_DYNAMIC_ALLOCATION
+
+#if LIBOS_THREAD_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_THREAD_ENABLE_STATIC_ALLOCATION!=1
+#error "The platform doesn't provide either a static or dynamic initialization method for threads."
+#endif // LIBOS_THREAD_ENABLE_DYNAMIC_ALLOCATION!=1 && LIBOS_THREAD_ENABLE_STATIC_ALLOCATION!=1
+
+#ifndef LIBOS_THREAD_PRIORITY_MIN
+#define LIBOS_THREAD_PRIORITY_MIN 0
+#endif // LIBOS_THREAD_PRIORITY_MIN
+
+#ifndef LIBOS_THREAD_PRIORITY_MAX
+#define LIBOS_THREAD_PRIORITY_MAX 0
+#endif // LIBOS_THREAD_PRIORITY_MAX
+
+#ifndef LIBOS_THREAD_PRIORITY_DEFAULT
+#define LIBOS_THREAD_PRIORITY_DEFAULT LIBOS_THREAD_PRIORITY_MIN
+#endif // LIBOS_THREAD_PRIORITY_DEFAULT
+
+/**
+ * @brief The stack size in bytes used by LIBOS_THREAD_CONFIG_DEFAULT.
+ */
+#ifndef LIBOS_THREAD_STACK_SIZE_DEFAULT
+#define LIBOS_THREAD_STACK_SIZE_DEFAULT 4096
+#endif // LIBOS_THREAD_STACK_SIZE_DEFAULT
+
+/**
+ * @brief The smallest stack size in bytes the platform accepts.
+ */
+#ifndef LIBOS_THREAD_STACK_SIZE_MIN
+#define LIBOS_THREAD_STACK_SIZE_MIN 1024
+#endif // LIBOS_THREAD_STACK_SIZE_MIN
+
+/**
+ * @brief The core of a thread that can run on any core.
+ */
+#define LIBOS_THREAD_CORE_ANY (-1)
+
+/**
+ * @brief Defines a stack for a static thread of @ref size bytes.
+ * 
+ * @param name The name of the array.
+ * @param size The size in bytes.
+ */
+#ifndef LIBOS_THREAD_STACK_DEFINE
+#ifdef __cplusplus
+#define LIBOS_THREAD_STACK_DEFINE(name, size) alignas(16) uint8_t name[(size)]
+#else // __cplusplus
+#define LIBOS_THREAD_STACK_DEFINE(name, size) _Alignas(16) uint8_t name[(size)]
+#endif // __cplusplus
+#endif // LIBOS_THREAD_STACK_DEFINE
+
+/**
+ * @brief The function a thread runs, the thread ends when it returns.
+ */
+typedef void (*libos_thread_fn_t)(void *arg);
+
+/**
+ * @brief The properties of a new thread.
+ */
+typedef struct libos_thread_config_s
+{
+    /**
+     * @brief The name of the thread for debugging, can be truncated by the platform.
+     */
+    const char *name;
+    /**
+     * @brief The stack size in bytes, only used by a dynamic thread.
+     */
+    size_t stack_size;
+    /**
+     * @brief The priority, from LIBOS_THREAD_PRIORITY_MIN to LIBOS_THREAD_PRIORITY_MAX.
+     */
+    int priority;
+    /**
+     * @brief The core the thread runs on, from 0 to libos_thread_get_core_count() - 1, or LIBOS_THREAD_CORE_ANY.
+     */
+    int core;
+} libos_thread_config_t;
+
+/**
+ * @brief The initializer of a libos_thread_config_t with the default stack size and priority, on any core.
+ * 
+ * @param thread_name The name of the thread.
+ */
+#define LIBOS_THREAD_CONFIG_DEFAULT(thread_name) { (thread_name), LIBOS_THREAD_STACK_SIZE_DEFAULT, LIBOS_THREAD_PRIORITY_DEFAULT, LIBOS_THREAD_CORE_ANY }
+
+/**
+ * @def LIBOS_THREAD_STATIC_DATA_STRUCT(name, stack_size)
+ * @brief Define a variable with the control block and a stack of @ref stack_size bytes if static allocation is supported.
+ * 
+ * @param[in] name The name of of the variable if defined.
+ * @param[in] stack_size The size of the stack in bytes.
+ */
+
+#if LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_THREAD_STATIC_DATA_STRUCT(name, stack_size) struct { libos_thread_t thread; LIBOS_THREAD_STACK_DEFINE(stack, stack_size); } name
+#else // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+// Don't define struct
+#define LIBOS_THREAD_STATIC_DATA_STRUCT(static_data_name, stack_size)
+#endif // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @def LIBOS_THREAD_CREATE_PREFER_STATIC(static_data_name, handle, config, fn, arg)
+ * @brief Call libos_thread_create_static if static allocation is supported, otherwise call libos_thread_create_dynamic.
+ * 
+ * @details
+ * Conditional implementation for when static allocation is supported or not.
+ * The static data and handle parameters are names for the variables, they
+ * are NOT pointers yet. A static thread uses the stack of the static data,
+ * a dynamic thread the stack_size of @ref config.
+ * 
+ * Example:
+ * @code{.c}
+ * LIBOS_THREAD_STATIC_DATA_STRUCT(static_thread, 4096);
+ * libos_thread_config_t config = LIBOS_THREAD_CONFIG_DEFAULT("worker");
+ * libos_thread_handle_t handle;
+ * 
+ * if (LIBOS_THREAD_CREATE_PREFER_STATIC(static_thread, handle, &config, worker_run, NULL) != LIBOS_ERR_OK)
+ * {
+ *   // Do stuff
+ * }
+ * @endcode
+ * 
+ * 
+ * @param[in] static_data_name The name of of the variable for the static data struct.
+ * @param[in] handle The name of the variable to place the resulting handle in.
+ * @param[in] config Pointer to the properties of the thread.
+ * @param[in] fn The function the thread runs.
+ * @param[in] arg The argument passed to @ref fn.
+ */
+#if LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_THREAD_CREATE_PREFER_STATIC(static_data_name, handle, config, fn, arg) \
+    libos_thread_create_static(&(static_data_name).thread, (static_data_name).stack, sizeof((static_data_name).stack), &(handle), (config), (fn), (arg))
+#else // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_THREAD_CREATE_PREFER_STATIC(static_data_name, handle, config, fn, arg) libos_thread_create_dynamic(&(handle), (config), (fn), (arg))
+#endif // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#if LIBOS_THREAD_ENABLE_DYNAMIC_ALLOCATION==1
+
+/**
+ * @brief Allocate the control block and stack of a new thread and start it.
+ * 
+ * @param[out] handle The handle to the new thread.
+ * @param[in] config The properties of the thread.
+ * @param[in] fn The function the thread runs.
+ * @param[in] arg The argument passed to @ref fn.
+ * 
+ * @retval LIBOS_ERR_OK The thread is successfully started.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle, @ref config or @ref fn is NULL, or a property is out of range.
+ * @retval LIBOS_ERR_NOTSUP The platform can't pin the thread to the requested core.
+ * @retval LIBOS_ERR_NO_MEM Failed to allocate memory for the thread.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for creating the thread.
+ */
+libos_err_t libos_thread_create_dynamic(libos_thread_handle_t *handle, const libos_thread_config_t *config, libos_thread_fn_t fn, void *arg);
+
+#endif // LIBOS_THREAD_ENABLE_DYNAMIC_ALLOCATION==1
+
+#if LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @brief Starts a thread on the given control block and stack.
+ * 
+ * @param[in] thread The control block of the thread.
+ * @param[in] stack The stack of the thread, see LIBOS_THREAD_STACK_DEFINE.
+ * @param[in] stack_size The size of @ref stack in bytes, at least LIBOS_THREAD_STACK_SIZE_MIN.
+ * @param[out] handle The handle to the thread.
+ * @param[in] config The properties of the thread, the stack_size is ignored.
+ * @param[in] fn The function the thread runs.
+ * @param[in] arg The argument passed to @ref fn.
+ * 
+ * @retval LIBOS_ERR_OK The thread is successfully started.
+ * @retval LIBOS_ERR_INVALID_ARG A pointer is NULL, or a property is out of range.
+ * @retval LIBOS_ERR_NOTSUP The platform can't pin the thread to the requested core.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for creating the thread.
+ */
+libos_err_t libos_thread_create_static(libos_thread_t *thread, void *stack, size_t stack_size, libos_thread_handle_t *handle, const libos_thread_config_t *config, libos_thread_fn_t fn, void *arg);
+
+#endif // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @brief Waits until the thread returned from its function, and releases it (and deallocates if dynamic).
+ * 
+ * @details
+ * Every thread has to be joined exactly once, and not by itself.
+ * 
+ * @param[in] handle The thread to wait for.
+ * 
+ * @retval LIBOS_ERR_OK The thread ended and is released.
+ * @retval LIBOS_ERR_INVALID_ARG @ref handle is NULL.
+ * @retval LIBOS_ERR_INVALID_STATE The thread is the calling thread.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for joining the thread.
+ */
+libos_err_t libos_thread_join(libos_thread_handle_t handle);
+
+/**
+ * @brief Gives the remainder of the time slice to another thread that is ready to run.
+ */
+void libos_thread_yield(void);
+
+/**
+ * @brief Returns the number of cores a thread can be pinned to.
+ * 
+ * @return int The number of cores, at least 1.
+ */
+int libos_thread_get_core_count(void);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_CONCURRENT_THREAD_H
@@ -0,0 +1,453 @@
+/**
+ * @file wait_address.h
+ * @brief Futex style waiting for a 32-bit word to change.
+ * 
+ * @details
+ * This header provides a pair of functions to block on a 32-bit atomic word
+ * without a mutex or semaphore per object. libos_wait_on_address sleeps as
+ * long as the word holds the expected value, libos_wake_address wakes up
+ * tasks that are sleeping on the word. The word itself is owned by the user,
+ * this makes it possible to build lock-free structures that cost no system
+ * call at all when uncontended and only sleep when they have to:
+ * 
+ * @code{.c}
+ * static libos_atomic_uint32_t ready;
+ * 
+ * void consumer(void) {
+ *   while (LIBOS_ATOMIC_LOAD(&ready, LIBOS_ATOMIC_ACQUIRE) == 0)
+ *   {
+ *     (void)libos_wait_on_address(&ready, 0, libos_time_from_ms(100));
+ *   }
+ * }
+ * 
+ * void producer(void) {
+ *   LIBOS_ATOMIC_STORE(&ready, 1, LIBOS_ATOMIC_RELEASE);
+ *   (void)libos_wake_address(&ready, LIBOS_WAKE_ADDRESS_ALL);
+ * }
+ * @endcode
+ * 
+ * Just like a futex, the wait can return without a wake (or a change of the
+ * word), so the caller always rechecks the word in a loop. A wake only
+ * reaches the tasks that are already waiting, it is not stored.
+ * 
+ * There are two implementations, selected with
+ * LIBOS_WAIT_ADDRESS_ENABLE_NATIVE:
+ * 
+ *  * Native (1): the platform implements both functions on top of a native
+ *    primitive, like the futex system call on Linux.
+ *  * Generic (0, the default): a hashed wait queue in this header, built on
+ *    the libos mutex (see libos/concurrent/mutex.h) and condition variable
+ *    (see libos/concurrent/condvar.h). The addresses are hashed to
+ *    LIBOS_WAIT_ADDRESS_BUCKETS buckets, each with a mutex, a condition
+ *    variable and a list of the waiters. The storage has to be defined with
+ *    LIBOS_WAIT_ADDRESS_DEFINE in exactly one source file, and
+ *    libos_wait_address_init has to be called before the first wait.
+ * 
+ * In both cases the application does the LIBOS_WAIT_ADDRESS_DEFINE and the
+ * libos_wait_address_init call, so it doesn't have to know which one is
+ * used.
+ * 
+ * 
+ * IMPLEMENTORS:
+ * A platform with a native primitive provides a
+ * libos/platform/concurrent/wait_address.h header and implements
+ * libos_wait_on_address and libos_wake_address with the semantics described
+ * below. On Linux this maps directly to the futex system call:
+ * 
+ * @code{.c}
+ * libos_err_t libos_wait_on_address(libos_atomic_uint32_t *address, uint32_t expected, libos_time_t timeout)
+ * {
+ *   struct timespec ts = { ... from libos_time_to_ns(timeout) ... };
+ *   if (syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, &ts, NULL, 0) == 0)
+ *   {
+ *     return LIBOS_ERR_OK;
+ *   }
+ *   // EAGAIN (the word differs) and EINTR are reported as a normal wake up.
+ *   return (errno == ETIMEDOUT) ? LIBOS_ERR_TIMEOUT : (errno == EAGAIN || errno == EINTR) ? LIBOS_ERR_OK : LIBOS_ERR_FAIL;
+ * }
+ * 
+ * libos_err_t libos_wake_address(libos_atomic_uint32_t *address, uint32_t count)
+ * {
+ *   return (syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, (count > INT_MAX) ? INT_MAX : count, NULL, NULL, 0) >= 0) ? LIBOS_ERR_OK : LIBOS_ERR_FAIL;
+ * }
+ * @endcode
+ * 
+ * A RTOS port without a native primitive uses the generic implementation.
+ * If the platform header provides library functions they should be enclosed
+ * in a extern "C" block, like the other platform headers.
+ */
+
+#pragma once
+#ifndef LIBOS_CONCURRENT_WAIT_ADDRESS_H
+#define LIBOS_CONCURRENT_WAIT_ADDRESS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "libos/error.h"
+#include "libos/time.h"
+#include "libos/concurrent/atomic.h"
+
+#ifndef LIBOS_WAIT_ADDRESS_ENABLE_NATIVE
+#define LIBOS_WAIT_ADDRESS_ENABLE_NATIVE 0
+#endif // LIBOS_WAIT_ADDRESS_ENABLE_NATIVE
+
+/**
+ * @brief The count to give to libos_wake_address to wake up all the waiters.
+ */
+#define LIBOS_WAKE_ADDRESS_ALL UINT32_MAX
+
+#if LIBOS_WAIT_ADDRESS_ENABLE_NATIVE==1
+
+#include "libos/platform/concurrent/wait_address.h"
+
+// The platform has no storage to define.
+#define LIBOS_WAIT_ADDRESS_DEFINE() extern int libos_wait_address_native_
+
+#else // LIBOS_WAIT_ADDRESS_ENABLE_NATIVE==1
+
+#include "libos/concurrent/mutex.h"
+#include "libos/concurrent/condvar.h"
+
+/**
+ * @brief The number of buckets of the generic implementation (a power of two).
+ * 
+ * @details
+ * Waiters on different addresses that hash to the same bucket share the
+ * bucket mutex and condition variable, more buckets means less false
+ * sharing at the cost of a mutex and condition variable per bucket.
+ */
+#ifndef LIBOS_WAIT_ADDRESS_BUCKETS
+#define LIBOS_WAIT_ADDRESS_BUCKETS 16
+#endif // LIBOS_WAIT_ADDRESS_BUCKETS
+
+#if (LIBOS_WAIT_ADDRESS_BUCKETS & (LIBOS_WAIT_ADDRESS_BUCKETS - 1)) != 0
+#error "LIBOS_WAIT_ADDRESS_BUCKETS has to be a power of two."
+#endif // (LIBOS_WAIT_ADDRESS_BUCKETS & (LIBOS_WAIT_ADDRESS_BUCKETS - 1)) != 0
+
+/**
+ * @brief The time (in milliseconds) libos_wake_address waits for a bucket lock.
+ * 
+ * @details
+ * The bucket locks are only held for a few instructions, this only guards
+ * against a broken platform.
+ */
+#ifndef LIBOS_WAIT_ADDRESS_LOCK_TIMEOUT_MS
+#define LIBOS_WAIT_ADDRESS_LOCK_TIMEOUT_MS 1000
+#endif // LIBOS_WAIT_ADDRESS_LOCK_TIMEOUT_MS
+
+/**
+ * @brief A task waiting in a bucket, one per thread.
+ * 
+ * @details
+ * The waiter is thread local instead of on the stack, so a waiter that is
+ * left in a bucket after a platform fault (see libos_wait_on_address) never
+ * points to a stack frame that is gone.
+ */
+typedef struct libos_wait_address_waiter_s
+{
+    const libos_atomic_uint32_t *address;       ///< The address that is waited on.
+    struct libos_wait_address_waiter_s *next;   ///< The next waiter in the bucket.
+    bool woken;                                 ///< Set (and unlinked) by libos_wake_address.
+    libos_atomic_uint32_t linked;               ///< 1 while the waiter is in a bucket list.
+} libos_wait_address_waiter_t;
+
+/**
+ * @brief A bucket of the hashed wait queue.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly.
+ */
+typedef struct
+{
+#if LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
+    libos_mutex_t mutex_data;               ///< The storage of the mutex.
+#endif // LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION==1
+    libos_mutex_handle_t mutex;             ///< Protects the waiter list.
+#if LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION==1
+    libos_condvar_t condvar_data;           ///< The storage of the condition variable.
+#endif // LIBOS_CONDVAR_ENABLE_STATIC_ALLOCATION==1
+    libos_condvar_handle_t condvar;         ///< Broadcasted when a waiter in the bucket is woken.
+    libos_wait_address_waiter_t *waiters;   ///< The waiters, the most recent first.
+} libos_wait_address_bucket_t;
+
+/**
+ * @brief Defines the buckets and the waiters, has to be used in exactly one source file at file scope.
+ */
+#define LIBOS_WAIT_ADDRESS_DEFINE() \
+    libos_wait_address_bucket_t libos_wait_address_buckets_[LIBOS_WAIT_ADDRESS_BUCKETS]; \
+    LIBOS_THREAD_LOCAL libos_wait_address_waiter_t libos_wait_address_waiter_
+
+#endif // LIBOS_WAIT_ADDRESS_ENABLE_NATIVE==1
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#if LIBOS_WAIT_ADDRESS_ENABLE_NATIVE==1
+
+/**
+ * @brief Waits as long as the word at @ref address holds @ref expected, within the given time.
+ * 
+ * @details
+ * The check of the word and the start of the wait are atomic with respect
+ * to libos_wake_address. So a task that changes the word and then wakes the
+ * address never misses a waiter. The function can return LIBOS_ERR_OK
+ * without a wake, the caller has to recheck the word.
+ * 
+ * @param[in] address The word to wait on.
+ * @param[in] expected The value to sleep on, returns directly if the word differs.
+ * @param[in] timeout The time (in platform ticks) to wait.
+ * 
+ * @retval LIBOS_ERR_OK The task is woken up, or the word didn't hold @ref expected.
+ * @retval LIBOS_ERR_INVALID_ARG @ref address is NULL.
+ * @retval LIBOS_ERR_TIMEOUT The task is not woken up before the end of the timeout.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for waiting on the address.
+ */
+libos_err_t libos_wait_on_address(libos_atomic_uint32_t *address, uint32_t expected, libos_time_t timeout);
+
+/**
+ * @brief Wakes up to @ref count tasks waiting on @ref address.
+ * 
+ * @param[in] address The word the tasks are waiting on.
+ * @param[in] count The maximum number of tasks to wake, LIBOS_WAKE_ADDRESS_ALL for all of them.
+ * 
+ * @retval LIBOS_ERR_OK The waiters (if any) are woken up.
+ * @retval LIBOS_ERR_INVALID_ARG @ref address is NULL.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for waking the address.
+ */
+libos_err_t libos_wake_address(libos_atomic_uint32_t *address, uint32_t count);
+
+/**
+ * @brief Initializes the wait queues, nothing to do for a native implementation.
+ * 
+ * @return libos_err_t Always LIBOS_ERR_OK.
+ */
+static inline libos_err_t libos_wait_address_init(void)
+{
+    return LIBOS_ERR_OK;
+}
+
+#else // LIBOS_WAIT_ADDRESS_ENABLE_NATIVE==1
+
+extern libos_wait_address_bucket_t libos_wait_address_buckets_[LIBOS_WAIT_ADDRESS_BUCKETS];
+extern LIBOS_THREAD_LOCAL libos_wait_address_waiter_t libos_wait_address_waiter_;
+
+// Selects the bucket of the address, a multiplicative (Fibonacci) hash of the word index.
+static inline libos_wait_address_bucket_t *libos_wait_address_bucket_(const libos_atomic_uint32_t *address)
+{
+    uint32_t hash = (uint32_t)((uintptr_t)address / sizeof(uint32_t)) * UINT32_C(2654435761);
+    return &libos_wait_address_buckets_[(hash >> 16) & (LIBOS_WAIT_ADDRESS_BUCKETS - 1)];
+}
+
+/**
+ * @brief Creates the mutex and condition variable of each bucket.
+ * 
+ * @details
+ * Has to be called once before the first wait or wake, for example at the
+ * start of the application. This is not thread safe.
+ * 
+ * @retval LIBOS_ERR_OK The buckets are initialized.
+ * @retval LIBOS_ERR_NO_MEM Failed to allocate a mutex or condition variable (dynamic allocation only).
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for initializing the wait queues.
+ */
+static inline libos_err_t libos_wait_address_init(void)
+{
+    size_t created = 0;
+    libos_err_t err = LIBOS_ERR_OK;
+    while (created < LIBOS_WAIT_ADDRESS_BUCKETS)
+    {
+        libos_wait_address_bucket_t *bucket = &libos_wait_address_buckets_[created];
+        err = LIBOS_MUTEX_CREATE_PREFER_STATIC(bucket->mutex_data, bucket->mutex);
+        if (err != LIBOS_ERR_OK)
+        {
+            break;
+        }
+        err = LIBOS_CONDVAR_CREATE_PREFER_STATIC(bucket->condvar_data, bucket->condvar);
+        if (err != LIBOS_ERR_OK)
+        {
+            libos_mutex_delete(bucket->mutex);
+            break;
+        }
+        bucket->waiters = NULL;
+        created++;
+    }
+
+    if (err != LIBOS_ERR_OK)
+    {
+        // Don't leak the buckets that were already created.
+        while (created > 0)
+        {
+            created--;
+            libos_condvar_delete(libos_wait_address_buckets_[created].condvar);
+            libos_mutex_delete(libos_wait_address_buckets_[created].mutex);
+        }
+    }
+    return err;
+}
+
+/**
+ * @brief Waits as long as the word at @ref address holds @ref expected, within the given time.
+ * 
+ * @details
+ * The check of the word and the start of the wait are atomic with respect
+ * to libos_wake_address. So a task that changes the word and then wakes the
+ * address never misses a waiter. The function can return LIBOS_ERR_OK
+ * without a wake, the caller has to recheck the word.
+ * 
+ * The generic implementation only returns when woken by libos_wake_address
+ * (or on the timeout), a broadcast for a different address in the same
+ * bucket puts the task back to sleep.
+ * 
+ * When the condition variable wait fails, it is unspecified if the bucket
+ * mutex is held (see libos_condvar_wait). The function then returns
+ * LIBOS_ERR_FAIL without touching the bucket: the waiter of the thread stays
+ * in the bucket until a wake of the address removes it, and until then the
+ * next wait of the thread returns LIBOS_ERR_INVALID_STATE.
+ * 
+ * @param[in] address The word to wait on.
+ * @param[in] expected The value to sleep on, returns directly if the word differs.
+ * @param[in] timeout The time (in platform ticks) to wait.
+ * 
+ * @retval LIBOS_ERR_OK The task is woken up, or the word didn't hold @ref expected.
+ * @retval LIBOS_ERR_INVALID_ARG @ref address is NULL.
+ * @retval LIBOS_ERR_INVALID_STATE A earlier wait of the thread failed and its waiter is still queued.
+ * @retval LIBOS_ERR_TIMEOUT The task is not woken up before the end of the timeout.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for waiting on the address.
+ */
+static inline libos_err_t libos_wait_on_address(libos_atomic_uint32_t *address, uint32_t expected, libos_time_t timeout)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(address);
+    libos_wait_address_waiter_t *waiter = &libos_wait_address_waiter_;
+    // Acquire, a waker that removed a left behind waiter is done with it.
+    LIBOS_ERR_RET_ON_TRUE(LIBOS_ATOMIC_LOAD(&waiter->linked, LIBOS_ATOMIC_ACQUIRE) != 0, LIBOS_ERR_INVALID_STATE);
+
+    libos_wait_address_bucket_t *bucket = libos_wait_address_bucket_(address);
+    const libos_time_t start = libos_time_get_now();
+    LIBOS_ERR_CHECK(libos_mutex_lock(bucket->mutex, timeout));
+
+    // Checked under the bucket lock, a waker changes the word before it takes the lock.
+    if (LIBOS_ATOMIC_LOAD(address, LIBOS_ATOMIC_SEQ_CST) != expected)
+    {
+        (void)libos_mutex_unlock(bucket->mutex);
+        return LIBOS_ERR_OK;
+    }
+
+    waiter->address = address;
+    waiter->next = bucket->waiters;
+    waiter->woken = false;
+    LIBOS_ATOMIC_STORE(&waiter->linked, 1, LIBOS_ATOMIC_RELAXED);
+    bucket->waiters = waiter;
+
+    libos_err_t err = LIBOS_ERR_OK;
+    while (!waiter->woken)
+    {
+        libos_time_t elapsed = libos_time_subtract(libos_time_get_now(), start);
+        if (!libos_time_is_later(timeout, elapsed))
+        {
+            err = LIBOS_ERR_TIMEOUT;
+            break;
+        }
+        err = libos_condvar_wait(bucket->condvar, bucket->mutex, libos_time_subtract(timeout, elapsed));
+        if (err != LIBOS_ERR_OK && err != LIBOS_ERR_TIMEOUT)
+        {
+            // The mutex may not be held, leave the bucket (and the waiter in it) alone.
+            return err;
+        }
+        err = LIBOS_ERR_OK;
+    }
+
+    if (!waiter->woken)
+    {
+        libos_wait_address_waiter_t **link = &bucket->waiters;
+        while (*link != waiter)
+        {
+            link = &(*link)->next;
+        }
+        *link = waiter->next;
+        LIBOS_ATOMIC_STORE(&waiter->linked, 0, LIBOS_ATOMIC_RELAXED);
+    }
+    else
+    {
+        // A wake right at the end of the timeout still counts.
+        err = (err == LIBOS_ERR_TIMEOUT) ? LIBOS_ERR_OK : err;
+    }
+    (void)libos_mutex_unlock(bucket->mutex);
+    return err;
+}
+
+/**
+ * @brief Wakes up to @ref count tasks waiting on @ref address.
+ * 
+ * @details
+ * The waiters are woken the longest waiting first. When the bucket has no
+ * waiters this only costs the bucket lock.
+ * 
+ * @param[in] address The word the tasks are waiting on.
+ * @param[in] count The maximum number of tasks to wake, LIBOS_WAKE_ADDRESS_ALL for all of them.
+ * 
+ * @retval LIBOS_ERR_OK The waiters (if any) are woken up.
+ * @retval LIBOS_ERR_INVALID_ARG @ref address is NULL.
+ * @retval LIBOS_ERR_TIMEOUT The bucket lock could not be taken.
+ * @retval LIBOS_ERR_FAIL In case of platform specific faults.
+ * 
+ * @return libos_err_t The libos standard success code for waking the address.
+ */
+static inline libos_err_t libos_wake_address(libos_atomic_uint32_t *address, uint32_t count)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(address);
+
+    libos_wait_address_bucket_t *bucket = libos_wait_address_bucket_(address);
+    LIBOS_ERR_CHECK(libos_mutex_lock(bucket->mutex, libos_time_from_ms(LIBOS_WAIT_ADDRESS_LOCK_TIMEOUT_MS)));
+
+    uint32_t woken = 0;
+    while (woken < count)
+    {
+        // The list is most recent first, find the oldest waiter on the address.
+        libos_wait_address_waiter_t **oldest = NULL;
+        for (libos_wait_address_waiter_t **link = &bucket->waiters; *link != NULL; link = &(*link)->next)
+        {
+            if ((*link)->address == address)
+            {
+                oldest = link;
+            }
+        }
+        if (oldest == NULL)
+        {
+            break;
+        }
+        libos_wait_address_waiter_t *waiter = *oldest;
+        *oldest = waiter->next;
+        waiter->woken = true;
+        // Release, the thread of a left behind waiter may reuse it as soon as it sees this.
+        LIBOS_ATOMIC_STORE(&waiter->linked, 0, LIBOS_ATOMIC_RELEASE);
+        woken++;
+    }
+
+    libos_err_t err = LIBOS_ERR_OK;
+    if (woken > 0)
+    {
+        // The condition variable is shared by the bucket, the not woken waiters go back to sleep.
+        err = libos_condvar_broadcast(bucket->condvar);
+    }
+    (void)libos_mutex_unlock(bucket->mutex);
+    return err;
+}
+
+#endif // LIBOS_WAIT_ADDRESS_ENABLE_NATIVE==1
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_CONCURRENT_WAIT_ADDRESS_H
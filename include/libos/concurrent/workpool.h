@@ -0,0 +1,487 @@
+/**
+ * @file workpool.h
+ * @brief Work-stealing thread pool for many small independent jobs.
+ * 
+ * @details
+ * A pool has a number of worker threads and one caller, the thread that
+ * created the pool. Each of them owns a work-stealing deque (see
+ * libos/concurrent/ws_deque.h). A job submitted by the caller or by a
+ * running job is pushed on the deque of that thread, and popped by it again
+ * (last in, first out). A thread without work steals the oldest job of
+ * another thread (first in, first out). This keeps all cores busy without a
+ * central queue that every thread contends for. A worker that finds no work
+ * at all sleeps on a semaphore until a job is submitted.
+ * 
+ * The caller submits the jobs and then helps running them in
+ * libos_workpool_wait, until all submitted jobs (including the ones that
+ * jobs submitted) are done. Only the caller thread may call
+ * libos_workpool_wait.
+ * 
+ * The pool does not allocate any memory when the threads and the semaphore
+ * are created statically. The jobs are libos_workpool_job_t descriptors
+ * owned by the user (for example a static array), the pool only keeps a
+ * pointer to them. A descriptor must stay valid and untouched until its job
+ * has run, and can be reused after libos_workpool_wait returned. When a deque
+ * is full the job is run directly by the submitter.
+ * 
+ * Example:
+ * @code{.c}
+ * static LIBOS_WORKPOOL_STATIC_DATA_STRUCT(pool_data, 2, 64, 4096);
+ * static libos_workpool_t pool;
+ * static libos_workpool_job_t jobs[16];
+ * 
+ * static void checksum_block(libos_workpool_job_t *job, libos_workpool_worker_t *worker)
+ * {
+ *     block_t *block = (block_t *)job->arg;
+ *     block->crc = crc32(block->data, block->size);
+ * }
+ * 
+ * void checksum_all(block_t *blocks)
+ * {
+ *     libos_thread_config_t config = LIBOS_THREAD_CONFIG_DEFAULT("crc");
+ *     LIBOS_WORKPOOL_CREATE_STATIC(pool_data, pool, &config);
+ *     for (size_t i = 0; i < 16; i++)
+ *     {
+ *         libos_workpool_job_init(&jobs[i], checksum_block, &blocks[i]);
+ *         libos_workpool_submit(libos_workpool_caller(&pool), &jobs[i]);
+ *     }
+ *     libos_workpool_wait(&pool);
+ *     libos_workpool_deinit(&pool);
+ * }
+ * @endcode
+ * 
+ * The implementation is fully in this header, on top of the thread,
+ * semaphore and atomic APIs.
+ */
+
+#pragma once
+#ifndef LIBOS_CONCURRENT_WORKPOOL_H
+#define LIBOS_CONCURRENT_WORKPOOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "libos/error.h"
+#include "libos/time.h"
+#include "libos/concurrent/atomic.h"
+#include "libos/concurrent/semaphore.h"
+#include "libos/concurrent/thread.h"
+#include "libos/concurrent/ws_deque.h"
+
+/**
+ * @brief The longest time in milliseconds a idle worker sleeps before it looks for work again.
+ * 
+ * @details
+ * A submit wakes a sleeping worker, this is only a safety net.
+ */
+#ifndef LIBOS_WORKPOOL_IDLE_TIMEOUT_MS
+#define LIBOS_WORKPOOL_IDLE_TIMEOUT_MS 100
+#endif // LIBOS_WORKPOOL_IDLE_TIMEOUT_MS
+
+typedef struct libos_workpool_s libos_workpool_t;
+typedef struct libos_workpool_worker_s libos_workpool_worker_t;
+typedef struct libos_workpool_job_s libos_workpool_job_t;
+
+/**
+ * @brief The function of a job.
+ * 
+ * @param job The descriptor of the job.
+ * @param worker The thread that runs the job, to submit more jobs to.
+ */
+typedef void (*libos_workpool_fn_t)(libos_workpool_job_t *job, libos_workpool_worker_t *worker);
+
+/**
+ * @brief The descriptor of a job, owned by the user.
+ */
+struct libos_workpool_job_s
+{
+    /**
+     * @brief The function that runs the job.
+     */
+    libos_workpool_fn_t fn;
+    /**
+     * @brief The argument of the job for the function.
+     */
+    void *arg;
+};
+
+/**
+ * @brief A thread of the pool, a worker or the caller.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly.
+ */
+struct libos_workpool_worker_s
+{
+    libos_ws_deque_t deque;         ///< The jobs submitted by this thread.
+    libos_workpool_t *pool;         ///< The pool of the thread.
+    uint32_t index;                 ///< 0 for the caller, 1 and up for the workers.
+    uint32_t random;                ///< The state of the victim selection.
+    libos_thread_handle_t thread;   ///< The thread of a worker.
+};
+
+/**
+ * @brief The pool control structure.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly.
+ */
+struct libos_workpool_s
+{
+    libos_workpool_worker_t *workers;   ///< The caller followed by the workers.
+    uint32_t worker_count;              ///< The number of worker threads.
+    libos_atomic_uint32_t pending;      ///< The number of submitted jobs that aren't done.
+    libos_atomic_uint32_t sleeping;     ///< The number of workers that are (about to be) sleeping.
+    libos_atomic_uint32_t stop;         ///< Set to stop the workers.
+    libos_semaphore_handle_t wake;      ///< Wakes the sleeping workers.
+#if LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION==1
+    libos_semaphore_t wake_data;        ///< The storage of the semaphore.
+#endif // LIBOS_SEMAPHORE_ENABLE_STATIC_ALLOCATION==1
+};
+
+#if LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_WORKPOOL_THREADS_(worker_count, stack_size) libos_thread_t threads[(worker_count)]; LIBOS_THREAD_STACK_DEFINE(stacks[(worker_count)], stack_size);
+#define LIBOS_WORKPOOL_THREADS_ARGS_(static_data_name) (static_data_name).threads, (static_data_name).stacks, sizeof((static_data_name).stacks[0])
+#else // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+#define LIBOS_WORKPOOL_THREADS_(worker_count, stack_size)
+#define LIBOS_WORKPOOL_THREADS_ARGS_(static_data_name) NULL, NULL, 0
+#endif // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+
+/**
+ * @def LIBOS_WORKPOOL_STATIC_DATA_STRUCT(name, worker_count, capacity, stack_size)
+ * @brief Define the storage of a pool with @ref worker_count worker threads with @ref name.
+ * 
+ * @details
+ * The storage contains the deques of the caller and the workers, and the
+ * control blocks and stacks of the worker threads if static allocation of
+ * threads is supported. Otherwise the threads are allocated with the
+ * stack_size of the thread configuration.
+ * 
+ * @param[in] name The name of the storage variable.
+ * @param[in] worker_count The number of worker threads, the caller comes on top of that.
+ * @param[in] capacity The number of jobs each deque can hold (must be a power of two).
+ * @param[in] stack_size The size of the stack of a worker in bytes.
+ */
+#define LIBOS_WORKPOOL_STATIC_DATA_STRUCT(name, worker_count, capacity, stack_size) struct {  \
+        libos_workpool_worker_t workers[(worker_count) + 1];                                  \
+        LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(slots[(worker_count) + 1], capacity);               \
+        LIBOS_WORKPOOL_THREADS_(worker_count, stack_size)                                     \
+    } name
+
+/**
+ * @def LIBOS_WORKPOOL_CREATE_STATIC(static_data_name, pool, thread_config)
+ * @brief Initializes the pool with the storage defined by LIBOS_WORKPOOL_STATIC_DATA_STRUCT and starts the workers.
+ * 
+ * @details
+ * The static data and pool parameters are names for the variables, they are
+ * NOT pointers yet.
+ * 
+ * @param[in] static_data_name The name of of the variable for the storage.
+ * @param[in] pool The name of the libos_workpool_t variable to initialize.
+ * @param[in] thread_config Pointer to the configuration of the worker threads, see libos_workpool_init.
+ * 
+ * @return libos_err_t The result of libos_workpool_init.
+ */
+#define LIBOS_WORKPOOL_CREATE_STATIC(static_data_name, pool, thread_config) libos_workpool_init(&(pool), \
+    (static_data_name).workers, sizeof((static_data_name).workers) / sizeof((static_data_name).workers[0]) - 1, \
+    &(static_data_name).slots[0][0], sizeof((static_data_name).slots[0]) / sizeof((static_data_name).slots[0][0]), \
+    LIBOS_WORKPOOL_THREADS_ARGS_(static_data_name), (thread_config))
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initializes a job descriptor.
+ * 
+ * @param[out] job The descriptor.
+ * @param[in] fn The function that runs the job.
+ * @param[in] arg The argument of the job for the function.
+ */
+static inline void libos_workpool_job_init(libos_workpool_job_t *job, libos_workpool_fn_t fn, void *arg)
+{
+    job->fn = fn;
+    job->arg = arg;
+}
+
+/**
+ * @brief Returns the caller of the pool, the thread that created it, to submit jobs to.
+ * 
+ * @param[in] pool The pool.
+ * 
+ * @return libos_workpool_worker_t* The caller.
+ */
+static inline libos_workpool_worker_t *libos_workpool_caller(libos_workpool_t *pool)
+{
+    return &pool->workers[0];
+}
+
+// Runs a job and marks it as done.
+static inline void libos_workpool_run_(libos_workpool_worker_t *worker, libos_workpool_job_t *job)
+{
+    job->fn(job, worker);
+    LIBOS_ATOMIC_FETCH_SUB(&worker->pool->pending, 1, LIBOS_ATOMIC_RELEASE);
+}
+
+// Takes a job from the own deque, or steals one.
+static inline libos_workpool_job_t *libos_workpool_find_(libos_workpool_worker_t *worker)
+{
+    libos_workpool_job_t *job = (libos_workpool_job_t *)libos_ws_deque_pop(&worker->deque);
+    if (job != NULL)
+    {
+        return job;
+    }
+
+    // Start at a random victim, such that the thieves spread over the deques.
+    libos_workpool_t *pool = worker->pool;
+    uint32_t threads = pool->worker_count + 1;
+    worker->random ^= worker->random << 13;
+    worker->random ^= worker->random >> 17;
+    worker->random ^= worker->random << 5;
+    uint32_t victim = worker->random % threads;
+    for (uint32_t i = 0; i < threads; i++, victim = (victim + 1 == threads) ? 0 : victim + 1)
+    {
+        if (victim == worker->index)
+        {
+            continue;
+        }
+        job = (libos_workpool_job_t *)libos_ws_deque_steal(&pool->workers[victim].deque);
+        if (job != NULL)
+        {
+            return job;
+        }
+    }
+    return NULL;
+}
+
+// Checks if any deque has a job, used before going to sleep.
+static inline bool libos_workpool_has_work_(libos_workpool_t *pool)
+{
+    for (uint32_t i = 0; i <= pool->worker_count; i++)
+    {
+        if (libos_ws_deque_size(&pool->workers[i].deque) > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The function of the worker threads.
+static inline void libos_workpool_worker_main_(void *arg)
+{
+    libos_workpool_worker_t *worker = (libos_workpool_worker_t *)arg;
+    libos_workpool_t *pool = worker->pool;
+    while (LIBOS_ATOMIC_LOAD(&pool->stop, LIBOS_ATOMIC_ACQUIRE) == 0)
+    {
+        libos_workpool_job_t *job = libos_workpool_find_(worker);
+        if (job != NULL)
+        {
+            libos_workpool_run_(worker, job);
+            continue;
+        }
+
+        // Announce the sleep before the last look for work, a submit either
+        // sees the announcement or the look sees its job (both are sequentially consistent).
+        LIBOS_ATOMIC_FETCH_ADD(&pool->sleeping, 1, LIBOS_ATOMIC_SEQ_CST);
+        if (!libos_workpool_has_work_(pool) && LIBOS_ATOMIC_LOAD(&pool->stop, LIBOS_ATOMIC_ACQUIRE) == 0)
+        {
+            (void)libos_semaphore_take(pool->wake, libos_time_from_ms(LIBOS_WORKPOOL_IDLE_TIMEOUT_MS));
+        }
+        LIBOS_ATOMIC_FETCH_SUB(&pool->sleeping, 1, LIBOS_ATOMIC_RELAXED);
+    }
+}
+
+// Stops and joins the workers, and deletes the semaphore.
+static inline void libos_workpool_stop_(libos_workpool_t *pool)
+{
+    LIBOS_ATOMIC_STORE(&pool->stop, 1, LIBOS_ATOMIC_RELEASE);
+    for (uint32_t i = 1; i <= pool->worker_count; i++)
+    {
+        // Fails when the worker is awake already, which is fine.
+        (void)libos_semaphore_give(pool->wake);
+    }
+    for (uint32_t i = 1; i <= pool->worker_count; i++)
+    {
+        (void)libos_thread_join(pool->workers[i].thread);
+    }
+    libos_semaphore_delete(pool->wake);
+}
+
+/**
+ * @brief Initializes the pool and starts the worker threads.
+ * 
+ * @details
+ * Usually called through LIBOS_WORKPOOL_CREATE_STATIC. The calling thread
+ * becomes the caller of the pool. With 0 workers the caller runs all jobs in
+ * libos_workpool_wait.
+ * 
+ * The name and priority of @ref thread_config are used for all workers. With
+ * the core LIBOS_THREAD_CORE_ANY the workers can run on any core, otherwise
+ * worker n is pinned to core (core + n) modulo the number of cores, placing
+ * the workers on consecutive cores after the given core.
+ * 
+ * @param[out] pool The pool to initialize.
+ * @param[in] workers Storage for @ref worker_count + 1 threads.
+ * @param[in] worker_count The number of worker threads.
+ * @param[in] slots Storage for (@ref worker_count + 1) * @ref capacity deque slots.
+ * @param[in] capacity The number of jobs each deque can hold, must be a power of two.
+ * @param[in] threads Storage for @ref worker_count thread control blocks, NULL when the threads are created dynamically.
+ * @param[in] stacks Storage for @ref worker_count stacks, NULL when the threads are created dynamically.
+ * @param[in] stack_size The size of one stack in @ref stacks in bytes.
+ * @param[in] thread_config The configuration of the worker threads.
+ * 
+ * @retval LIBOS_ERR_OK The pool is running.
+ * @retval LIBOS_ERR_INVALID_ARG A pointer is NULL, or @ref capacity is not a power of two.
+ * 
+ * @return libos_err_t The libos standard success code, or the error of creating the semaphore or a thread.
+ */
+static inline libos_err_t libos_workpool_init(libos_workpool_t *pool, libos_workpool_worker_t *workers, uint32_t worker_count,
+    libos_atomic_ptr_t *slots, size_t capacity, libos_thread_t *threads, void *stacks, size_t stack_size,
+    const libos_thread_config_t *thread_config)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(pool);
+    LIBOS_ERR_RET_ARG_NOT_NULL(workers);
+    LIBOS_ERR_RET_ARG_NOT_NULL(slots);
+    LIBOS_ERR_RET_ARG_NOT_NULL(thread_config);
+
+    pool->workers = workers;
+    pool->worker_count = worker_count;
+    LIBOS_ATOMIC_INIT(&pool->pending, 0);
+    LIBOS_ATOMIC_INIT(&pool->sleeping, 0);
+    LIBOS_ATOMIC_INIT(&pool->stop, 0);
+    for (uint32_t i = 0; i <= worker_count; i++)
+    {
+        libos_workpool_worker_t *worker = &workers[i];
+        LIBOS_ERR_CHECK(libos_ws_deque_init(&worker->deque, &slots[i * capacity], capacity));
+        worker->pool = pool;
+        worker->index = i;
+        // Any non-zero seed will do for the xorshift.
+        worker->random = 0x9E3779B9u * (i + 1);
+    }
+    if (worker_count == 0)
+    {
+        return LIBOS_ERR_OK;
+    }
+#if LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+    LIBOS_ERR_RET_ARG_NOT_NULL(threads);
+    LIBOS_ERR_RET_ARG_NOT_NULL(stacks);
+#endif // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+
+    LIBOS_ERR_CHECK(LIBOS_SEMAPHORE_CREATE_PREFER_STATIC(pool->wake_data, pool->wake, worker_count, 0));
+
+    libos_thread_config_t config = *thread_config;
+    int core_count = libos_thread_get_core_count();
+    libos_err_t err = LIBOS_ERR_OK;
+    uint32_t started = 0;
+    while (started < worker_count && err == LIBOS_ERR_OK)
+    {
+        libos_workpool_worker_t *worker = &workers[started + 1];
+        if (thread_config->core != LIBOS_THREAD_CORE_ANY)
+        {
+            config.core = (int)((thread_config->core + started + 1) % (uint32_t)core_count);
+        }
+#if LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+        err = libos_thread_create_static(&threads[started], (uint8_t *)stacks + (started * stack_size), stack_size,
+            &worker->thread, &config, libos_workpool_worker_main_, worker);
+#else // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+        (void)threads;
+        (void)stacks;
+        (void)stack_size;
+        err = libos_thread_create_dynamic(&worker->thread, &config, libos_workpool_worker_main_, worker);
+#endif // LIBOS_THREAD_ENABLE_STATIC_ALLOCATION==1
+        if (err == LIBOS_ERR_OK)
+        {
+            started++;
+        }
+    }
+
+    if (err != LIBOS_ERR_OK)
+    {
+        // Stop the workers already started.
+        pool->worker_count = started;
+        libos_workpool_stop_(pool);
+    }
+    return err;
+}
+
+/**
+ * @brief Submits a job to the pool.
+ * 
+ * @details
+ * The job is pushed on the deque of @ref worker, from where it is popped by
+ * that thread or stolen by another. When the deque is full the job is run
+ * right away instead. The descriptor must stay valid until the job has run.
+ * 
+ * @param[in] worker The calling thread, libos_workpool_caller or the worker passed to a job.
+ * @param[in] job The job.
+ */
+static inline void libos_workpool_submit(libos_workpool_worker_t *worker, libos_workpool_job_t *job)
+{
+    libos_workpool_t *pool = worker->pool;
+    LIBOS_ATOMIC_FETCH_ADD(&pool->pending, 1, LIBOS_ATOMIC_RELAXED);
+    if (!libos_ws_deque_push(&worker->deque, job))
+    {
+        libos_workpool_run_(worker, job);
+        return;
+    }
+
+    // Pairs with the announcement of a sleeping worker.
+    LIBOS_ATOMIC_THREAD_FENCE(LIBOS_ATOMIC_SEQ_CST);
+    if (LIBOS_ATOMIC_LOAD(&pool->sleeping, LIBOS_ATOMIC_RELAXED) > 0)
+    {
+        // Fails when enough wake-ups are pending already, which is fine.
+        (void)libos_semaphore_give(pool->wake);
+    }
+}
+
+/**
+ * @brief Runs and waits for jobs until all submitted jobs are done (caller only).
+ * 
+ * @param[in] pool The pool.
+ */
+static inline void libos_workpool_wait(libos_workpool_t *pool)
+{
+    libos_workpool_worker_t *caller = libos_workpool_caller(pool);
+    while (LIBOS_ATOMIC_LOAD(&pool->pending, LIBOS_ATOMIC_ACQUIRE) != 0)
+    {
+        libos_workpool_job_t *job = libos_workpool_find_(caller);
+        if (job != NULL)
+        {
+            libos_workpool_run_(caller, job);
+        }
+        else
+        {
+            // The remaining jobs are running on the workers.
+            libos_thread_yield();
+        }
+    }
+}
+
+/**
+ * @brief Stops the worker threads and releases them (caller only).
+ * 
+ * @details
+ * All jobs have to be done, call libos_workpool_wait first. The storage can
+ * be reused for a new pool afterwards.
+ * 
+ * @param[in] pool The pool.
+ */
+static inline void libos_workpool_deinit(libos_workpool_t *pool)
+{
+    if (pool->worker_count == 0)
+    {
+        return;
+    }
+
+    libos_workpool_stop_(pool);
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_CONCURRENT_WORKPOOL_H
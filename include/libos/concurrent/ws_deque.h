@@ -0,0 +1,269 @@
+/**
+ * @file ws_deque.h
+ * @brief Lock-free work-stealing deque (Chase-Lev) of pointers.
+ * 
+ * @details
+ * This header provides a bounded double ended queue with a single owner and
+ * any number of thieves. The owner pushes and pops at the bottom (last in,
+ * first out, which keeps the most recent and cache-hot work local), the
+ * thieves steal from the top (first in, first out, the oldest and usually
+ * largest work). Only the pop of the last element and the steals are
+ * synchronised with a compare-and-swap, the push and the other pops are
+ * plain loads and stores with the appropriate ordering. This is the deque of
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al.,
+ * 2013), without the growing of the buffer.
+ * 
+ * The deque does not allocate any memory. The slots are provided by the user,
+ * with the LIBOS_WS_DEQUE_STATIC_DATA_STRUCT and LIBOS_WS_DEQUE_CREATE_STATIC
+ * macros or by calling libos_ws_deque_init with a user provided array. The
+ * capacity has to be a power of two. The elements are pointers, a NULL
+ * pointer can't be pushed since it means empty.
+ * 
+ * Example:
+ * @code{.c}
+ * static LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(job_slots, 64);
+ * static libos_ws_deque_t jobs;
+ * 
+ * void init(void) {
+ *   LIBOS_WS_DEQUE_CREATE_STATIC(job_slots, jobs);
+ * }
+ * 
+ * void owner(void) {
+ *   if (!libos_ws_deque_push(&jobs, &job)) {
+ *     // Full, run it directly
+ *   }
+ *   job_t *next = libos_ws_deque_pop(&jobs);
+ * }
+ * 
+ * void thief(void) {
+ *   job_t *stolen = libos_ws_deque_steal(&jobs);
+ * }
+ * @endcode
+ * 
+ * The implementation is fully in this header, and only depends on the
+ * platform for the error codes and atomics.
+ */
+
+#pragma once
+#ifndef LIBOS_CONCURRENT_WS_DEQUE_H
+#define LIBOS_CONCURRENT_WS_DEQUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "libos/error.h"
+#include "libos/concurrent/atomic.h"
+
+#ifndef LIBOS_CACHE_LINE_SIZE
+// The size (in bytes) of a cache line, see spsc_ring.h.
+#define LIBOS_CACHE_LINE_SIZE 64
+#endif // LIBOS_CACHE_LINE_SIZE
+
+#ifdef __cplusplus
+#define LIBOS_WS_DEQUE_ALIGNED_ alignas(LIBOS_CACHE_LINE_SIZE)
+#else // __cplusplus
+#define LIBOS_WS_DEQUE_ALIGNED_ _Alignas(LIBOS_CACHE_LINE_SIZE)
+#endif // __cplusplus
+
+/**
+ * @brief The deque control structure.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly. The indices are free running counters, the position in the
+ * slots is the index masked with the capacity.
+ */
+typedef struct {
+    LIBOS_WS_DEQUE_ALIGNED_ libos_atomic_size_t top;    ///< Advanced by the thieves (and the owner for the last element).
+    LIBOS_WS_DEQUE_ALIGNED_ libos_atomic_size_t bottom; ///< Written by the owner only.
+    LIBOS_WS_DEQUE_ALIGNED_ libos_atomic_ptr_t *slots;  ///< The element storage.
+    size_t mask;                                        ///< The capacity minus one.
+} libos_ws_deque_t;
+
+/**
+ * @def LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(name, capacity)
+ * @brief Define the slots for @ref capacity elements with @ref name.
+ * 
+ * @param[in] name The name of the storage variable.
+ * @param[in] capacity The number of elements the deque can hold (must be a power of two).
+ */
+#define LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(name, capacity) libos_atomic_ptr_t name[(capacity)]
+
+/**
+ * @def LIBOS_WS_DEQUE_CREATE_STATIC(static_data_name, deque)
+ * @brief Initializes the deque with the storage defined by LIBOS_WS_DEQUE_STATIC_DATA_STRUCT.
+ * 
+ * @details
+ * The parameter are names for the variables, they are NOT pointers yet.
+ * 
+ * @param[in] static_data_name The name of of the variable for the storage.
+ * @param[in] deque The name of the libos_ws_deque_t variable to initialize.
+ * 
+ * @return libos_err_t The result of libos_ws_deque_init.
+ */
+#define LIBOS_WS_DEQUE_CREATE_STATIC(static_data_name, deque) libos_ws_deque_init(&(deque), (static_data_name), sizeof(static_data_name) / sizeof((static_data_name)[0]))
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initializes the deque with the given slots.
+ * 
+ * @details
+ * The deque starts empty. This is not thread safe, the deque can only be
+ * used by the owner and thieves after the initialization is done.
+ * 
+ * @param[out] deque The deque to initialize.
+ * @param[in] slots The memory for the elements.
+ * @param[in] capacity The number of slots, must be a power of two.
+ * 
+ * @retval LIBOS_ERR_OK The deque is initialized.
+ * @retval LIBOS_ERR_INVALID_ARG @ref deque or @ref slots is NULL, or @ref capacity is not a power of two.
+ * 
+ * @return libos_err_t The libos standard success code for initializing the deque.
+ */
+static inline libos_err_t libos_ws_deque_init(libos_ws_deque_t *deque, libos_atomic_ptr_t *slots, size_t capacity)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(deque);
+    LIBOS_ERR_RET_ARG_NOT_NULL(slots);
+    LIBOS_ERR_RET_ON_TRUE(capacity == 0 || (capacity & (capacity - 1)) != 0, LIBOS_ERR_INVALID_ARG);
+
+    LIBOS_ATOMIC_INIT(&deque->top, 0);
+    LIBOS_ATOMIC_INIT(&deque->bottom, 0);
+    for (size_t i = 0; i < capacity; i++)
+    {
+        LIBOS_ATOMIC_INIT(&slots[i], NULL);
+    }
+    deque->slots = slots;
+    deque->mask = capacity - 1;
+    return LIBOS_ERR_OK;
+}
+
+/**
+ * @brief Returns the number of elements the deque can hold.
+ * 
+ * @param[in] deque The deque.
+ * 
+ * @return size_t The capacity of the deque.
+ */
+static inline size_t libos_ws_deque_capacity(const libos_ws_deque_t *deque)
+{
+    return deque->mask + 1;
+}
+
+/**
+ * @brief Returns the number of elements in the deque.
+ * 
+ * @details
+ * This can be called by anyone, but while the owner or a thief is active
+ * the result is only a snapshot.
+ * 
+ * @param[in] deque The deque.
+ * 
+ * @return size_t The number of elements that can be popped or stolen.
+ */
+static inline size_t libos_ws_deque_size(libos_ws_deque_t *deque)
+{
+    size_t top = LIBOS_ATOMIC_LOAD(&deque->top, LIBOS_ATOMIC_SEQ_CST);
+    size_t bottom = LIBOS_ATOMIC_LOAD(&deque->bottom, LIBOS_ATOMIC_SEQ_CST);
+    // The owner lowers the bottom below the top for a moment while popping the last element.
+    ptrdiff_t size = (ptrdiff_t)(bottom - top);
+    return (size > 0) ? (size_t)size : 0;
+}
+
+/**
+ * @brief Pushes a element at the bottom of the deque (owner only).
+ * 
+ * @param[in] deque The deque to push to.
+ * @param[in] element The element, not NULL.
+ * 
+ * @retval true The element is pushed.
+ * @retval false The deque is full.
+ */
+static inline bool libos_ws_deque_push(libos_ws_deque_t *deque, void *element)
+{
+    size_t bottom = LIBOS_ATOMIC_LOAD(&deque->bottom, LIBOS_ATOMIC_RELAXED);
+    size_t top = LIBOS_ATOMIC_LOAD(&deque->top, LIBOS_ATOMIC_ACQUIRE);
+    if (bottom - top > deque->mask)
+    {
+        return false;
+    }
+
+    LIBOS_ATOMIC_STORE(&deque->slots[bottom & deque->mask], element, LIBOS_ATOMIC_RELAXED);
+    // Release, the element (and what it points to) has to be visible before a thief can see the new bottom.
+    LIBOS_ATOMIC_STORE(&deque->bottom, bottom + 1, LIBOS_ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief Pops the element at the bottom of the deque, the most recently pushed (owner only).
+ * 
+ * @param[in] deque The deque to pop from.
+ * 
+ * @return void* The element, or NULL if the deque is empty (or a thief took the last element).
+ */
+static inline void *libos_ws_deque_pop(libos_ws_deque_t *deque)
+{
+    size_t bottom = LIBOS_ATOMIC_LOAD(&deque->bottom, LIBOS_ATOMIC_RELAXED) - 1;
+    LIBOS_ATOMIC_STORE(&deque->bottom, bottom, LIBOS_ATOMIC_RELAXED);
+    // Orders the claim on the bottom element against the read of the top, see the steal.
+    LIBOS_ATOMIC_THREAD_FENCE(LIBOS_ATOMIC_SEQ_CST);
+    size_t top = LIBOS_ATOMIC_LOAD(&deque->top, LIBOS_ATOMIC_RELAXED);
+
+    if ((ptrdiff_t)(bottom - top) < 0)
+    {
+        // Empty, restore the bottom.
+        LIBOS_ATOMIC_STORE(&deque->bottom, bottom + 1, LIBOS_ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    void *element = LIBOS_ATOMIC_LOAD(&deque->slots[bottom & deque->mask], LIBOS_ATOMIC_RELAXED);
+    if (bottom == top)
+    {
+        // The last element, race the thieves for it.
+        if (!LIBOS_ATOMIC_COMPARE_EXCHANGE(&deque->top, &top, top + 1, LIBOS_ATOMIC_SEQ_CST, LIBOS_ATOMIC_RELAXED))
+        {
+            element = NULL;
+        }
+        LIBOS_ATOMIC_STORE(&deque->bottom, bottom + 1, LIBOS_ATOMIC_RELAXED);
+    }
+    return element;
+}
+
+/**
+ * @brief Steals the element at the top of the deque, the least recently pushed (any thread).
+ * 
+ * @details
+ * When multiple thieves (or the owner popping the last element) go for the
+ * same element only one gets it, the others get NULL even though the deque
+ * might not be empty. Check libos_ws_deque_size to tell the two apart.
+ * 
+ * @param[in] deque The deque to steal from.
+ * 
+ * @return void* The element, or NULL if the deque is empty or the element was taken by someone else.
+ */
+static inline void *libos_ws_deque_steal(libos_ws_deque_t *deque)
+{
+    size_t top = LIBOS_ATOMIC_LOAD(&deque->top, LIBOS_ATOMIC_ACQUIRE);
+    LIBOS_ATOMIC_THREAD_FENCE(LIBOS_ATOMIC_SEQ_CST);
+    size_t bottom = LIBOS_ATOMIC_LOAD(&deque->bottom, LIBOS_ATOMIC_ACQUIRE);
+    if ((ptrdiff_t)(bottom - top) <= 0)
+    {
+        return NULL;
+    }
+
+    void *element = LIBOS_ATOMIC_LOAD(&deque->slots[top & deque->mask], LIBOS_ATOMIC_RELAXED);
+    if (!LIBOS_ATOMIC_COMPARE_EXCHANGE(&deque->top, &top, top + 1, LIBOS_ATOMIC_SEQ_CST, LIBOS_ATOMIC_RELAXED))
+    {
+        return NULL;
+    }
+    return element;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_CONCURRENT_WS_DEQUE_H
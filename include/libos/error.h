@@ -12,6 +12,20 @@
  * checking for NULL arguments and returning LIBOS_ERR_INVALID_ARG if the
  * argument is NULL.
  * 
+ * The checks are marked as unlikely, such that the compiler moves the error
+ * returns out of the hot path. With LIBOS_ERR_ENABLE_FAILURE_HOOK set to 1,
+ * every error return of the LIBOS_ERR_* macros also calls
+ * libos_err_on_failure with the file and line of the check. That function is
+ * cold and not inlined and has to be implemented by the application, for
+ * example to record where a error originated.
+ * 
+ * With LIBOS_ERR_ENABLE_TRACE set to 1, every error return of the
+ * LIBOS_ERR_* macros is also recorded (file, line and error) in a small ring
+ * per thread, such that the path of a error through the layers can be
+ * dumped with libos_err_trace_get after it surfaced. The success path isn't
+ * affected. One source file of the application has to contain
+ * LIBOS_ERR_TRACE_DEFINE().
+ * 
  * 
  * IMPLEMENTORS:
  * For the implementors it is required to provide a header file with the 
@@ -35,6 +49,10 @@
  * If they are not OS & platform independent, but widely used, still
  * consider up-streaming.
  * 
+ * The platform can define LIBOS_LIKELY, LIBOS_UNLIKELY and LIBOS_COLD for
+ * a compiler that isn't GCC compatible, by default the hints are left out
+ * for such compilers.
+ * 
  * Additional error codes can be defined, but application are not allowed
  * to rely on them being present. Same as with new helper macros, if
  * general or wide usage, then upstream.
@@ -71,6 +89,230 @@
 
 #include "libos/platform/error.h"
 
+#ifndef LIBOS_ERR_ENABLE_FAILURE_HOOK
+#define LIBOS_ERR_ENABLE_FAILURE_HOOK 0
+#endif // LIBOS_ERR_ENABLE_FAILURE_HOOK
+
+#ifndef LIBOS_LIKELY
+
+/**
+ * @brief Hints the compiler that the condition is usually true.
+ * 
+ * @param condition The expression to evaluate, the result is 0 or 1.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_LIKELY(condition) __builtin_expect(!!(condition), 1)
+#else
+#define LIBOS_LIKELY(condition) (!!(condition))
+#endif
+#endif // LIBOS_LIKELY
+
+#ifndef LIBOS_UNLIKELY
+
+/**
+ * @brief Hints the compiler that the condition is usually false.
+ * 
+ * @param condition The expression to evaluate, the result is 0 or 1.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#else
+#define LIBOS_UNLIKELY(condition) (!!(condition))
+#endif
+#endif // LIBOS_UNLIKELY
+
+#ifndef LIBOS_COLD
+
+/**
+ * @brief Marks a function as rarely called and not to be inlined, such that it is placed away from the hot code.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBOS_COLD __attribute__((cold, noinline))
+#else
+#define LIBOS_COLD
+#endif
+#endif // LIBOS_COLD
+
+#ifndef LIBOS_THREAD_LOCAL
+
+/**
+ * @brief Storage class for a variable with a instance per thread.
+ */
+#if defined(__cplusplus)
+#define LIBOS_THREAD_LOCAL thread_local
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define LIBOS_THREAD_LOCAL _Thread_local
+#else
+#define LIBOS_THREAD_LOCAL __thread
+#endif
+#endif // LIBOS_THREAD_LOCAL
+
+#ifndef LIBOS_ERR_ENABLE_TRACE
+#define LIBOS_ERR_ENABLE_TRACE 0
+#endif // LIBOS_ERR_ENABLE_TRACE
+
+#if LIBOS_ERR_ENABLE_TRACE==1
+
+#include <stdint.h>
+
+/**
+ * @brief The number of error returns remembered per thread, has to be a power of two.
+ */
+#ifndef LIBOS_ERR_TRACE_DEPTH
+#define LIBOS_ERR_TRACE_DEPTH 8
+#endif // LIBOS_ERR_TRACE_DEPTH
+
+#if (LIBOS_ERR_TRACE_DEPTH & (LIBOS_ERR_TRACE_DEPTH - 1)) != 0
+#error "LIBOS_ERR_TRACE_DEPTH has to be a power of two."
+#endif // (LIBOS_ERR_TRACE_DEPTH & (LIBOS_ERR_TRACE_DEPTH - 1)) != 0
+
+/**
+ * @brief The file recorded for a error return, can be defined (per file) to a shorter string.
+ */
+#ifndef LIBOS_ERR_FILE_ID
+#define LIBOS_ERR_FILE_ID __FILE__
+#endif // LIBOS_ERR_FILE_ID
+
+/**
+ * @brief A recorded error return.
+ */
+typedef struct libos_err_trace_entry_s
+{
+    /**
+     * @brief The LIBOS_ERR_FILE_ID of the check.
+     */
+    const char *file;
+    /**
+     * @brief The line of the check.
+     */
+    int line;
+    /**
+     * @brief The error that was returned.
+     */
+    libos_err_t err;
+} libos_err_trace_entry_t;
+
+/**
+ * @brief The trace ring of a thread.
+ */
+typedef struct libos_err_trace_s
+{
+    libos_err_trace_entry_t entries[LIBOS_ERR_TRACE_DEPTH];
+    /**
+     * @brief The number of error returns recorded since the last clear.
+     */
+    uint32_t count;
+} libos_err_trace_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+extern LIBOS_THREAD_LOCAL libos_err_trace_t libos_err_trace_;
+
+/**
+ * @brief Records a error return in the ring of the calling thread, used by the LIBOS_ERR_* macros.
+ * 
+ * @param[in] file The LIBOS_ERR_FILE_ID of the check.
+ * @param[in] line The line of the check.
+ * @param[in] err The returned error.
+ */
+static inline void libos_err_trace_record(const char *file, int line, libos_err_t err)
+{
+    libos_err_trace_t *trace = &libos_err_trace_;
+    libos_err_trace_entry_t *entry = &trace->entries[trace->count & (LIBOS_ERR_TRACE_DEPTH - 1)];
+    entry->file = file;
+    entry->line = line;
+    entry->err = err;
+    trace->count++;
+}
+
+/**
+ * @brief Copies the recorded error returns of the calling thread, the oldest first.
+ * 
+ * @details
+ * For a error that bubbled up, the first entry is closest to the origin.
+ * Only the last LIBOS_ERR_TRACE_DEPTH entries are kept.
+ * 
+ * @param[out] entries The buffer for the entries.
+ * @param[in] max The number of elements in @ref entries.
+ * 
+ * @return size_t The number of entries copied.
+ */
+static inline size_t libos_err_trace_get(libos_err_trace_entry_t *entries, size_t max)
+{
+    const libos_err_trace_t *trace = &libos_err_trace_;
+    size_t available = (trace->count < LIBOS_ERR_TRACE_DEPTH) ? trace->count : LIBOS_ERR_TRACE_DEPTH;
+    size_t count = (available < max) ? available : max;
+    // Skip the oldest entries if they don't fit.
+    uint32_t first = trace->count - (uint32_t)count;
+    for (size_t i = 0; i < count; i++)
+    {
+        entries[i] = trace->entries[(first + i) & (LIBOS_ERR_TRACE_DEPTH - 1)];
+    }
+    return count;
+}
+
+/**
+ * @brief Clears the recorded error returns of the calling thread, for example after the error was handled.
+ */
+static inline void libos_err_trace_clear(void)
+{
+    libos_err_trace_.count = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+/**
+ * @brief Defines the trace rings, has to be used in exactly one source file at file scope.
+ */
+#define LIBOS_ERR_TRACE_DEFINE() LIBOS_THREAD_LOCAL libos_err_trace_t libos_err_trace_
+
+// Records the error in the trace ring of the thread.
+#define LIBOS_ERR_TRACE_(err) libos_err_trace_record(LIBOS_ERR_FILE_ID, __LINE__, (err))
+#else // LIBOS_ERR_ENABLE_TRACE==1
+#define LIBOS_ERR_TRACE_(err) do { } while(0)
+#endif // LIBOS_ERR_ENABLE_TRACE==1
+
+#if LIBOS_ERR_ENABLE_FAILURE_HOOK==1
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Called by the LIBOS_ERR_* macros just before they return a error.
+ * 
+ * @details
+ * Implemented by the application. It must not use the LIBOS_ERR_* macros
+ * itself.
+ * 
+ * @param[in] file The file of the check (__FILE__).
+ * @param[in] line The line of the check.
+ * @param[in] err The error that is returned.
+ */
+LIBOS_COLD void libos_err_on_failure(const char *file, int line, libos_err_t err);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+// Reports the error to the hook (and the trace), then returns it.
+#define LIBOS_ERR_RETURN_(ret) do { libos_err_t libos_err_ret_ = (ret); LIBOS_ERR_TRACE_(libos_err_ret_); libos_err_on_failure(__FILE__, __LINE__, libos_err_ret_); return libos_err_ret_; } while(0)
+// Reports the error to the hook (and the trace), then returns void.
+#define LIBOS_ERR_RETURN_VOID_(err) do { libos_err_t libos_err_ret_ = (err); LIBOS_ERR_TRACE_(libos_err_ret_); libos_err_on_failure(__FILE__, __LINE__, libos_err_ret_); return; } while(0)
+#elif LIBOS_ERR_ENABLE_TRACE==1
+// Records the error in the trace, then returns it.
+#define LIBOS_ERR_RETURN_(ret) do { libos_err_t libos_err_ret_ = (ret); LIBOS_ERR_TRACE_(libos_err_ret_); return libos_err_ret_; } while(0)
+// Records the error in the trace, then returns void.
+#define LIBOS_ERR_RETURN_VOID_(err) do { LIBOS_ERR_TRACE_(err); return; } while(0)
+#else // LIBOS_ERR_ENABLE_FAILURE_HOOK==1
+#define LIBOS_ERR_RETURN_(ret) return (ret)
+#define LIBOS_ERR_RETURN_VOID_(err) do { (void)(err); return; } while(0)
+#endif // LIBOS_ERR_ENABLE_FAILURE_HOOK==1
+
 #ifndef LIBOS_ERR_CHECK
 
 /**
@@ -88,7 +330,7 @@
  * 
  * @param value The value to do the check on.
  */
-#define LIBOS_ERR_CHECK_VOID(expr) do { libos_err_t __err = (expr); LIBOS_RET_VAL_ON_TRUE(__err != LIBOS_ERR_OK,); } while(0)
+#define LIBOS_ERR_CHECK_VOID(expr) do { libos_err_t __err = (expr); if (LIBOS_UNLIKELY(__err != LIBOS_ERR_OK)) { LIBOS_ERR_RETURN_VOID_(__err); }} while(0)
 #endif // LIBOS_ERR_CHECK_VOID
 
 // ================================================
@@ -145,7 +387,7 @@
  * @param condition The expression to evaluate.
  * @param ret The expression to return if the @ref condition is @code true.
  */
-#define LIBOS_ERR_RET_ON_TRUE(condition, ret) do { if ((condition)) { return (ret); }} while(0)
+#define LIBOS_ERR_RET_ON_TRUE(condition, ret) do { if (LIBOS_UNLIKELY(condition)) { LIBOS_ERR_RETURN_(ret); }} while(0)
 #endif // LIBOS_ERR_RET_ON_TRUE
 
 // ================================================
@@ -199,7 +441,7 @@
  * @param condition The expression to evaluate.
  * @param ret The optional return value (can be left empty to 'return' void).
  */
-#define LIBOS_RET_VAL_ON_TRUE(condition, ret) do { if ((condition)) { return ret; }} while(0)
+#define LIBOS_RET_VAL_ON_TRUE(condition, ret) do { if (LIBOS_UNLIKELY(condition)) { return ret; }} while(0)
 #endif // LIBOS_RET_VAL_ON_TRUE
 
 #endif // LIBOS_ERROR_H
@@ -27,6 +27,33 @@
  * fully aware of the value of it. If a different value is defined for
  * each translation unit, the behaviour is undefined.
  * 
+ * For statements that can repeat at a high rate, every level also has a
+ * LIBOS_LOG_*_RATELIMITED(interval_ms, ...) variant that outputs at most once
+ * per interval (and reports how many were suppressed) and a
+ * LIBOS_LOG_*_EVERY_N(n, ...) variant that outputs every n-th statement.
+ * They keep lock-free state per call site and are defined in
+ * log_ratelimit.h, which has to be included to use them.
+ * 
+ * With LIBOS_LOG_ENABLE_RUNTIME_LEVEL set to 1, every module also gets a
+ * level that can be changed at run-time with libos_log_set_level. The
+ * statements of a disabled level cost a load and compare, the arguments
+ * aren't evaluated. LIBOS_LOG_LEVEL_DEFAULT is the level the modules start
+ * with, LIBOS_LOG_LEVEL_MIN stays the compile-time limit. Every file that
+ * logs has to register its module with LIBOS_LOG_MODULE, see log_runtime.h.
+ * 
+ * With LIBOS_LOG_ENABLE_DEFERRED set to 1, the LIBOS_LOG_* statements only
+ * capture their arguments and the platform formats and outputs them later
+ * from a background task, see log_deferred.h.
+ * 
+ * With LIBOS_LOG_ENABLE_BINARY set to 1, the LIBOS_LOG_* statements output
+ * a compact binary frame, with the format string replaced by a ID, that is
+ * decoded on the host, see log_binary.h.
+ * 
+ * With LIBOS_LOG_ENABLE_BUFFERED set to 1, the LIBOS_LOG_* statements are
+ * formatted into a buffer of the calling thread, which is output with a single
+ * platform write when it is full, after LIBOS_LOG_BUFFERED_FLUSH_MS or on a
+ * error, see log_buffered.h.
+ * 
  * IMPLEMENTORS:
  * A implementation should provide the following macros:
  * 
@@ -80,66 +107,140 @@
 #define LIBOS_LOG_LEVEL_MIN LIBOS_LOG_LEVEL_INF
 #endif // LIBOS_LOG_LEVEL_MIN
 
-#if LIBOS_LOG_LEVEL_MIN > LIBOS_LOG_LEVEL_ERR
+#ifndef LIBOS_LOG_LEVEL_DEFAULT
+#define LIBOS_LOG_LEVEL_DEFAULT LIBOS_LOG_LEVEL_MIN
+#endif // LIBOS_LOG_LEVEL_DEFAULT
+
+#ifndef LIBOS_LOG_ENABLE_RUNTIME_LEVEL
+#define LIBOS_LOG_ENABLE_RUNTIME_LEVEL 0
+#endif // LIBOS_LOG_ENABLE_RUNTIME_LEVEL
+
+#ifndef LIBOS_LOG_ENABLE_DEFERRED
+#define LIBOS_LOG_ENABLE_DEFERRED 0
+#endif // LIBOS_LOG_ENABLE_DEFERRED
+
+#ifndef LIBOS_LOG_ENABLE_BINARY
+#define LIBOS_LOG_ENABLE_BINARY 0
+#endif // LIBOS_LOG_ENABLE_BINARY
+
+#ifndef LIBOS_LOG_ENABLE_BUFFERED
+#define LIBOS_LOG_ENABLE_BUFFERED 0
+#endif // LIBOS_LOG_ENABLE_BUFFERED
+
+#if LIBOS_LOG_ENABLE_DEFERRED==1 && LIBOS_LOG_ENABLE_BINARY==1
+#error "Deferred and binary logging can't be enabled at the same time."
+#endif // LIBOS_LOG_ENABLE_DEFERRED==1 && LIBOS_LOG_ENABLE_BINARY==1
+
+#if LIBOS_LOG_ENABLE_BUFFERED==1 && (LIBOS_LOG_ENABLE_DEFERRED==1 || LIBOS_LOG_ENABLE_BINARY==1)
+#error "Buffered logging can't be enabled together with deferred or binary logging."
+#endif // LIBOS_LOG_ENABLE_BUFFERED==1 && (LIBOS_LOG_ENABLE_DEFERRED==1 || LIBOS_LOG_ENABLE_BINARY==1)
+
+#if LIBOS_LOG_ENABLE_DEFERRED==1
+#include "libos/log_deferred.h"
+// Only capture the statement, the platform formats and outputs it later.
+#define LIBOS_LOG_EMIT_(level, ...) LIBOS_LOG_DEFERRED(level, __VA_ARGS__)
+#elif LIBOS_LOG_ENABLE_BINARY==1
+#include "libos/log_binary.h"
+// Replace the format string by a ID and output the arguments raw.
+#define LIBOS_LOG_EMIT_(level, ...) LIBOS_LOG_BINARY(level, __VA_ARGS__)
+#elif LIBOS_LOG_ENABLE_BUFFERED==1
+#include "libos/log_buffered.h"
+// Format into the buffer of the thread, the buffer is output in one go.
+#define LIBOS_LOG_EMIT_(level, ...) LIBOS_LOG_BUFFERED(level, __VA_ARGS__)
+#else // LIBOS_LOG_ENABLE_DEFERRED==1
+#define LIBOS_LOG_EMIT_(level, ...) LIBOS_LOG_PRINT(level, __VA_ARGS__)
+#endif // LIBOS_LOG_ENABLE_DEFERRED==1
+
+#if LIBOS_LOG_ENABLE_RUNTIME_LEVEL==1
+#include "libos/log_runtime.h"
+// Check the level of the module first, such that the arguments of a disabled statement aren't evaluated.
+#define LIBOS_LOG_STATEMENT_(level, ...) do { \
+        if (LIBOS_LOG_RUNTIME_IS_ENABLED(level)) \
+        { \
+            LIBOS_LOG_EMIT_(level, __VA_ARGS__); \
+        } \
+    } while (0)
+#define LIBOS_LOG_IS_ENABLED_(level) LIBOS_LOG_RUNTIME_IS_ENABLED(level)
+#else // LIBOS_LOG_ENABLE_RUNTIME_LEVEL==1
+#define LIBOS_LOG_STATEMENT_(level, ...) LIBOS_LOG_EMIT_(level, __VA_ARGS__)
+#define LIBOS_LOG_IS_ENABLED_(level) 1
+#endif // LIBOS_LOG_ENABLE_RUNTIME_LEVEL==1
+
+#if LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_ERR
 /**
  * @brief Logs a error message, printf style, if the log level minimum allows.
  * 
  */
-#define LIBOS_LOG_ERR(...) LIBOS_LOG_PRINT(LIBOS_LOG_LEVEL_ERR, __VA_ARGS__)
+#define LIBOS_LOG_ERR(...) LIBOS_LOG_STATEMENT_(LIBOS_LOG_LEVEL_ERR, __VA_ARGS__)
 #else
 /**
  * @brief Logs a error message, printf style, if the log level minimum allows.
  * 
  */
 #define LIBOS_LOG_ERR(...)
-#endif // LIBOS_LOG_LEVEL_MIN > LIBOS_LOG_LEVEL_ERR
+#endif // LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_ERR
 
-#if LIBOS_LOG_LEVEL_MIN > LIBOS_LOG_LEVEL_WRN
+#if LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_WRN
 /**
  * @brief Logs a warning message, printf style, if the log level minimum allows.
  * 
  */
-#define LIBOS_LOG_WRN(...) LIBOS_LOG_PRINT(LIBOS_LOG_LEVEL_WRN, __VA_ARGS__)
+#define LIBOS_LOG_WRN(...) LIBOS_LOG_STATEMENT_(LIBOS_LOG_LEVEL_WRN, __VA_ARGS__)
 #else
 /**
  * @brief Logs a warning message, printf style, if the log level minimum allows.
  * 
  */
 #define LIBOS_LOG_WRN(...)
-#endif // LIBOS_LOG_LEVEL_MIN > LIBOS_LOG_LEVEL_WRN
+#endif // LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_WRN
 
-#if LIBOS_LOG_LEVEL_MIN > LIBOS_LOG_LEVEL_INF
+#if LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_INF
 /**
  * @brief Logs a info message, printf style, if the log level minimum allows.
  * 
  */
-#define LIBOS_LOG_INF(...) LIBOS_LOG_PRINT(LIBOS_LOG_LEVEL_INF, __VA_ARGS__)
+#define LIBOS_LOG_INF(...) LIBOS_LOG_STATEMENT_(LIBOS_LOG_LEVEL_INF, __VA_ARGS__)
 #else
 /**
  * @brief Logs a info message, printf style, if the log level minimum allows.
  * 
  */
 #define LIBOS_LOG_INF(...)
-#endif // LIBOS_LOG_LEVEL_MIN > LIBOS_LOG_LEVEL_INF
+#endif // LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_INF
 
-#if LIBOS_LOG_LEVEL_MIN > LIBOS_LOG_LEVEL_DBG
+#if LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_DBG
 /**
  * @brief Logs a debug message, printf style, if the log level minimum allows.
  * 
  */
-#define LIBOS_LOG_DBG(...) LIBOS_LOG_PRINT(LIBOS_LOG_LEVEL_DBG, __VA_ARGS__)
+#define LIBOS_LOG_DBG(...) LIBOS_LOG_STATEMENT_(LIBOS_LOG_LEVEL_DBG, __VA_ARGS__)
 #else
 /**
  * @brief Logs a debug message, printf style, if the log level minimum allows.
  * 
  */
 #define LIBOS_LOG_DBG(...)
-#endif // LIBOS_LOG_LEVEL_MIN > LIBOS_LOG_LEVEL_DBG
+#endif // LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_DBG
 
+#if LIBOS_LOG_ENABLE_BUFFERED==1
+// The buffered lines are tagged with the name of the module.
+#define LIBOS_LOG_MODULE_BASE_(log_name) LIBOS_LOG_MODULE_MIN_LEVEL(log_name, LIBOS_LOG_LEVEL_MIN); LIBOS_LOG_BUFFERED_MODULE(log_name)
+#else // LIBOS_LOG_ENABLE_BUFFERED==1
+#define LIBOS_LOG_MODULE_BASE_(log_name) LIBOS_LOG_MODULE_MIN_LEVEL(log_name, LIBOS_LOG_LEVEL_MIN)
+#endif // LIBOS_LOG_ENABLE_BUFFERED==1
+
+#if LIBOS_LOG_ENABLE_RUNTIME_LEVEL==1
+/**
+ * @brief Register a log module with the logging level set to the application wide default.
+ * 
+ */
+#define LIBOS_LOG_MODULE(log_name) LIBOS_LOG_MODULE_BASE_(log_name); LIBOS_LOG_RUNTIME_MODULE(log_name, LIBOS_LOG_LEVEL_DEFAULT)
+#else // LIBOS_LOG_ENABLE_RUNTIME_LEVEL==1
 /**
  * @brief Register a log module with the logging level set to the application wide default.
  * 
  */
-#define LIBOS_LOG_MODULE(log_name) LIBOS_LOG_MODULE_MIN_LEVEL(log_name, LIBOS_LOG_LEVEL_MIN)
+#define LIBOS_LOG_MODULE(log_name) LIBOS_LOG_MODULE_BASE_(log_name)
+#endif // LIBOS_LOG_ENABLE_RUNTIME_LEVEL==1
 
 #endif // LIBOS_LOG_H
@@ -0,0 +1,257 @@
+/**
+ * @file log_binary.h
+ * @brief Binary (dictionary encoded) log output.
+ * 
+ * @details
+ * With LIBOS_LOG_ENABLE_BINARY set to 1, the LIBOS_LOG_* macros of log.h
+ * don't output text. The format string is placed in the libos_log_fmt
+ * section and replaced by its offset in that section, and the arguments are
+ * serialized raw. The resulting frame is handed to the platform with
+ * libos_log_binary_write. The host tool tools/libos_log_decode.py reads the
+ * format strings from the ELF file of the firmware and reconstructs the text.
+ * 
+ * The libos_log_fmt section only has to be present in the ELF file, not on
+ * the device. To remove it from the image, place it in a non-loaded output
+ * section with the linker script of the platform, like:
+ * 
+ * @code
+ * libos_log_fmt 0 (INFO) : { KEEP(*(libos_log_fmt)) }
+ * @endcode
+ * 
+ * By default the ID of a format string is its offset from the
+ * __start_libos_log_fmt symbol that GNU ld provides. A toolchain without
+ * it can define LIBOS_LOG_BINARY_FORMAT_ID(format) to something else, the
+ * decoder has to agree on the definition.
+ * 
+ * Frame layout (varint is unsigned LEB128, zigzag for signed values):
+ * 
+ *  * varint: length of the rest of the frame
+ *  * byte: level
+ *  * varint: libos_time_ticks_now timestamp
+ *  * varint: format string ID
+ *  * per argument: a tag byte (kind in the low nibble, size of the C type in
+ *    the high nibble) and the value: varint for unsigned and pointers, zigzag
+ *    varint for signed, 8 bytes little endian IEEE-754 for floating point and
+ *    a varint length with the bytes for strings.
+ * 
+ * Like with deferred logging, at most LIBOS_LOG_DEFERRED_MAX_ARGS arguments
+ * are supported. Strings are copied into the frame (at most
+ * LIBOS_LOG_BINARY_MAX_STRING bytes), so they don't need to be static.
+ * 
+ * IMPLEMENTORS:
+ * The platform has to implement libos_log_binary_write, which outputs the
+ * frame (and usually adds its own framing for the link).
+ */
+
+#pragma once
+#ifndef LIBOS_LOG_BINARY_H
+#define LIBOS_LOG_BINARY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "libos/log_deferred.h"
+
+/**
+ * @brief The maximum size in bytes of a single frame, longer frames are truncated at a argument.
+ */
+#ifndef LIBOS_LOG_BINARY_MAX_FRAME
+#define LIBOS_LOG_BINARY_MAX_FRAME 128
+#endif // LIBOS_LOG_BINARY_MAX_FRAME
+
+/**
+ * @brief The maximum number of bytes of a string argument that is copied in a frame.
+ */
+#ifndef LIBOS_LOG_BINARY_MAX_STRING
+#define LIBOS_LOG_BINARY_MAX_STRING 32
+#endif // LIBOS_LOG_BINARY_MAX_STRING
+
+#ifndef LIBOS_LOG_BINARY_FORMAT_ID
+#ifdef __cplusplus
+extern "C" const char __start_libos_log_fmt[];
+#else // __cplusplus
+extern const char __start_libos_log_fmt[];
+#endif // __cplusplus
+/**
+ * @brief The ID of the format string, by default the offset in the libos_log_fmt section.
+ */
+#define LIBOS_LOG_BINARY_FORMAT_ID(format) ((uint32_t)((uintptr_t)(format) - (uintptr_t)__start_libos_log_fmt))
+#endif // LIBOS_LOG_BINARY_FORMAT_ID
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Outputs a encoded frame, called by the LIBOS_LOG_* macros.
+ * 
+ * @details
+ * Implemented by the platform.
+ * 
+ * @param[in] frame The encoded frame.
+ * @param[in] length The number of bytes in @ref frame.
+ */
+void libos_log_binary_write(const uint8_t *frame, size_t length);
+
+static inline size_t libos_log_binary_put_varint_(uint8_t *buffer, size_t size, size_t offset, uintmax_t value)
+{
+    do
+    {
+        if (offset >= size)
+        {
+            return 0;
+        }
+        uint8_t byte = (uint8_t)(value & 0x7F);
+        value >>= 7;
+        buffer[offset++] = (uint8_t)(byte | (value != 0 ? 0x80 : 0));
+    } while (value != 0);
+    return offset;
+}
+
+static inline size_t libos_log_binary_put_arg_(uint8_t *buffer, size_t size, size_t offset, const libos_log_arg_t *arg)
+{
+    if (offset >= size)
+    {
+        return 0;
+    }
+    uint8_t arg_size = (arg->size > 8) ? 8 : arg->size;
+    buffer[offset++] = (uint8_t)((arg->type & 0x0F) | (arg_size << 4));
+
+    switch (arg->type)
+    {
+    case LIBOS_LOG_ARG_SIGNED:
+        // Zigzag, such that small negative values are short as well.
+        return libos_log_binary_put_varint_(buffer, size, offset, ((uintmax_t)arg->value.i << 1) ^ (uintmax_t)(arg->value.i < 0 ? -1 : 0));
+    case LIBOS_LOG_ARG_UNSIGNED:
+        return libos_log_binary_put_varint_(buffer, size, offset, arg->value.u);
+    case LIBOS_LOG_ARG_DOUBLE:
+    {
+        uint64_t bits;
+        memcpy(&bits, &arg->value.d, sizeof(bits));
+        if (size - offset < sizeof(bits))
+        {
+            return 0;
+        }
+        for (size_t i = 0; i < sizeof(bits); i++)
+        {
+            buffer[offset++] = (uint8_t)(bits >> (8 * i));
+        }
+        return offset;
+    }
+    case LIBOS_LOG_ARG_STRING:
+    {
+        const char *string = (arg->value.p != NULL) ? (const char*)arg->value.p : "(null)";
+        size_t length = 0;
+        while (length < LIBOS_LOG_BINARY_MAX_STRING && string[length] != '\0')
+        {
+            length++;
+        }
+        offset = libos_log_binary_put_varint_(buffer, size, offset, length);
+        if (offset == 0 || size - offset < length)
+        {
+            return 0;
+        }
+        memcpy(&buffer[offset], string, length);
+        return offset + length;
+    }
+    default:
+        return libos_log_binary_put_varint_(buffer, size, offset, (uintmax_t)(uintptr_t)arg->value.p);
+    }
+}
+
+/**
+ * @brief Encodes a log statement in a frame.
+ * 
+ * @details
+ * Arguments that don't fit in @ref size anymore are left out.
+ * 
+ * @param[out] buffer The buffer for the frame.
+ * @param[in] size The size of @ref buffer, at most 16384 bytes.
+ * @param[in] level The LIBOS_LOG_LEVEL_* of the statement.
+ * @param[in] timestamp The time of the statement.
+ * @param[in] format_id The ID of the format string.
+ * @param[in] args The arguments of the statement (without the format string).
+ * @param[in] count The number of elements in @ref args.
+ * 
+ * @return size_t The length of the frame, or 0 if not even the header fits.
+ */
+static inline size_t libos_log_binary_encode(uint8_t *buffer, size_t size, int level, libos_time_ticks_t timestamp, uint32_t format_id, const libos_log_arg_t *args, size_t count)
+{
+    // Leave room for a two byte length, move the payload if one is enough.
+    const size_t header = 2;
+    if (buffer == NULL || size <= header || size > 16384)
+    {
+        return 0;
+    }
+
+    size_t offset = header;
+    buffer[offset++] = (uint8_t)level;
+    offset = libos_log_binary_put_varint_(buffer, size, offset, timestamp);
+    if (offset != 0)
+    {
+        offset = libos_log_binary_put_varint_(buffer, size, offset, format_id);
+    }
+    if (offset == 0)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t next = libos_log_binary_put_arg_(buffer, size, offset, &args[i]);
+        if (next == 0)
+        {
+            break;
+        }
+        offset = next;
+    }
+
+    size_t payload = offset - header;
+    if (payload < 0x80)
+    {
+        buffer[1] = (uint8_t)payload;
+        memmove(&buffer[0], &buffer[1], payload + 1);
+        return payload + 1;
+    }
+    buffer[0] = (uint8_t)((payload & 0x7F) | 0x80);
+    buffer[1] = (uint8_t)(payload >> 7);
+    return offset;
+}
+
+/**
+ * @brief Encodes the log statement and hands it to libos_log_binary_write, called by LIBOS_LOG_BINARY.
+ * 
+ * @param[in] level The LIBOS_LOG_LEVEL_* of the statement.
+ * @param[in] args The format string (as first element) and the arguments.
+ * @param[in] count The number of elements in @ref args (at least 1).
+ */
+static inline void libos_log_binary_emit(int level, const libos_log_arg_t *args, size_t count)
+{
+    uint8_t frame[LIBOS_LOG_BINARY_MAX_FRAME];
+    size_t arg_count = (count - 1 > LIBOS_LOG_DEFERRED_MAX_ARGS) ? LIBOS_LOG_DEFERRED_MAX_ARGS : count - 1;
+    uint32_t id = (uint32_t)args[0].value.u;
+    size_t length = libos_log_binary_encode(frame, sizeof(frame), level, libos_time_ticks_now(), id, &args[1], arg_count);
+    if (length != 0)
+    {
+        libos_log_binary_write(frame, length);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+/**
+ * @brief Places the format string in the libos_log_fmt section, encodes the statement and outputs it.
+ * 
+ * @param level The LIBOS_LOG_LEVEL_* of the statement.
+ * @param ... The format string (a string literal) followed by at most LIBOS_LOG_DEFERRED_MAX_ARGS arguments.
+ */
+#define LIBOS_LOG_BINARY(level, ...) do { \
+        static const char libos_log_fmt_[] __attribute__((section("libos_log_fmt"), used)) = LIBOS_LOG_FORMAT_OF(__VA_ARGS__); \
+        const libos_log_arg_t libos_log_args_[] = { libos_log_arg_uint_(LIBOS_LOG_BINARY_FORMAT_ID(libos_log_fmt_)) LIBOS_LOG_PACK_REST(__VA_ARGS__) }; \
+        libos_log_binary_emit((int)(level), libos_log_args_, sizeof(libos_log_args_) / sizeof(libos_log_args_[0])); \
+    } while (0)
+
+#endif // LIBOS_LOG_BINARY_H
@@ -0,0 +1,210 @@
+/**
+ * @file log_buffered.h
+ * @brief Per-thread buffered log output, flushed in batches.
+ * 
+ * @details
+ * With LIBOS_LOG_ENABLE_BUFFERED set to 1, the LIBOS_LOG_* macros of log.h
+ * format the line in the caller, like normal logging, but append it to a
+ * buffer of the calling thread instead of writing it to the output. The
+ * buffer is handed to the platform with a single libos_log_buffered_write
+ * call when:
+ * 
+ *  * the next line doesn't fit anymore,
+ *  * the oldest line in the buffer is LIBOS_LOG_BUFFERED_FLUSH_MS old (checked
+ *    on every statement of the thread),
+ *  * a LIBOS_LOG_ERR statement is logged, so errors are never held back,
+ *  * or the thread calls libos_log_buffered_flush, for example before it
+ *    blocks for a long time.
+ * 
+ * This replaces a platform write (and the console lock) per line by one per
+ * buffer, which removes most of the contention when many threads log.
+ * 
+ * Because the threads flush independently, the lines of different threads
+ * are no longer interleaved in time order on the output. Every line starts
+ * with the libos_time_get_now timestamp in microseconds, zero padded to 12
+ * digits, so the original order can be restored by sorting the lines:
+ * 
+ * @code
+ * 000001234567 I net: link up
+ * @endcode
+ * 
+ * The tag is the name given to LIBOS_LOG_MODULE, so every file that logs has
+ * to register its module. Lines longer than LIBOS_LOG_BUFFERED_SIZE are
+ * truncated. The buffers are thread local and defined with
+ * LIBOS_LOG_BUFFERED_DEFINE in exactly one source file. A buffer is not
+ * flushed when its thread ends, call libos_log_buffered_flush before.
+ * 
+ * Unlike deferred logging, the statements can't be used from interrupts.
+ * 
+ * IMPLEMENTORS:
+ * The platform has to implement libos_log_buffered_write, which outputs the
+ * lines (each ended by a newline) in one go.
+ */
+
+#pragma once
+#ifndef LIBOS_LOG_BUFFERED_H
+#define LIBOS_LOG_BUFFERED_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "libos/error.h"
+#include "libos/time.h"
+#include "libos/platform/log.h"
+
+/**
+ * @brief The size in bytes of the buffer of a thread.
+ */
+#ifndef LIBOS_LOG_BUFFERED_SIZE
+#define LIBOS_LOG_BUFFERED_SIZE 512
+#endif // LIBOS_LOG_BUFFERED_SIZE
+
+/**
+ * @brief The maximum age in milliseconds of the oldest line before the buffer is flushed.
+ */
+#ifndef LIBOS_LOG_BUFFERED_FLUSH_MS
+#define LIBOS_LOG_BUFFERED_FLUSH_MS 100
+#endif // LIBOS_LOG_BUFFERED_FLUSH_MS
+
+/**
+ * @brief The tag of every line, by default the name given to LIBOS_LOG_MODULE.
+ */
+#ifndef LIBOS_LOG_BUFFERED_TAG
+#define LIBOS_LOG_BUFFERED_TAG libos_log_buffered_tag_
+#endif // LIBOS_LOG_BUFFERED_TAG
+
+/**
+ * @brief The buffer of a thread.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly.
+ */
+typedef struct {
+    libos_time_t oldest;                    ///< The timestamp of the first line in the buffer.
+    size_t length;                          ///< The number of used bytes.
+    char data[LIBOS_LOG_BUFFERED_SIZE];     ///< The lines.
+} libos_log_buffer_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+extern LIBOS_THREAD_LOCAL libos_log_buffer_t libos_log_buffer_;
+
+/**
+ * @brief Outputs the buffered lines, implemented by the platform.
+ * 
+ * @param[in] data The lines, each ended by a newline.
+ * @param[in] length The number of bytes in @ref data.
+ */
+void libos_log_buffered_write(const char *data, size_t length);
+
+/**
+ * @brief Outputs the lines buffered by the calling thread.
+ */
+static inline void libos_log_buffered_flush(void)
+{
+    libos_log_buffer_t *buffer = &libos_log_buffer_;
+    if (buffer->length > 0)
+    {
+        libos_log_buffered_write(buffer->data, buffer->length);
+        buffer->length = 0;
+    }
+}
+
+// Formats the line at the end of the buffer, returns the full length of the line (possibly not fitting).
+static inline size_t libos_log_buffered_format_(libos_log_buffer_t *buffer, long long timestamp_us, char level, const char *tag, const char *format, va_list args)
+{
+    char *line = &buffer->data[buffer->length];
+    size_t space = LIBOS_LOG_BUFFERED_SIZE - buffer->length;
+    int prefix = snprintf(line, space, "%012lld %c %s: ", timestamp_us, level, (tag != NULL) ? tag : "");
+    if (prefix < 0)
+    {
+        return 0;
+    }
+
+    size_t length = (size_t)prefix;
+    int message = vsnprintf((length < space) ? &line[length] : NULL, (length < space) ? space - length : 0, format, args);
+    length += (message > 0) ? (size_t)message : 0;
+    // The newline replaces the terminator, the buffer is not a string.
+    if (length < space)
+    {
+        line[length] = '\n';
+    }
+    return length + 1;
+}
+
+/**
+ * @brief Formats the line and appends it to the buffer of the calling thread, called by the LIBOS_LOG_* macros.
+ * 
+ * @param[in] level The LIBOS_LOG_LEVEL_* of the statement.
+ * @param[in] tag The LIBOS_LOG_BUFFERED_TAG of the statement.
+ * @param[in] format The printf style format string.
+ * @param[in] ... The arguments of the format string.
+ */
+static inline void libos_log_buffered_print(int level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+static inline void libos_log_buffered_print(int level, const char *tag, const char *format, ...)
+{
+    libos_log_buffer_t *buffer = &libos_log_buffer_;
+    const libos_time_t now = libos_time_get_now();
+    const long long timestamp_us = (long long)libos_time_to_us(now);
+    const char level_char = (level == LIBOS_LOG_LEVEL_ERR) ? 'E' :
+                            (level == LIBOS_LOG_LEVEL_WRN) ? 'W' :
+                            (level == LIBOS_LOG_LEVEL_INF) ? 'I' : 'D';
+
+    va_list args;
+    va_start(args, format);
+    va_list retry;
+    va_copy(retry, args);
+    size_t length = libos_log_buffered_format_(buffer, timestamp_us, level_char, tag, format, args);
+    if (buffer->length + length > LIBOS_LOG_BUFFERED_SIZE && buffer->length > 0)
+    {
+        // Doesn't fit behind the lines that are already buffered, output those first.
+        libos_log_buffered_flush();
+        length = libos_log_buffered_format_(buffer, timestamp_us, level_char, tag, format, retry);
+    }
+    va_end(retry);
+    va_end(args);
+
+    if (buffer->length == 0)
+    {
+        buffer->oldest = now;
+    }
+    if (length > LIBOS_LOG_BUFFERED_SIZE)
+    {
+        // Longer than the whole buffer, keep the start and end it with a newline.
+        length = LIBOS_LOG_BUFFERED_SIZE;
+        buffer->data[LIBOS_LOG_BUFFERED_SIZE - 1] = '\n';
+    }
+    buffer->length += length;
+
+    if (level == LIBOS_LOG_LEVEL_ERR
+        || buffer->length == LIBOS_LOG_BUFFERED_SIZE
+        || libos_time_difference_ms(buffer->oldest, now) >= LIBOS_LOG_BUFFERED_FLUSH_MS)
+    {
+        libos_log_buffered_flush();
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+/**
+ * @brief Defines the buffers, has to be used in exactly one source file at file scope.
+ */
+#define LIBOS_LOG_BUFFERED_DEFINE() LIBOS_THREAD_LOCAL libos_log_buffer_t libos_log_buffer_
+
+/**
+ * @brief Defines the tag of the file, used by LIBOS_LOG_MODULE.
+ */
+#define LIBOS_LOG_BUFFERED_MODULE(log_name) static const char libos_log_buffered_tag_[] __attribute__((unused)) = #log_name
+
+/**
+ * @brief Formats the statement into the buffer of the thread.
+ */
+#define LIBOS_LOG_BUFFERED(level, ...) libos_log_buffered_print((int)(level), LIBOS_LOG_BUFFERED_TAG, __VA_ARGS__)
+
+#endif // LIBOS_LOG_BUFFERED_H
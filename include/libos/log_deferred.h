@@ -0,0 +1,622 @@
+/**
+ * @file log_deferred.h
+ * @brief Deferred logging: capture now, format and output later.
+ * 
+ * @details
+ * With LIBOS_LOG_ENABLE_DEFERRED set to 1, the LIBOS_LOG_* macros of log.h
+ * don't format and output the message in the caller. Instead they capture a
+ * timestamp, the level, the pointer to the format string and the raw values
+ * of the arguments in a libos_log_record_t, and hand it to the platform with
+ * libos_log_deferred_push. A background task takes the records out of the
+ * ring, formats them with libos_log_record_format and outputs them in
+ * batches. This takes the I/O (and the formatting) out of time critical code.
+ * 
+ * Because only pointers are captured, every string argument (%s) and the
+ * format string itself have to outlive the record, in practice they have to
+ * be string literals or other static strings. At most LIBOS_LOG_DEFERRED_MAX_ARGS
+ * arguments are supported. The '*' width and precision and %n are not
+ * supported and are copied as text.
+ * 
+ * The record is stored in a libos_log_ring_t, a bounded lock-free queue that
+ * supports multiple producers (tasks and interrupts) and a single consumer
+ * (the background task). When the ring is full the record is dropped and
+ * counted, logging never blocks.
+ * 
+ * IMPLEMENTORS:
+ * The platform has to implement libos_log_deferred_push, which usually
+ * selects the ring of the current core, pushes the record with
+ * libos_log_ring_push and wakes the background task. The background task is
+ * also part of the platform, see libos_log_ring_drain. The macro
+ * LIBOS_LOG_DEFERRED_TAG can be defined by the platform to a string that
+ * identifies the module (like the name given to LIBOS_LOG_MODULE), by
+ * default no tag is captured.
+ */
+
+#pragma once
+#ifndef LIBOS_LOG_DEFERRED_H
+#define LIBOS_LOG_DEFERRED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libos/error.h"
+#include "libos/time.h"
+#include "libos/concurrent/atomic.h"
+
+/**
+ * @brief The maximum number of arguments (besides the format string) of a deferred log statement.
+ */
+#ifndef LIBOS_LOG_DEFERRED_MAX_ARGS
+#define LIBOS_LOG_DEFERRED_MAX_ARGS 8
+#endif // LIBOS_LOG_DEFERRED_MAX_ARGS
+
+#if LIBOS_LOG_DEFERRED_MAX_ARGS > 15
+#error "LIBOS_LOG_DEFERRED_MAX_ARGS can be at most 15, the argument packing macros count up to 16 including the format string."
+#endif // LIBOS_LOG_DEFERRED_MAX_ARGS > 15
+
+/**
+ * @brief The tag captured with every record, a string constant or NULL.
+ */
+#ifndef LIBOS_LOG_DEFERRED_TAG
+#define LIBOS_LOG_DEFERRED_TAG NULL
+#endif // LIBOS_LOG_DEFERRED_TAG
+
+/**
+ * @brief The kind of value stored in a libos_log_arg_t.
+ */
+#define LIBOS_LOG_ARG_SIGNED   0 ///< A signed integer, in value.i.
+#define LIBOS_LOG_ARG_UNSIGNED 1 ///< A unsigned integer (or bool), in value.u.
+#define LIBOS_LOG_ARG_DOUBLE   2 ///< A floating point number, in value.d.
+#define LIBOS_LOG_ARG_POINTER  3 ///< A pointer, in value.p.
+#define LIBOS_LOG_ARG_STRING   4 ///< A (const) char pointer, in value.p.
+
+/**
+ * @brief A single captured argument of a log statement.
+ */
+typedef struct {
+    union {
+        intmax_t i;
+        uintmax_t u;
+        double d;
+        const void *p;
+    } value;      ///< The value of the argument.
+    uint8_t type; ///< The LIBOS_LOG_ARG_* kind of the value.
+    uint8_t size; ///< The size in bytes of the original type.
+} libos_log_arg_t;
+
+/**
+ * @brief A captured log statement.
+ */
+typedef struct {
+    libos_time_ticks_t timestamp;                       ///< The libos_time_ticks_now when the statement was executed.
+    const char *tag;                                    ///< The LIBOS_LOG_DEFERRED_TAG of the statement.
+    const char *format;                                 ///< The printf style format string.
+    int level;                                          ///< The LIBOS_LOG_LEVEL_* of the statement.
+    uint8_t arg_count;                                  ///< The number of used elements in args.
+    libos_log_arg_t args[LIBOS_LOG_DEFERRED_MAX_ARGS];  ///< The arguments of the format string.
+} libos_log_record_t;
+
+/**
+ * @brief A slot of the ring, the record with its sequence number.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly.
+ */
+typedef struct {
+    libos_atomic_size_t sequence;
+    libos_log_record_t record;
+} libos_log_ring_slot_t;
+
+/**
+ * @brief Bounded multiple producer, single consumer queue of log records.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly.
+ */
+typedef struct {
+    libos_atomic_size_t enqueue_pos;  ///< The next position to claim by a producer.
+    libos_atomic_uint32_t dropped;    ///< The number of records dropped because the ring was full.
+    size_t dequeue_pos;               ///< The next position to read by the consumer.
+    libos_log_ring_slot_t *slots;     ///< The storage of the records.
+    size_t mask;                      ///< The number of slots minus one.
+} libos_log_ring_t;
+
+/**
+ * @def LIBOS_LOG_RING_STATIC_DATA_STRUCT(name, capacity)
+ * @brief Define the storage for a ring of @ref capacity records with @ref name.
+ * 
+ * @param[in] name The name of the storage variable.
+ * @param[in] capacity The number of records, must be a power of two.
+ */
+#define LIBOS_LOG_RING_STATIC_DATA_STRUCT(name, capacity) libos_log_ring_slot_t name[(capacity)]
+
+/**
+ * @def LIBOS_LOG_RING_CREATE_STATIC(static_data_name, ring)
+ * @brief Initializes the ring with the storage defined by LIBOS_LOG_RING_STATIC_DATA_STRUCT.
+ * 
+ * @details
+ * The parameter are names for the variables, they are NOT pointers yet.
+ * 
+ * @param[in] static_data_name The name of of the variable for the storage.
+ * @param[in] ring The name of the libos_log_ring_t variable to initialize.
+ * 
+ * @return libos_err_t The result of libos_log_ring_init.
+ */
+#define LIBOS_LOG_RING_CREATE_STATIC(static_data_name, ring) libos_log_ring_init(&(ring), (static_data_name), sizeof(static_data_name) / sizeof((static_data_name)[0]))
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Hands a captured log statement to the platform, called by the LIBOS_LOG_* macros.
+ * 
+ * @details
+ * Implemented by the platform. This must not block, and can be called from
+ * interrupts.
+ * 
+ * @param[in] level The LIBOS_LOG_LEVEL_* of the statement.
+ * @param[in] tag The LIBOS_LOG_DEFERRED_TAG of the statement.
+ * @param[in] args The format string (as first element) and the arguments.
+ * @param[in] count The number of elements in @ref args (at least 1).
+ */
+void libos_log_deferred_push(int level, const char *tag, const libos_log_arg_t *args, size_t count);
+
+/**
+ * @brief Initializes a empty ring.
+ * 
+ * @param[out] ring The ring to initialize.
+ * @param[in] slots The storage of the ring.
+ * @param[in] capacity The number of slots, must be a power of two.
+ * 
+ * @retval LIBOS_ERR_OK The ring is initialized.
+ * @retval LIBOS_ERR_INVALID_ARG @ref ring and/or @ref slots is NULL, or @ref capacity is not a power of two.
+ * 
+ * @return libos_err_t The libos standard success code for initializing the ring.
+ */
+static inline libos_err_t libos_log_ring_init(libos_log_ring_t *ring, libos_log_ring_slot_t *slots, size_t capacity)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(ring);
+    LIBOS_ERR_RET_ARG_NOT_NULL(slots);
+    LIBOS_ERR_RET_ON_TRUE(capacity == 0 || (capacity & (capacity - 1)) != 0, LIBOS_ERR_INVALID_ARG);
+
+    for (size_t i = 0; i < capacity; i++)
+    {
+        LIBOS_ATOMIC_INIT(&slots[i].sequence, i);
+    }
+    ring->slots = slots;
+    ring->mask = capacity - 1;
+    ring->dequeue_pos = 0;
+    LIBOS_ATOMIC_INIT(&ring->enqueue_pos, 0);
+    LIBOS_ATOMIC_INIT(&ring->dropped, 0);
+    return LIBOS_ERR_OK;
+}
+
+/**
+ * @brief Captures a log statement in the ring, lock-free and safe from multiple tasks and interrupts.
+ * 
+ * @param[in] ring The ring to push to.
+ * @param[in] level The LIBOS_LOG_LEVEL_* of the statement.
+ * @param[in] tag The tag of the statement.
+ * @param[in] args The format string (as first element) and the arguments.
+ * @param[in] count The number of elements in @ref args (at least 1).
+ * 
+ * @retval true The record is stored.
+ * @retval false The ring is full, the record is dropped and counted.
+ */
+static inline bool libos_log_ring_push(libos_log_ring_t *ring, int level, const char *tag, const libos_log_arg_t *args, size_t count)
+{
+    libos_time_ticks_t timestamp = libos_time_ticks_now();
+    size_t pos = LIBOS_ATOMIC_LOAD(&ring->enqueue_pos, LIBOS_ATOMIC_RELAXED);
+    libos_log_ring_slot_t *slot;
+    while (true)
+    {
+        slot = &ring->slots[pos & ring->mask];
+        size_t sequence = LIBOS_ATOMIC_LOAD(&slot->sequence, LIBOS_ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0)
+        {
+            // The slot is free for this position, claim it.
+            if (LIBOS_ATOMIC_COMPARE_EXCHANGE_WEAK(&ring->enqueue_pos, &pos, pos + 1, LIBOS_ATOMIC_RELAXED, LIBOS_ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The consumer hasn't freed the slot yet.
+            LIBOS_ATOMIC_FETCH_ADD(&ring->dropped, 1, LIBOS_ATOMIC_RELAXED);
+            return false;
+        }
+        else
+        {
+            pos = LIBOS_ATOMIC_LOAD(&ring->enqueue_pos, LIBOS_ATOMIC_RELAXED);
+        }
+    }
+
+    size_t arg_count = count - 1;
+    if (arg_count > LIBOS_LOG_DEFERRED_MAX_ARGS)
+    {
+        arg_count = LIBOS_LOG_DEFERRED_MAX_ARGS;
+    }
+    slot->record.timestamp = timestamp;
+    slot->record.tag = tag;
+    slot->record.format = (const char*)args[0].value.p;
+    slot->record.level = level;
+    slot->record.arg_count = (uint8_t)arg_count;
+    memcpy(slot->record.args, &args[1], arg_count * sizeof(args[0]));
+
+    LIBOS_ATOMIC_STORE(&slot->sequence, pos + 1, LIBOS_ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief Takes the oldest record out of the ring, only to be called by the single consumer.
+ * 
+ * @param[in] ring The ring to pop from.
+ * @param[out] record The place to copy the record to.
+ * 
+ * @retval true A record is copied.
+ * @retval false The ring is empty (or the oldest record is still being written).
+ */
+static inline bool libos_log_ring_pop(libos_log_ring_t *ring, libos_log_record_t *record)
+{
+    libos_log_ring_slot_t *slot = &ring->slots[ring->dequeue_pos & ring->mask];
+    size_t sequence = LIBOS_ATOMIC_LOAD(&slot->sequence, LIBOS_ATOMIC_ACQUIRE);
+    if (sequence != ring->dequeue_pos + 1)
+    {
+        return false;
+    }
+
+    *record = slot->record;
+    LIBOS_ATOMIC_STORE(&slot->sequence, ring->dequeue_pos + ring->mask + 1, LIBOS_ATOMIC_RELEASE);
+    ring->dequeue_pos++;
+    return true;
+}
+
+/**
+ * @brief Returns the number of dropped records since the last call, and resets it.
+ * 
+ * @param[in] ring The ring.
+ * 
+ * @return uint32_t The number of records dropped because the ring was full.
+ */
+static inline uint32_t libos_log_ring_take_dropped(libos_log_ring_t *ring)
+{
+    return LIBOS_ATOMIC_EXCHANGE(&ring->dropped, 0, LIBOS_ATOMIC_RELAXED);
+}
+
+/**
+ * @brief The function called for every record by libos_log_ring_drain.
+ * 
+ * @param record The record to output.
+ * @param context The context given to libos_log_ring_drain.
+ */
+typedef void (*libos_log_record_handler_t)(const libos_log_record_t *record, void *context);
+
+/**
+ * @brief Takes up to @ref max records out of the ring and gives them to @ref handler, to output a batch at once.
+ * 
+ * @param[in] ring The ring to drain.
+ * @param[in] handler The function to call for every record.
+ * @param[in] context The context for @ref handler.
+ * @param[in] max The maximum number of records to handle.
+ * 
+ * @return size_t The number of records handled.
+ */
+static inline size_t libos_log_ring_drain(libos_log_ring_t *ring, libos_log_record_handler_t handler, void *context, size_t max)
+{
+    libos_log_record_t record;
+    size_t count = 0;
+    while (count < max && libos_log_ring_pop(ring, &record))
+    {
+        handler(&record, context);
+        count++;
+    }
+    return count;
+}
+
+static inline intmax_t libos_log_arg_as_signed_(const libos_log_arg_t *arg)
+{
+    switch (arg->type)
+    {
+    case LIBOS_LOG_ARG_SIGNED: return arg->value.i;
+    case LIBOS_LOG_ARG_UNSIGNED: return (intmax_t)arg->value.u;
+    case LIBOS_LOG_ARG_DOUBLE: return (intmax_t)arg->value.d;
+    default: return (intmax_t)(uintptr_t)arg->value.p;
+    }
+}
+
+static inline uintmax_t libos_log_arg_as_unsigned_(const libos_log_arg_t *arg)
+{
+    switch (arg->type)
+    {
+    case LIBOS_LOG_ARG_SIGNED:
+    {
+        // Behave like printf, which sees the value promoted to (at least) int.
+        size_t size = arg->size < sizeof(int) ? sizeof(int) : arg->size;
+        uintmax_t value = (uintmax_t)arg->value.i;
+        if (size < sizeof(uintmax_t))
+        {
+            value &= (UINTMAX_C(1) << (size * 8)) - 1;
+        }
+        return value;
+    }
+    case LIBOS_LOG_ARG_UNSIGNED: return arg->value.u;
+    case LIBOS_LOG_ARG_DOUBLE: return (uintmax_t)arg->value.d;
+    default: return (uintmax_t)(uintptr_t)arg->value.p;
+    }
+}
+
+static inline double libos_log_arg_as_double_(const libos_log_arg_t *arg)
+{
+    switch (arg->type)
+    {
+    case LIBOS_LOG_ARG_SIGNED: return (double)arg->value.i;
+    case LIBOS_LOG_ARG_UNSIGNED: return (double)arg->value.u;
+    case LIBOS_LOG_ARG_DOUBLE: return arg->value.d;
+    default: return 0.0;
+    }
+}
+
+/**
+ * @brief Formats the message of the record like snprintf would have done at the time of the statement.
+ * 
+ * @details
+ * The output is always terminated, and truncated if it doesn't fit.
+ * 
+ * @param[out] buffer The buffer for the message.
+ * @param[in] size The size of @ref buffer in bytes.
+ * @param[in] record The record to format.
+ * 
+ * @return size_t The length of the message in @ref buffer (without the terminator).
+ */
+static inline size_t libos_log_record_format(char *buffer, size_t size, const libos_log_record_t *record)
+{
+    if (buffer == NULL || size == 0)
+    {
+        return 0;
+    }
+
+    const char *format = (record->format != NULL) ? record->format : "";
+    size_t length = 0;
+    size_t next_arg = 0;
+    while (*format != '\0' && length + 1 < size)
+    {
+        if (format[0] != '%')
+        {
+            buffer[length++] = *format++;
+            continue;
+        }
+        if (format[1] == '%')
+        {
+            buffer[length++] = '%';
+            format += 2;
+            continue;
+        }
+
+        // Copy the flags, width and precision, replace the length modifier by the one of the stored type.
+        const char *start = format;
+        char spec[24];
+        size_t spec_length = 0;
+        spec[spec_length++] = *format++;
+        while (*format != '\0' && strchr("-+ #0123456789.", *format) != NULL && spec_length < sizeof(spec) - 3)
+        {
+            spec[spec_length++] = *format++;
+        }
+        while (*format != '\0' && strchr("hljztL", *format) != NULL)
+        {
+            format++;
+        }
+
+        char conversion = *format;
+        if (conversion == '\0' || strchr("diouxXcsfFeEgGaAp", conversion) == NULL || next_arg >= record->arg_count)
+        {
+            // Not supported or no argument for it, output it as text.
+            while (start < format && length + 1 < size)
+            {
+                buffer[length++] = *start++;
+            }
+            continue;
+        }
+        format++;
+
+        const libos_log_arg_t *arg = &record->args[next_arg++];
+        size_t available = size - length;
+        int written;
+        switch (conversion)
+        {
+        case 'd':
+        case 'i':
+            spec[spec_length++] = 'j';
+            spec[spec_length++] = conversion;
+            spec[spec_length] = '\0';
+            written = snprintf(&buffer[length], available, spec, libos_log_arg_as_signed_(arg));
+            break;
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            spec[spec_length++] = 'j';
+            spec[spec_length++] = conversion;
+            spec[spec_length] = '\0';
+            written = snprintf(&buffer[length], available, spec, libos_log_arg_as_unsigned_(arg));
+            break;
+        case 'c':
+            spec[spec_length++] = conversion;
+            spec[spec_length] = '\0';
+            written = snprintf(&buffer[length], available, spec, (int)libos_log_arg_as_signed_(arg));
+            break;
+        case 's':
+            spec[spec_length++] = conversion;
+            spec[spec_length] = '\0';
+            written = snprintf(&buffer[length], available, spec,
+                ((arg->type == LIBOS_LOG_ARG_STRING || arg->type == LIBOS_LOG_ARG_POINTER) && arg->value.p != NULL) ? (const char*)arg->value.p : "(null)");
+            break;
+        case 'p':
+            spec[spec_length++] = conversion;
+            spec[spec_length] = '\0';
+            written = snprintf(&buffer[length], available, spec, (arg->type == LIBOS_LOG_ARG_STRING || arg->type == LIBOS_LOG_ARG_POINTER) ? arg->value.p : NULL);
+            break;
+        default:
+            spec[spec_length++] = conversion;
+            spec[spec_length] = '\0';
+            written = snprintf(&buffer[length], available, spec, libos_log_arg_as_double_(arg));
+            break;
+        }
+
+        if (written > 0)
+        {
+            length += ((size_t)written < available) ? (size_t)written : (available - 1);
+        }
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+#define LIBOS_LOG_ARG_FN_(suffix, c_type, arg_type, member, member_type) \
+    static inline libos_log_arg_t libos_log_arg_##suffix##_(c_type value) \
+    { \
+        libos_log_arg_t arg; \
+        arg.value.member = (member_type)value; \
+        arg.type = arg_type; \
+        arg.size = (uint8_t)sizeof(c_type); \
+        return arg; \
+    }
+
+LIBOS_LOG_ARG_FN_(bool, bool, LIBOS_LOG_ARG_UNSIGNED, u, uintmax_t)
+LIBOS_LOG_ARG_FN_(char, char, (((char)-1) < 0) ? LIBOS_LOG_ARG_SIGNED : LIBOS_LOG_ARG_UNSIGNED, i, intmax_t)
+LIBOS_LOG_ARG_FN_(schar, signed char, LIBOS_LOG_ARG_SIGNED, i, intmax_t)
+LIBOS_LOG_ARG_FN_(uchar, unsigned char, LIBOS_LOG_ARG_UNSIGNED, u, uintmax_t)
+LIBOS_LOG_ARG_FN_(short, short, LIBOS_LOG_ARG_SIGNED, i, intmax_t)
+LIBOS_LOG_ARG_FN_(ushort, unsigned short, LIBOS_LOG_ARG_UNSIGNED, u, uintmax_t)
+LIBOS_LOG_ARG_FN_(int, int, LIBOS_LOG_ARG_SIGNED, i, intmax_t)
+LIBOS_LOG_ARG_FN_(uint, unsigned int, LIBOS_LOG_ARG_UNSIGNED, u, uintmax_t)
+LIBOS_LOG_ARG_FN_(long, long, LIBOS_LOG_ARG_SIGNED, i, intmax_t)
+LIBOS_LOG_ARG_FN_(ulong, unsigned long, LIBOS_LOG_ARG_UNSIGNED, u, uintmax_t)
+LIBOS_LOG_ARG_FN_(llong, long long, LIBOS_LOG_ARG_SIGNED, i, intmax_t)
+LIBOS_LOG_ARG_FN_(ullong, unsigned long long, LIBOS_LOG_ARG_UNSIGNED, u, uintmax_t)
+LIBOS_LOG_ARG_FN_(float, float, LIBOS_LOG_ARG_DOUBLE, d, double)
+LIBOS_LOG_ARG_FN_(double, double, LIBOS_LOG_ARG_DOUBLE, d, double)
+LIBOS_LOG_ARG_FN_(ldouble, long double, LIBOS_LOG_ARG_DOUBLE, d, double)
+LIBOS_LOG_ARG_FN_(pointer, const volatile void *, LIBOS_LOG_ARG_POINTER, p, const void *)
+LIBOS_LOG_ARG_FN_(string, const char *, LIBOS_LOG_ARG_STRING, p, const void *)
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#ifdef __cplusplus
+// C++ has no _Generic, select the capture function by overloading.
+static inline libos_log_arg_t libos_log_arg_(bool value) { return libos_log_arg_bool_(value); }
+static inline libos_log_arg_t libos_log_arg_(char value) { return libos_log_arg_char_(value); }
+static inline libos_log_arg_t libos_log_arg_(signed char value) { return libos_log_arg_schar_(value); }
+static inline libos_log_arg_t libos_log_arg_(unsigned char value) { return libos_log_arg_uchar_(value); }
+static inline libos_log_arg_t libos_log_arg_(short value) { return libos_log_arg_short_(value); }
+static inline libos_log_arg_t libos_log_arg_(unsigned short value) { return libos_log_arg_ushort_(value); }
+static inline libos_log_arg_t libos_log_arg_(int value) { return libos_log_arg_int_(value); }
+static inline libos_log_arg_t libos_log_arg_(unsigned int value) { return libos_log_arg_uint_(value); }
+static inline libos_log_arg_t libos_log_arg_(long value) { return libos_log_arg_long_(value); }
+static inline libos_log_arg_t libos_log_arg_(unsigned long value) { return libos_log_arg_ulong_(value); }
+static inline libos_log_arg_t libos_log_arg_(long long value) { return libos_log_arg_llong_(value); }
+static inline libos_log_arg_t libos_log_arg_(unsigned long long value) { return libos_log_arg_ullong_(value); }
+static inline libos_log_arg_t libos_log_arg_(float value) { return libos_log_arg_float_(value); }
+static inline libos_log_arg_t libos_log_arg_(double value) { return libos_log_arg_double_(value); }
+static inline libos_log_arg_t libos_log_arg_(long double value) { return libos_log_arg_ldouble_(value); }
+static inline libos_log_arg_t libos_log_arg_(const volatile void *value) { return libos_log_arg_pointer_(value); }
+static inline libos_log_arg_t libos_log_arg_(const char *value) { return libos_log_arg_string_(value); }
+#define LIBOS_LOG_ARG_(x) libos_log_arg_(x)
+#else // __cplusplus
+#define LIBOS_LOG_ARG_(x) _Generic((x), \
+    bool: libos_log_arg_bool_, \
+    char: libos_log_arg_char_, \
+    signed char: libos_log_arg_schar_, \
+    unsigned char: libos_log_arg_uchar_, \
+    short: libos_log_arg_short_, \
+    unsigned short: libos_log_arg_ushort_, \
+    int: libos_log_arg_int_, \
+    unsigned int: libos_log_arg_uint_, \
+    long: libos_log_arg_long_, \
+    unsigned long: libos_log_arg_ulong_, \
+    long long: libos_log_arg_llong_, \
+    unsigned long long: libos_log_arg_ullong_, \
+    float: libos_log_arg_float_, \
+    double: libos_log_arg_double_, \
+    long double: libos_log_arg_ldouble_, \
+    char *: libos_log_arg_string_, \
+    const char *: libos_log_arg_string_, \
+    default: libos_log_arg_pointer_)(x)
+#endif // __cplusplus
+
+// Counts the arguments (1 to 16) and applies LIBOS_LOG_ARG_ to each of them.
+#define LIBOS_LOG_NARGS_(...) LIBOS_LOG_NARGS_IMPL_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LIBOS_LOG_NARGS_IMPL_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) N
+#define LIBOS_LOG_CONCAT_(a, b) LIBOS_LOG_CONCAT_IMPL_(a, b)
+#define LIBOS_LOG_CONCAT_IMPL_(a, b) a##b
+#define LIBOS_LOG_PACK_1_(a) LIBOS_LOG_ARG_(a)
+#define LIBOS_LOG_PACK_2_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_1_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_3_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_2_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_4_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_3_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_5_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_4_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_6_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_5_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_7_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_6_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_8_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_7_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_9_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_8_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_10_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_9_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_11_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_10_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_12_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_11_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_13_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_12_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_14_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_13_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_15_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_14_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_16_(a, ...) LIBOS_LOG_ARG_(a), LIBOS_LOG_PACK_15_(__VA_ARGS__)
+
+#define LIBOS_LOG_PACK_REST_1_(a)
+#define LIBOS_LOG_PACK_REST_2_(a, ...) , LIBOS_LOG_PACK_1_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_3_(a, ...) , LIBOS_LOG_PACK_2_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_4_(a, ...) , LIBOS_LOG_PACK_3_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_5_(a, ...) , LIBOS_LOG_PACK_4_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_6_(a, ...) , LIBOS_LOG_PACK_5_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_7_(a, ...) , LIBOS_LOG_PACK_6_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_8_(a, ...) , LIBOS_LOG_PACK_7_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_9_(a, ...) , LIBOS_LOG_PACK_8_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_10_(a, ...) , LIBOS_LOG_PACK_9_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_11_(a, ...) , LIBOS_LOG_PACK_10_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_12_(a, ...) , LIBOS_LOG_PACK_11_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_13_(a, ...) , LIBOS_LOG_PACK_12_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_14_(a, ...) , LIBOS_LOG_PACK_13_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_15_(a, ...) , LIBOS_LOG_PACK_14_(__VA_ARGS__)
+#define LIBOS_LOG_PACK_REST_16_(a, ...) , LIBOS_LOG_PACK_15_(__VA_ARGS__)
+
+/**
+ * @brief Captures the format string and arguments as a initializer list of libos_log_arg_t.
+ */
+#define LIBOS_LOG_PACK_ARGS(...) LIBOS_LOG_CONCAT_(LIBOS_LOG_PACK_, LIBOS_LOG_CONCAT_(LIBOS_LOG_NARGS_(__VA_ARGS__), _))(__VA_ARGS__)
+
+/**
+ * @brief Captures the arguments after the format string, as a initializer list that starts with a comma (or nothing).
+ */
+#define LIBOS_LOG_PACK_REST(...) LIBOS_LOG_CONCAT_(LIBOS_LOG_PACK_REST_, LIBOS_LOG_CONCAT_(LIBOS_LOG_NARGS_(__VA_ARGS__), _))(__VA_ARGS__)
+
+/**
+ * @brief Expands to the format string (the first argument) of a log statement.
+ */
+#define LIBOS_LOG_FORMAT_OF(...) LIBOS_LOG_FORMAT_OF_IMPL_(__VA_ARGS__, unused)
+#define LIBOS_LOG_FORMAT_OF_IMPL_(format, ...) format
+
+/**
+ * @brief Captures the log statement and hands it to libos_log_deferred_push.
+ * 
+ * @param level The LIBOS_LOG_LEVEL_* of the statement.
+ * @param ... The format string followed by at most LIBOS_LOG_DEFERRED_MAX_ARGS arguments.
+ */
+#define LIBOS_LOG_DEFERRED(level, ...) do { \
+        const libos_log_arg_t libos_log_args_[] = { LIBOS_LOG_PACK_ARGS(__VA_ARGS__) }; \
+        libos_log_deferred_push((int)(level), LIBOS_LOG_DEFERRED_TAG, libos_log_args_, sizeof(libos_log_args_) / sizeof(libos_log_args_[0])); \
+    } while (0)
+
+#endif // LIBOS_LOG_DEFERRED_H
@@ -0,0 +1,276 @@
+/**
+ * @file log_ratelimit.h
+ * @brief Per call site state of the rate-limited and sampled log statements.
+ * 
+ * @details
+ * The LIBOS_LOG_*_RATELIMITED and LIBOS_LOG_*_EVERY_N macros keep
+ * a static libos_log_ratelimit_t or libos_log_every_n_t per statement. The
+ * checks only use relaxed atomics on that state, so a log storm from many
+ * tasks doesn't add a lock on top of the output itself.
+ * 
+ * The rate limit uses a wrapping 32-bit millisecond clock and compares the
+ * time since the last output with the interval, so a statement that stays
+ * quiet for a long time is always output again. Only a statement that comes
+ * back exactly a multiple of 2^32 milliseconds (about 49.7 days) later,
+ * within one interval, is wrongly suppressed.
+ */
+
+#pragma once
+#ifndef LIBOS_LOG_RATELIMIT_H
+#define LIBOS_LOG_RATELIMIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "libos/log.h"
+#include "libos/time.h"
+#include "libos/concurrent/atomic.h"
+
+/**
+ * @brief The state of a rate-limited log statement, zero initialized (static) before use.
+ */
+typedef struct libos_log_ratelimit_s
+{
+    /**
+     * @brief The millisecond clock value of the last output, 0 before the first output.
+     */
+    libos_atomic_uint32_t last;
+    /**
+     * @brief The number of statements suppressed since the last output.
+     */
+    libos_atomic_uint32_t suppressed;
+} libos_log_ratelimit_t;
+
+/**
+ * @brief The state of a sampled log statement, zero initialized (static) before use.
+ */
+typedef struct libos_log_every_n_s
+{
+    /**
+     * @brief The number of times the statement was reached.
+     */
+    libos_atomic_uint32_t count;
+} libos_log_every_n_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief The wrapping millisecond clock used for the rate limit.
+ * 
+ * @return uint32_t The current time in milliseconds, modulo 2^32.
+ */
+static inline uint32_t libos_log_ratelimit_now(void)
+{
+    return (uint32_t)libos_time_to_ms(libos_time_get_now());
+}
+
+/**
+ * @brief Checks if a rate-limited statement is output.
+ * 
+ * @details
+ * The first statement is always output, after that at most one per
+ * @ref interval. When multiple tasks reach the statement at the same time
+ * only one of them outputs it.
+ * 
+ * @param[in,out] state The state of the statement.
+ * @param[in] now The current time, see libos_log_ratelimit_now.
+ * @param[in] interval The minimum time between two outputs in milliseconds.
+ * @param[out] suppressed The number of statements suppressed since the last output, only set when true is returned.
+ * 
+ * @retval true The statement has to be output.
+ * @retval false The statement is suppressed (and counted).
+ */
+static inline bool libos_log_ratelimit_check(libos_log_ratelimit_t *state, uint32_t now, uint32_t interval, uint32_t *suppressed)
+{
+    uint32_t last = LIBOS_ATOMIC_LOAD(&state->last, LIBOS_ATOMIC_RELAXED);
+    // The unsigned difference is right across a wrap of the clock, and never negative after a long silence.
+    if (last != 0 && (uint32_t)(now - last) < interval)
+    {
+        LIBOS_ATOMIC_FETCH_ADD(&state->suppressed, 1, LIBOS_ATOMIC_RELAXED);
+        return false;
+    }
+
+    // 0 is reserved for 'never output', a output at 0 is recorded 1 ms late.
+    uint32_t updated = (now == 0) ? 1 : now;
+    if (!LIBOS_ATOMIC_COMPARE_EXCHANGE(&state->last, &last, updated, LIBOS_ATOMIC_RELAXED, LIBOS_ATOMIC_RELAXED))
+    {
+        // Another task outputs it.
+        LIBOS_ATOMIC_FETCH_ADD(&state->suppressed, 1, LIBOS_ATOMIC_RELAXED);
+        return false;
+    }
+
+    *suppressed = LIBOS_ATOMIC_EXCHANGE(&state->suppressed, 0, LIBOS_ATOMIC_RELAXED);
+    return true;
+}
+
+/**
+ * @brief Checks if a sampled statement is output, which is the first and then every @ref n th time.
+ * 
+ * @param[in,out] state The state of the statement.
+ * @param[in] n The sample interval, 0 and 1 output every statement.
+ * 
+ * @retval true The statement has to be output.
+ * @retval false The statement is skipped.
+ */
+static inline bool libos_log_every_n_check(libos_log_every_n_t *state, uint32_t n)
+{
+    uint32_t count = LIBOS_ATOMIC_FETCH_ADD(&state->count, 1, LIBOS_ATOMIC_RELAXED);
+    return (n <= 1) || (count % n) == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+// Outputs the statement at most once per interval_ms, with the number of suppressed statements.
+#define LIBOS_LOG_RATELIMITED_(level, interval_ms, ...) do { \
+        if (LIBOS_LOG_IS_ENABLED_(level)) \
+        { \
+            static libos_log_ratelimit_t libos_log_ratelimit_; \
+            uint32_t libos_log_suppressed_ = 0; \
+            if (libos_log_ratelimit_check(&libos_log_ratelimit_, libos_log_ratelimit_now(), (uint32_t)(interval_ms), &libos_log_suppressed_)) \
+            { \
+                if (libos_log_suppressed_ != 0) \
+                { \
+                    LIBOS_LOG_EMIT_(level, "%u similar messages suppressed", (unsigned int)libos_log_suppressed_); \
+                } \
+                LIBOS_LOG_EMIT_(level, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+// Outputs the first and then every n-th statement.
+#define LIBOS_LOG_EVERY_N_(level, n, ...) do { \
+        if (LIBOS_LOG_IS_ENABLED_(level)) \
+        { \
+            static libos_log_every_n_t libos_log_every_n_; \
+            if (libos_log_every_n_check(&libos_log_every_n_, (uint32_t)(n))) \
+            { \
+                LIBOS_LOG_EMIT_(level, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+#if LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_ERR
+/**
+ * @brief Logs a error message at most once per @ref interval_ms milliseconds, if the log level minimum allows.
+ * 
+ * @details
+ * The number of suppressed messages is output before the next message.
+ */
+#define LIBOS_LOG_ERR_RATELIMITED(interval_ms, ...) LIBOS_LOG_RATELIMITED_(LIBOS_LOG_LEVEL_ERR, interval_ms, __VA_ARGS__)
+
+/**
+ * @brief Logs the first and then every @ref n th error message, if the log level minimum allows.
+ * 
+ */
+#define LIBOS_LOG_ERR_EVERY_N(n, ...) LIBOS_LOG_EVERY_N_(LIBOS_LOG_LEVEL_ERR, n, __VA_ARGS__)
+#else
+/**
+ * @brief Logs a error message at most once per @ref interval_ms milliseconds, if the log level minimum allows.
+ * 
+ * @details
+ * The number of suppressed messages is output before the next message.
+ */
+#define LIBOS_LOG_ERR_RATELIMITED(interval_ms, ...)
+
+/**
+ * @brief Logs the first and then every @ref n th error message, if the log level minimum allows.
+ * 
+ */
+#define LIBOS_LOG_ERR_EVERY_N(n, ...)
+#endif // LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_ERR
+
+#if LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_WRN
+/**
+ * @brief Logs a warning message at most once per @ref interval_ms milliseconds, if the log level minimum allows.
+ * 
+ * @details
+ * The number of suppressed messages is output before the next message.
+ */
+#define LIBOS_LOG_WRN_RATELIMITED(interval_ms, ...) LIBOS_LOG_RATELIMITED_(LIBOS_LOG_LEVEL_WRN, interval_ms, __VA_ARGS__)
+
+/**
+ * @brief Logs the first and then every @ref n th warning message, if the log level minimum allows.
+ * 
+ */
+#define LIBOS_LOG_WRN_EVERY_N(n, ...) LIBOS_LOG_EVERY_N_(LIBOS_LOG_LEVEL_WRN, n, __VA_ARGS__)
+#else
+/**
+ * @brief Logs a warning message at most once per @ref interval_ms milliseconds, if the log level minimum allows.
+ * 
+ * @details
+ * The number of suppressed messages is output before the next message.
+ */
+#define LIBOS_LOG_WRN_RATELIMITED(interval_ms, ...)
+
+/**
+ * @brief Logs the first and then every @ref n th warning message, if the log level minimum allows.
+ * 
+ */
+#define LIBOS_LOG_WRN_EVERY_N(n, ...)
+#endif // LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_WRN
+
+#if LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_INF
+/**
+ * @brief Logs a info message at most once per @ref interval_ms milliseconds, if the log level minimum allows.
+ * 
+ * @details
+ * The number of suppressed messages is output before the next message.
+ */
+#define LIBOS_LOG_INF_RATELIMITED(interval_ms, ...) LIBOS_LOG_RATELIMITED_(LIBOS_LOG_LEVEL_INF, interval_ms, __VA_ARGS__)
+
+/**
+ * @brief Logs the first and then every @ref n th info message, if the log level minimum allows.
+ * 
+ */
+#define LIBOS_LOG_INF_EVERY_N(n, ...) LIBOS_LOG_EVERY_N_(LIBOS_LOG_LEVEL_INF, n, __VA_ARGS__)
+#else
+/**
+ * @brief Logs a info message at most once per @ref interval_ms milliseconds, if the log level minimum allows.
+ * 
+ * @details
+ * The number of suppressed messages is output before the next message.
+ */
+#define LIBOS_LOG_INF_RATELIMITED(interval_ms, ...)
+
+/**
+ * @brief Logs the first and then every @ref n th info message, if the log level minimum allows.
+ * 
+ */
+#define LIBOS_LOG_INF_EVERY_N(n, ...)
+#endif // LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_INF
+
+#if LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_DBG
+/**
+ * @brief Logs a debug message at most once per @ref interval_ms milliseconds, if the log level minimum allows.
+ * 
+ * @details
+ * The number of suppressed messages is output before the next message.
+ */
+#define LIBOS_LOG_DBG_RATELIMITED(interval_ms, ...) LIBOS_LOG_RATELIMITED_(LIBOS_LOG_LEVEL_DBG, interval_ms, __VA_ARGS__)
+
+/**
+ * @brief Logs the first and then every @ref n th debug message, if the log level minimum allows.
+ * 
+ */
+#define LIBOS_LOG_DBG_EVERY_N(n, ...) LIBOS_LOG_EVERY_N_(LIBOS_LOG_LEVEL_DBG, n, __VA_ARGS__)
+#else
+/**
+ * @brief Logs a debug message at most once per @ref interval_ms milliseconds, if the log level minimum allows.
+ * 
+ * @details
+ * The number of suppressed messages is output before the next message.
+ */
+#define LIBOS_LOG_DBG_RATELIMITED(interval_ms, ...)
+
+/**
+ * @brief Logs the first and then every @ref n th debug message, if the log level minimum allows.
+ * 
+ */
+#define LIBOS_LOG_DBG_EVERY_N(n, ...)
+#endif // LIBOS_LOG_LEVEL_MIN >= LIBOS_LOG_LEVEL_DBG
+
+#endif // LIBOS_LOG_RATELIMIT_H
@@ -0,0 +1,163 @@
+/**
+ * @file log_runtime.h
+ * @brief Per-module log levels that can be changed at run-time.
+ * 
+ * @details
+ * With LIBOS_LOG_ENABLE_RUNTIME_LEVEL set to 1, LIBOS_LOG_MODULE also
+ * defines a libos_log_module_t for the file. Every LIBOS_LOG_* statement
+ * first compares its level with the level of the module (a single relaxed
+ * load and compare) and only evaluates the arguments and calls the backend
+ * if the level is enabled. The level of a module can be changed by name
+ * with libos_log_set_level, for example to enable debug output of one
+ * module in the field.
+ * 
+ * The compile-time minimum (LIBOS_LOG_LEVEL_MIN) still applies: statements
+ * below it are not compiled in and can't be enabled at run-time. To be
+ * able to enable the debug statements, LIBOS_LOG_LEVEL_MIN has to be
+ * LIBOS_LOG_LEVEL_DBG and LIBOS_LOG_LEVEL_DEFAULT the level the modules
+ * start with.
+ * 
+ * The levels have to be integers that increase with the verbosity
+ * (ERR < WRN < INF < DBG), like the compile-time minimum already requires.
+ * 
+ * The descriptors are collected in the libos_log_modules section, and found
+ * through the __start_libos_log_modules and __stop_libos_log_modules symbols
+ * that GNU ld provides. When the platform links with --gc-sections the
+ * section has to be kept, like:
+ * 
+ * @code
+ * libos_log_modules : { KEEP(*(libos_log_modules)) }
+ * @endcode
+ */
+
+#pragma once
+#ifndef LIBOS_LOG_RUNTIME_H
+#define LIBOS_LOG_RUNTIME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "libos/error.h"
+#include "libos/concurrent/atomic.h"
+
+/**
+ * @brief The run-time level of a log module.
+ */
+typedef struct libos_log_module_s
+{
+    /**
+     * @brief The name given to LIBOS_LOG_MODULE.
+     */
+    const char *name;
+    /**
+     * @brief The most verbose LIBOS_LOG_LEVEL_* that is output.
+     */
+    libos_atomic_uint32_t level;
+} libos_log_module_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// Weak, such that a application without any module still links.
+extern libos_log_module_t __start_libos_log_modules[] __attribute__((weak));
+extern libos_log_module_t __stop_libos_log_modules[] __attribute__((weak));
+
+/**
+ * @brief Checks if the statement with @ref level is output by the module.
+ * 
+ * @param[in] module The module of the statement.
+ * @param[in] level The LIBOS_LOG_LEVEL_* of the statement.
+ * 
+ * @retval true The statement is output.
+ * @retval false The statement is filtered.
+ */
+static inline bool libos_log_module_is_enabled(libos_log_module_t *module, int level)
+{
+    return (int)LIBOS_ATOMIC_LOAD(&module->level, LIBOS_ATOMIC_RELAXED) >= level;
+}
+
+/**
+ * @brief Sets the run-time level of the module with the given name.
+ * 
+ * @param[in] name The name given to LIBOS_LOG_MODULE.
+ * @param[in] level The most verbose LIBOS_LOG_LEVEL_* to output.
+ * 
+ * @return libos_err_t LIBOS_ERR_OK if set, LIBOS_ERR_INVALID_ARG if @ref name is NULL or no module has that name.
+ */
+static inline libos_err_t libos_log_set_level(const char *name, int level)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(name);
+
+    libos_err_t err = LIBOS_ERR_INVALID_ARG;
+    for (libos_log_module_t *module = __start_libos_log_modules; module != NULL && module < __stop_libos_log_modules; module++)
+    {
+        if (strcmp(module->name, name) == 0)
+        {
+            LIBOS_ATOMIC_STORE(&module->level, (uint32_t)level, LIBOS_ATOMIC_RELAXED);
+            err = LIBOS_ERR_OK;
+        }
+    }
+    return err;
+}
+
+/**
+ * @brief Gets the run-time level of the module with the given name.
+ * 
+ * @param[in] name The name given to LIBOS_LOG_MODULE.
+ * @param[out] level The most verbose LIBOS_LOG_LEVEL_* that is output.
+ * 
+ * @return libos_err_t LIBOS_ERR_OK if found, LIBOS_ERR_INVALID_ARG if a argument is NULL or no module has that name.
+ */
+static inline libos_err_t libos_log_get_level(const char *name, int *level)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(name);
+    LIBOS_ERR_RET_ARG_NOT_NULL(level);
+
+    for (libos_log_module_t *module = __start_libos_log_modules; module != NULL && module < __stop_libos_log_modules; module++)
+    {
+        if (strcmp(module->name, name) == 0)
+        {
+            *level = (int)LIBOS_ATOMIC_LOAD(&module->level, LIBOS_ATOMIC_RELAXED);
+            return LIBOS_ERR_OK;
+        }
+    }
+    return LIBOS_ERR_INVALID_ARG;
+}
+
+/**
+ * @brief Sets the run-time level of all modules.
+ * 
+ * @param[in] level The most verbose LIBOS_LOG_LEVEL_* to output.
+ */
+static inline void libos_log_set_level_all(int level)
+{
+    for (libos_log_module_t *module = __start_libos_log_modules; module != NULL && module < __stop_libos_log_modules; module++)
+    {
+        LIBOS_ATOMIC_STORE(&module->level, (uint32_t)level, LIBOS_ATOMIC_RELAXED);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+/**
+ * @brief Defines the descriptor of the module of this file, used by LIBOS_LOG_MODULE.
+ * 
+ * @param log_name The name of the module (a C identifier).
+ * @param log_level The LIBOS_LOG_LEVEL_* the module starts with.
+ */
+#define LIBOS_LOG_RUNTIME_MODULE(log_name, log_level) \
+    static libos_log_module_t libos_log_module_ __attribute__((section("libos_log_modules"), used)) = { #log_name, (uint32_t)(log_level) }
+
+/**
+ * @brief Evaluates to true if the level is enabled for the module of this file.
+ * 
+ * @param level The LIBOS_LOG_LEVEL_* of the statement.
+ */
+#define LIBOS_LOG_RUNTIME_IS_ENABLED(level) libos_log_module_is_enabled(&libos_log_module_, (int)(level))
+
+#endif // LIBOS_LOG_RUNTIME_H
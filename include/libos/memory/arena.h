@@ -0,0 +1,239 @@
+/**
+ * @file arena.h
+ * @brief Arena (bump) allocator for scratch memory with a limited lifetime.
+ * 
+ * @details
+ * A arena hands out memory from a single block of user provided (usually
+ * static) storage by moving a offset forward. Individual allocations are
+ * never freed, instead all of them are given back at once with
+ * libos_arena_reset, or everything allocated after a checkpoint with
+ * libos_arena_rewind. This makes a allocation only a few instructions, and
+ * fits the pattern of allocating many small buffers while handling a request
+ * and throwing them all away at the end.
+ * 
+ * Example:
+ * @code{.c}
+ * static LIBOS_ARENA_STATIC_DATA_STRUCT(scratch_data, 4096);
+ * static libos_arena_t scratch;
+ * 
+ * void init(void) {
+ *   LIBOS_ARENA_CREATE_STATIC(scratch_data, scratch);
+ * }
+ * 
+ * void handle_request(void) {
+ *   char *name = libos_arena_alloc(&scratch, 32);
+ *   libos_arena_mark_t mark = libos_arena_mark(&scratch);
+ *   uint32_t *table = libos_arena_alloc_aligned(&scratch, 64 * sizeof(uint32_t), 16);
+ *   // Done with the table, but not with the name
+ *   libos_arena_rewind(&scratch, mark);
+ *   // ...
+ *   libos_arena_reset(&scratch);
+ * }
+ * @endcode
+ * 
+ * An arena is not thread safe, it is meant to be owned by a single task (or
+ * protected by the user). The implementation is fully in this header.
+ */
+
+#pragma once
+#ifndef LIBOS_MEMORY_ARENA_H
+#define LIBOS_MEMORY_ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "libos/error.h"
+
+/**
+ * @brief The alignment (in bytes) used by libos_arena_alloc.
+ */
+#ifndef LIBOS_ARENA_DEFAULT_ALIGNMENT
+#define LIBOS_ARENA_DEFAULT_ALIGNMENT 8
+#endif // LIBOS_ARENA_DEFAULT_ALIGNMENT
+
+/**
+ * @def LIBOS_ARENA_STATIC_DATA_STRUCT(name, size)
+ * @brief Define the storage of at least @ref size bytes for a arena with @ref name.
+ * 
+ * @details
+ * The storage is a array of uint64_t, so the start is aligned to 8 bytes. This
+ * can be used in a struct, or as a global or local variable.
+ * 
+ * @param[in] name The name of the storage variable.
+ * @param[in] size The number of bytes in the arena.
+ */
+#define LIBOS_ARENA_STATIC_DATA_STRUCT(name, size) uint64_t name[((size) + sizeof(uint64_t) - 1) / sizeof(uint64_t)]
+
+/**
+ * @def LIBOS_ARENA_CREATE_STATIC(static_data_name, arena)
+ * @brief Initializes the arena with the storage defined by LIBOS_ARENA_STATIC_DATA_STRUCT.
+ * 
+ * @details
+ * The parameter are names for the variables, they are NOT pointers yet.
+ * 
+ * @param[in] static_data_name The name of of the variable for the storage.
+ * @param[in] arena The name of the libos_arena_t variable to initialize.
+ * 
+ * @return libos_err_t The result of libos_arena_init.
+ */
+#define LIBOS_ARENA_CREATE_STATIC(static_data_name, arena) libos_arena_init(&(arena), (static_data_name), sizeof(static_data_name))
+
+/**
+ * @brief The arena control structure.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly.
+ */
+typedef struct {
+    uint8_t *storage; ///< The memory handed out by the arena.
+    size_t capacity;  ///< The size of the storage in bytes.
+    size_t offset;    ///< The number of bytes in use from the start of the storage.
+} libos_arena_t;
+
+/**
+ * @brief A checkpoint of the arena, to rewind to with libos_arena_rewind.
+ */
+typedef size_t libos_arena_mark_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initializes the arena with the given storage, with nothing allocated.
+ * 
+ * @param[out] arena The arena to initialize.
+ * @param[in] storage The memory to allocate from.
+ * @param[in] size The size of @ref storage in bytes.
+ * 
+ * @retval LIBOS_ERR_OK The arena is initialized.
+ * @retval LIBOS_ERR_INVALID_ARG @ref arena and/or @ref storage is NULL.
+ * 
+ * @return libos_err_t The libos standard success code for initializing the arena.
+ */
+static inline libos_err_t libos_arena_init(libos_arena_t *arena, void *storage, size_t size)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(arena);
+    LIBOS_ERR_RET_ARG_NOT_NULL(storage);
+
+    arena->storage = (uint8_t*)storage;
+    arena->capacity = size;
+    arena->offset = 0;
+    return LIBOS_ERR_OK;
+}
+
+/**
+ * @brief Allocates @ref size bytes aligned to @ref alignment from the arena.
+ * 
+ * @param[in] arena The arena to allocate from.
+ * @param[in] size The number of bytes to allocate.
+ * @param[in] alignment The alignment of the memory, must be a power of two.
+ * 
+ * @return void* The memory, or NULL if the arena doesn't have enough space left or @ref alignment isn't a power of two.
+ */
+static inline void *libos_arena_alloc_aligned(libos_arena_t *arena, size_t size, size_t alignment)
+{
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        return NULL;
+    }
+
+    // Align the address and not the offset, the storage itself might be less aligned than requested.
+    uintptr_t current = (uintptr_t)(arena->storage + arena->offset);
+    size_t padding = (size_t)(((current + (alignment - 1)) & ~(uintptr_t)(alignment - 1)) - current);
+    size_t available = arena->capacity - arena->offset;
+    if (padding > available || size > available - padding)
+    {
+        return NULL;
+    }
+
+    uint8_t *ptr = arena->storage + arena->offset + padding;
+    arena->offset += padding + size;
+    return ptr;
+}
+
+/**
+ * @brief Allocates @ref size bytes aligned to LIBOS_ARENA_DEFAULT_ALIGNMENT from the arena.
+ * 
+ * @param[in] arena The arena to allocate from.
+ * @param[in] size The number of bytes to allocate.
+ * 
+ * @return void* The memory, or NULL if the arena doesn't have enough space left.
+ */
+static inline void *libos_arena_alloc(libos_arena_t *arena, size_t size)
+{
+    return libos_arena_alloc_aligned(arena, size, LIBOS_ARENA_DEFAULT_ALIGNMENT);
+}
+
+/**
+ * @brief Takes a checkpoint of the current allocations.
+ * 
+ * @param[in] arena The arena.
+ * 
+ * @return libos_arena_mark_t The checkpoint to give to libos_arena_rewind.
+ */
+static inline libos_arena_mark_t libos_arena_mark(const libos_arena_t *arena)
+{
+    return arena->offset;
+}
+
+/**
+ * @brief Frees everything allocated since the checkpoint was taken.
+ * 
+ * @param[in] arena The arena.
+ * @param[in] mark The checkpoint from libos_arena_mark.
+ * 
+ * @retval LIBOS_ERR_OK The arena is rewound.
+ * @retval LIBOS_ERR_INVALID_ARG @ref arena is NULL, or @ref mark is after the current allocations (already rewound past it).
+ * 
+ * @return libos_err_t The libos standard success code for rewinding the arena.
+ */
+static inline libos_err_t libos_arena_rewind(libos_arena_t *arena, libos_arena_mark_t mark)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(arena);
+    LIBOS_ERR_RET_ON_TRUE(mark > arena->offset, LIBOS_ERR_INVALID_ARG);
+
+    arena->offset = mark;
+    return LIBOS_ERR_OK;
+}
+
+/**
+ * @brief Frees all the allocations of the arena at once.
+ * 
+ * @param[in] arena The arena.
+ */
+static inline void libos_arena_reset(libos_arena_t *arena)
+{
+    arena->offset = 0;
+}
+
+/**
+ * @brief Returns the number of bytes in use, including the alignment padding.
+ * 
+ * @param[in] arena The arena.
+ * 
+ * @return size_t The number of bytes in use.
+ */
+static inline size_t libos_arena_used(const libos_arena_t *arena)
+{
+    return arena->offset;
+}
+
+/**
+ * @brief Returns the number of bytes that are not allocated (ignoring the alignment padding of the next allocation).
+ * 
+ * @param[in] arena The arena.
+ * 
+ * @return size_t The number of bytes left.
+ */
+static inline size_t libos_arena_remaining(const libos_arena_t *arena)
+{
+    return arena->capacity - arena->offset;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_MEMORY_ARENA_H
@@ -0,0 +1,263 @@
+/**
+ * @file pool.h
+ * @brief Fixed-size block memory pool.
+ * 
+ * @details
+ * This header provides a allocator for blocks of a single, fixed size from
+ * user provided (usually static) storage. Allocating and freeing a block are
+ * O(1) operations, which gives a bounded latency and doesn't fragment the
+ * heap, in contrary to malloc and free.
+ * 
+ * The free blocks are kept in a intrusive free list, the first bytes of a
+ * free block hold the index of the next free block. This means that the pool
+ * doesn't need any memory besides the blocks themselves and the small
+ * libos_pool_t control structure.
+ * 
+ * A pool can be created thread safe. In that case the free list is a
+ * lock-free stack (using the libos atomics), so the pool can be used from
+ * multiple tasks at the same time without a mutex. The head of the list
+ * carries a modification counter next to the block index, to protect against
+ * the ABA problem. When the pool is only used from a single task, the thread
+ * safety can be turned off to get rid of the compare-and-swap operations.
+ * Note that the thread safe pool uses 64-bit atomics, which are not lock-free
+ * on all 32-bit targets (see LIBOS_ATOMIC_64_IS_LOCK_FREE).
+ * 
+ * Example:
+ * @code{.c}
+ * typedef struct { uint8_t payload[48]; } message_t;
+ * 
+ * static LIBOS_POOL_STATIC_DATA_STRUCT(message_data, sizeof(message_t), 32);
+ * static libos_pool_t messages;
+ * 
+ * void init(void) {
+ *   LIBOS_POOL_CREATE_STATIC(message_data, messages, sizeof(message_t), true);
+ * }
+ * 
+ * void handle(void) {
+ *   message_t *message = libos_pool_alloc(&messages);
+ *   if (message != NULL) {
+ *     // Use the message
+ *     libos_pool_free(&messages, message);
+ *   }
+ * }
+ * @endcode
+ * 
+ * The implementation is fully in this header, and only depends on the
+ * platform for the error codes and atomics.
+ */
+
+#pragma once
+#ifndef LIBOS_MEMORY_POOL_H
+#define LIBOS_MEMORY_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "libos/error.h"
+#include "libos/concurrent/atomic.h"
+
+/**
+ * @brief The alignment (in bytes) of every block in the pool.
+ */
+#define LIBOS_POOL_BLOCK_ALIGNMENT 8
+
+/**
+ * @brief The size that a block of @ref block_size takes in the storage (rounded up to the alignment).
+ * 
+ * @param block_size The requested size of a block.
+ */
+#define LIBOS_POOL_BLOCK_SIZE(block_size) ((((size_t)(block_size) < sizeof(uint32_t) ? sizeof(uint32_t) : (size_t)(block_size)) + (LIBOS_POOL_BLOCK_ALIGNMENT - 1)) & ~(size_t)(LIBOS_POOL_BLOCK_ALIGNMENT - 1))
+
+/**
+ * @def LIBOS_POOL_STATIC_DATA_STRUCT(name, block_size, block_count)
+ * @brief Define the storage for @ref block_count blocks of @ref block_size bytes with @ref name.
+ * 
+ * @details
+ * The storage is a array of uint64_t to guarantee the block alignment. This
+ * can be used in a struct, or as a global or local variable. The pool itself
+ * is a separate libos_pool_t variable that is initialized with
+ * LIBOS_POOL_CREATE_STATIC.
+ * 
+ * @param[in] name The name of the storage variable.
+ * @param[in] block_size The size of each block in bytes.
+ * @param[in] block_count The number of blocks in the pool.
+ */
+#define LIBOS_POOL_STATIC_DATA_STRUCT(name, block_size, block_count) uint64_t name[(LIBOS_POOL_BLOCK_SIZE(block_size) * (block_count)) / sizeof(uint64_t)]
+
+/**
+ * @def LIBOS_POOL_CREATE_STATIC(static_data_name, pool, block_size, thread_safe)
+ * @brief Initializes the pool with the storage defined by LIBOS_POOL_STATIC_DATA_STRUCT.
+ * 
+ * @details
+ * The parameter are names for the variables, they are NOT pointers yet.
+ * 
+ * @param[in] static_data_name The name of of the variable for the storage.
+ * @param[in] pool The name of the libos_pool_t variable to initialize.
+ * @param[in] block_size The size of each block in bytes (the same as given to LIBOS_POOL_STATIC_DATA_STRUCT).
+ * @param[in] thread_safe If true, the pool can be used from multiple tasks at the same time.
+ * 
+ * @return libos_err_t The result of libos_pool_init.
+ */
+#define LIBOS_POOL_CREATE_STATIC(static_data_name, pool, block_size, thread_safe) libos_pool_init(&(pool), (static_data_name), (block_size), (uint32_t)(sizeof(static_data_name) / LIBOS_POOL_BLOCK_SIZE(block_size)), (thread_safe))
+
+// The index that marks the end of the free list.
+#define LIBOS_POOL_INDEX_NONE_ UINT32_MAX
+
+/**
+ * @brief The pool control structure.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly.
+ */
+typedef struct {
+    libos_atomic_uint64_t head; ///< The modification counter (upper 32 bits) and index of the first free block.
+    uint8_t *storage;           ///< The memory of the blocks.
+    size_t block_size;          ///< The size of a block, including the alignment padding.
+    uint32_t block_count;       ///< The number of blocks in the storage.
+    bool thread_safe;           ///< If the free list has to be updated with compare-and-swap.
+} libos_pool_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initializes the pool with all the blocks free.
+ * 
+ * @details
+ * This is not thread safe, the pool can only be used after the initialization
+ * is done.
+ * 
+ * @param[out] pool The pool to initialize.
+ * @param[in] storage The memory for the blocks, aligned to LIBOS_POOL_BLOCK_ALIGNMENT and at least LIBOS_POOL_BLOCK_SIZE(block_size) * block_count bytes.
+ * @param[in] block_size The size of each block in bytes.
+ * @param[in] block_count The number of blocks in the storage.
+ * @param[in] thread_safe If true, the pool can be used from multiple tasks at the same time.
+ * 
+ * @retval LIBOS_ERR_OK The pool is initialized.
+ * @retval LIBOS_ERR_INVALID_ARG @ref pool or @ref storage is NULL, @ref storage is not aligned, or @ref block_size or @ref block_count is 0.
+ * 
+ * @return libos_err_t The libos standard success code for initializing the pool.
+ */
+static inline libos_err_t libos_pool_init(libos_pool_t *pool, void *storage, size_t block_size, uint32_t block_count, bool thread_safe)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(pool);
+    LIBOS_ERR_RET_ARG_NOT_NULL(storage);
+    LIBOS_ERR_RET_ON_TRUE(((uintptr_t)storage % LIBOS_POOL_BLOCK_ALIGNMENT) != 0, LIBOS_ERR_INVALID_ARG);
+    LIBOS_ERR_RET_ON_TRUE(block_size == 0 || block_count == 0 || block_count == LIBOS_POOL_INDEX_NONE_, LIBOS_ERR_INVALID_ARG);
+
+    pool->storage = (uint8_t*)storage;
+    pool->block_size = LIBOS_POOL_BLOCK_SIZE(block_size);
+    pool->block_count = block_count;
+    pool->thread_safe = thread_safe;
+
+    // Chain all the blocks in order, such that the first allocations are at the start of the storage.
+    for (uint32_t i = 0; i < block_count; i++)
+    {
+        uint32_t next = (i + 1 < block_count) ? (i + 1) : LIBOS_POOL_INDEX_NONE_;
+        memcpy(pool->storage + ((size_t)i * pool->block_size), &next, sizeof(next));
+    }
+    LIBOS_ATOMIC_INIT(&pool->head, 0);
+    return LIBOS_ERR_OK;
+}
+
+/**
+ * @brief Returns the usable size of each block (at least the size given at initialization).
+ * 
+ * @param[in] pool The pool.
+ * 
+ * @return size_t The size of a block in bytes.
+ */
+static inline size_t libos_pool_block_size(const libos_pool_t *pool)
+{
+    return pool->block_size;
+}
+
+/**
+ * @brief Allocates a block from the pool in O(1).
+ * 
+ * @details
+ * The content of the block is undefined.
+ * 
+ * @param[in] pool The pool to allocate from.
+ * 
+ * @return void* The block, or NULL if there are no free blocks left.
+ */
+static inline void *libos_pool_alloc(libos_pool_t *pool)
+{
+    uint64_t head = LIBOS_ATOMIC_LOAD(&pool->head, LIBOS_ATOMIC_ACQUIRE);
+    uint64_t new_head;
+    uint8_t *block;
+    do
+    {
+        uint32_t index = (uint32_t)head;
+        if (index == LIBOS_POOL_INDEX_NONE_)
+        {
+            return NULL;
+        }
+
+        // If another task takes this block in the mean time, the counter makes the exchange below fail.
+        uint32_t next;
+        block = pool->storage + ((size_t)index * pool->block_size);
+        memcpy(&next, block, sizeof(next));
+        new_head = (((head >> 32) + 1) << 32) | next;
+
+        if (!pool->thread_safe)
+        {
+            LIBOS_ATOMIC_STORE(&pool->head, new_head, LIBOS_ATOMIC_RELAXED);
+            break;
+        }
+    } while (!LIBOS_ATOMIC_COMPARE_EXCHANGE_WEAK(&pool->head, &head, new_head, LIBOS_ATOMIC_ACQUIRE, LIBOS_ATOMIC_ACQUIRE));
+
+    return block;
+}
+
+/**
+ * @brief Gives a block back to the pool in O(1).
+ * 
+ * @param[in] pool The pool the block was allocated from.
+ * @param[in] block The block to free.
+ * 
+ * @retval LIBOS_ERR_OK The block is freed.
+ * @retval LIBOS_ERR_INVALID_ARG @ref pool or @ref block is NULL, or @ref block isn't a block of this pool.
+ * 
+ * @return libos_err_t The libos standard success code for freeing the block.
+ */
+static inline libos_err_t libos_pool_free(libos_pool_t *pool, void *block)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(pool);
+    LIBOS_ERR_RET_ARG_NOT_NULL(block);
+
+    uint8_t *ptr = (uint8_t*)block;
+    LIBOS_ERR_RET_ON_TRUE(ptr < pool->storage, LIBOS_ERR_INVALID_ARG);
+    size_t offset = (size_t)(ptr - pool->storage);
+    LIBOS_ERR_RET_ON_TRUE((offset % pool->block_size) != 0, LIBOS_ERR_INVALID_ARG);
+    LIBOS_ERR_RET_ON_TRUE((offset / pool->block_size) >= pool->block_count, LIBOS_ERR_INVALID_ARG);
+    uint32_t index = (uint32_t)(offset / pool->block_size);
+
+    uint64_t head = LIBOS_ATOMIC_LOAD(&pool->head, LIBOS_ATOMIC_RELAXED);
+    uint64_t new_head;
+    do
+    {
+        uint32_t next = (uint32_t)head;
+        memcpy(ptr, &next, sizeof(next));
+        new_head = (((head >> 32) + 1) << 32) | index;
+
+        if (!pool->thread_safe)
+        {
+            LIBOS_ATOMIC_STORE(&pool->head, new_head, LIBOS_ATOMIC_RELAXED);
+            break;
+        }
+    } while (!LIBOS_ATOMIC_COMPARE_EXCHANGE_WEAK(&pool->head, &head, new_head, LIBOS_ATOMIC_RELEASE, LIBOS_ATOMIC_RELAXED));
+
+    return LIBOS_ERR_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_MEMORY_POOL_H
@@ -56,6 +56,24 @@
  * @endcode
  * . The general API header for the time places all the functions in
  * a extern "C" code block.
+ * 
+ * Every function can be provided by the platform header as a macro or
+ * static inline function instead of a library function. The platform has to
+ * define the name of the function as a macro in that case, like:
+ * 
+ * @code
+ * static inline libos_time_t libos_time_add(libos_time_t a, libos_time_t b) { return a + b; }
+ * #define libos_time_add libos_time_add
+ * @endcode
+ * 
+ * When libos_time_t is a signed 64-bit count of nanoseconds, the platform
+ * can define LIBOS_TIME_NS_INT64 as 1 to get inline implementations of all
+ * the conversion and arithmetic functions from this header. Then only
+ * libos_time_get_now has to be implemented by the platform, and conversions
+ * of constants like libos_time_from_ms(10) are folded by the compiler.
+ * 
+ * Optionally the platform can provide a faster libos_time_ticks_now by
+ * defining it (see libos_time_ticks_t).
  */
 
 #pragma once
@@ -65,9 +83,15 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "libos/error.h"
+
 // Platform specific additions & provisions like the libos_time_*_t types.
 #include "libos/platform/time.h"
 
+#ifndef LIBOS_TIME_NS_INT64
+#define LIBOS_TIME_NS_INT64 0
+#endif // LIBOS_TIME_NS_INT64
+
 #ifdef __cplusplus
 extern "C" {
 #endif // __cplusplus
@@ -77,47 +101,97 @@ extern "C" {
  * 
  * @return libos_time_t The representation of the current time.
  */
+#ifndef libos_time_get_now
 libos_time_t libos_time_get_now(void);
+#endif // libos_time_get_now
 
 /**
  * @brief Returns the difference between the two times in nanoseconds.
  * 
+ * @details
+ * The difference is positive when @ref b is later than @ref a.
+ * 
  * @param a The time to use as a baseline.
  * @param b The time to get the difference to.
  * 
- * @return libos_time_microseconds_t Returns the time difference in nanoseconds in the platform specific value type.
+ * @return libos_time_nanoseconds_t Returns the time difference in nanoseconds in the platform specific value type.
  */
-libos_time_nanoseconds_t libos_time_difference_ms(libos_time_t a, libos_time_t b);
+#ifndef libos_time_difference_ns
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_nanoseconds_t libos_time_difference_ns(libos_time_t a, libos_time_t b)
+{
+    return (libos_time_nanoseconds_t)(b - a);
+}
+#else // LIBOS_TIME_NS_INT64==1
+libos_time_nanoseconds_t libos_time_difference_ns(libos_time_t a, libos_time_t b);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_difference_ns
 
 /**
  * @brief Returns the difference between the two times in microseconds.
  * 
+ * @details
+ * The difference is positive when @ref b is later than @ref a.
+ * 
  * @param a The time to use as a baseline.
  * @param b The time to get the difference to.
  * 
  * @return libos_time_microseconds_t Returns the time difference in microseconds in the platform specific value type.
  */
+#ifndef libos_time_difference_us
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_microseconds_t libos_time_difference_us(libos_time_t a, libos_time_t b)
+{
+    return (libos_time_microseconds_t)((b - a) / 1000);
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_microseconds_t libos_time_difference_us(libos_time_t a, libos_time_t b);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_difference_us
 
 /**
  * @brief Returns the difference between the two times in milliseconds.
  * 
+ * @details
+ * The difference is positive when @ref b is later than @ref a.
+ * 
  * @param a The time to use as a baseline.
  * @param b The time to get the difference to.
  * 
  * @return libos_time_milliseconds_t Returns the time difference in milliseconds in the platform specific value type.
  */
+#ifndef libos_time_difference_ms
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_milliseconds_t libos_time_difference_ms(libos_time_t a, libos_time_t b)
+{
+    return (libos_time_milliseconds_t)((b - a) / 1000000);
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_milliseconds_t libos_time_difference_ms(libos_time_t a, libos_time_t b);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_difference_ms
 
 /**
  * @brief Returns the difference between the two times in seconds.
  * 
+ * @details
+ * The difference is positive when @ref b is later than @ref a.
+ * 
  * @param a The time to use as a baseline.
  * @param b The time to get the difference to.
  * 
  * @return libos_time_seconds_t Returns the time difference in seconds in the platform specific value type.
  */
+#ifndef libos_time_difference_s
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_seconds_t libos_time_difference_s(libos_time_t a, libos_time_t b)
+{
+    return (libos_time_seconds_t)((b - a) / 1000000000);
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_seconds_t libos_time_difference_s(libos_time_t a, libos_time_t b);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_difference_s
 
 /**
  * @brief Creates a libos_time_t structure from just the number of nanoseconds since the epoch.
@@ -126,7 +200,16 @@ libos_time_seconds_t libos_time_difference_s(libos_time_t a, libos_time_t b);
  * 
  * @return libos_time_t The resulting time structure.
  */
+#ifndef libos_time_from_ns
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_t libos_time_from_ns(libos_time_nanoseconds_t ns)
+{
+    return (libos_time_t)ns;
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_t libos_time_from_ns(libos_time_nanoseconds_t ns);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_from_ns
 
 /**
  * @brief Creates a libos_time_t structure from just the number of microseconds since the epoch.
@@ -135,7 +218,16 @@ libos_time_t libos_time_from_ns(libos_time_nanoseconds_t ns);
  * 
  * @return libos_time_t The resulting time structure.
  */
+#ifndef libos_time_from_us
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_t libos_time_from_us(libos_time_microseconds_t us)
+{
+    return (libos_time_t)us * 1000;
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_t libos_time_from_us(libos_time_microseconds_t us);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_from_us
 
 /**
  * @brief Creates a libos_time_t structure from just the number of milliseconds since the epoch.
@@ -144,7 +236,16 @@ libos_time_t libos_time_from_us(libos_time_microseconds_t us);
  * 
  * @return libos_time_t The resulting time structure.
  */
+#ifndef libos_time_from_ms
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_t libos_time_from_ms(libos_time_milliseconds_t ms)
+{
+    return (libos_time_t)ms * 1000000;
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_t libos_time_from_ms(libos_time_milliseconds_t ms);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_from_ms
 
 /**
  * @brief Creates a libos_time_t structure from just the number of seconds since the epoch.
@@ -153,7 +254,16 @@ libos_time_t libos_time_from_ms(libos_time_milliseconds_t ms);
  * 
  * @return libos_time_t The resulting time structure.
  */
+#ifndef libos_time_from_s
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_t libos_time_from_s(libos_time_seconds_t s)
+{
+    return (libos_time_t)s * 1000000000;
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_t libos_time_from_s(libos_time_seconds_t s);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_from_s
 
 /**
  * @brief Converts the timestamp to the number of nanoseconds since it's epoch.
@@ -162,7 +272,16 @@ libos_time_t libos_time_from_s(libos_time_seconds_t s);
  * 
  * @return libos_time_nanoseconds_t The number of nanoseconds since the epoch.
  */
+#ifndef libos_time_to_ns
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_nanoseconds_t libos_time_to_ns(libos_time_t time)
+{
+    return (libos_time_nanoseconds_t)time;
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_nanoseconds_t libos_time_to_ns(libos_time_t time);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_to_ns
 
 /**
  * @brief Converts the timestamp to the number of microsecond since it's epoch.
@@ -171,7 +290,16 @@ libos_time_nanoseconds_t libos_time_to_ns(libos_time_t time);
  * 
  * @return libos_time_microseconds_t The number of microseconds since the epoch.
  */
+#ifndef libos_time_to_us
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_microseconds_t libos_time_to_us(libos_time_t time)
+{
+    return (libos_time_microseconds_t)(time / 1000);
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_microseconds_t libos_time_to_us(libos_time_t time);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_to_us
 
 /**
  * @brief Converts the timestamp to the number of millisecond since it's epoch
@@ -180,7 +308,16 @@ libos_time_microseconds_t libos_time_to_us(libos_time_t time);
  * 
  * @return libos_time_milliseconds_t The number of milliseconds since the epoch.
  */
+#ifndef libos_time_to_ms
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_milliseconds_t libos_time_to_ms(libos_time_t time)
+{
+    return (libos_time_milliseconds_t)(time / 1000000);
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_milliseconds_t libos_time_to_ms(libos_time_t time);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_to_ms
 
 /**
  * @brief Convert the timestamp to the number of seconds since it's epoch.
@@ -189,7 +326,16 @@ libos_time_milliseconds_t libos_time_to_ms(libos_time_t time);
  * 
  * @return libos_time_seconds_t The number of seconds since the epoch.
  */
+#ifndef libos_time_to_s
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_seconds_t libos_time_to_s(libos_time_t time)
+{
+    return (libos_time_seconds_t)(time / 1000000000);
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_seconds_t libos_time_to_s(libos_time_t time);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_to_s
 
 /**
  * @brief Subtracts @ref b from the @ref a timestamp.
@@ -199,7 +345,16 @@ libos_time_seconds_t libos_time_to_s(libos_time_t time);
  * 
  * @return libos_time_t The result of the subtraction.
  */
+#ifndef libos_time_subtract
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_t libos_time_subtract(libos_time_t a, libos_time_t b)
+{
+    return a - b;
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_t libos_time_subtract(libos_time_t a, libos_time_t b);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_subtract
 
 /**
  * @brief Adds the two timestamps together.
@@ -209,7 +364,16 @@ libos_time_t libos_time_subtract(libos_time_t a, libos_time_t b);
  * 
  * @return libos_time_t The result of the addition.
  */
+#ifndef libos_time_add
+#if LIBOS_TIME_NS_INT64==1
+static inline libos_time_t libos_time_add(libos_time_t a, libos_time_t b)
+{
+    return a + b;
+}
+#else // LIBOS_TIME_NS_INT64==1
 libos_time_t libos_time_add(libos_time_t a, libos_time_t b);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_add
 
 /**
  * @brief Checks if the @ref a timestamp is later than the @ref b timestamp.
@@ -217,10 +381,19 @@ libos_time_t libos_time_add(libos_time_t a, libos_time_t b);
  * @param a Baseline timestamp.
  * @param b The timestamp to compare with.
  * 
- * @retval true If @ref b is later than @ref a.
- * @retval false If @ref b is earlier then @ref a.
+ * @retval true If @ref a is later than @ref b.
+ * @retval false If @ref a is earlier than or the same as @ref b.
  */
+#ifndef libos_time_is_later
+#if LIBOS_TIME_NS_INT64==1
+static inline bool libos_time_is_later(libos_time_t a, libos_time_t b)
+{
+    return a > b;
+}
+#else // LIBOS_TIME_NS_INT64==1
 bool libos_time_is_later(libos_time_t a, libos_time_t b);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_is_later
 
 /**
  * @brief Checks if the @ref a timestamp is earlier than the @ref b timestamp.
@@ -228,10 +401,19 @@ bool libos_time_is_later(libos_time_t a, libos_time_t b);
  * @param a Baseline timestamp.
  * @param b The timestamp to compare with.
  * 
- * @retval true If @ref b is earlier than @ref a.
- * @retval false If @ref b is later than @ref a.
+ * @retval true If @ref a is earlier than @ref b.
+ * @retval false If @ref a is later than or the same as @ref b.
  */
+#ifndef libos_time_is_earlier
+#if LIBOS_TIME_NS_INT64==1
+static inline bool libos_time_is_earlier(libos_time_t a, libos_time_t b)
+{
+    return a < b;
+}
+#else // LIBOS_TIME_NS_INT64==1
 bool libos_time_is_earlier(libos_time_t a, libos_time_t b);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_is_earlier
 
 /**
  * @brief Checks if the @ref a timestamp refers to the same time as @ref b.
@@ -242,7 +424,193 @@ bool libos_time_is_earlier(libos_time_t a, libos_time_t b);
  * @retval true If @ref a is the same as @ref b.
  * @retval false If @ref a is NOT the same as @ref b.
  */
+#ifndef libos_time_is_same
+#if LIBOS_TIME_NS_INT64==1
+static inline bool libos_time_is_same(libos_time_t a, libos_time_t b)
+{
+    return a == b;
+}
+#else // LIBOS_TIME_NS_INT64==1
 bool libos_time_is_same(libos_time_t a, libos_time_t b);
+#endif // LIBOS_TIME_NS_INT64==1
+#endif // libos_time_is_same
+
+/**
+ * @brief A raw count of the fastest monotonic counter of the CPU.
+ * 
+ * @details
+ * The ticks are meant for timestamps with a very low overhead, like
+ * instrumenting hot paths and benchmarks. The frequency of the counter is
+ * platform specific, and only the difference between two readings (with
+ * libos_time_ticks_diff) is meaningful. Use a libos_time_ticks_calibration_t
+ * to convert the difference to nanoseconds.
+ * 
+ * The counter is selected as follows, unless the platform overrides
+ * libos_time_ticks_now (by defining it):
+ * 
+ *  * x86: the time stamp counter (rdtsc).
+ *  * AArch64: the virtual counter (CNTVCT_EL0).
+ *  * Xtensa: the cycle counter (CCOUNT), which is 32-bit.
+ *  * Otherwise: libos_time_get_now in nanoseconds.
+ * 
+ * A platform that overrides libos_time_ticks_now can define
+ * LIBOS_TIME_TICKS_MASK if the counter is narrower than 64-bit.
+ */
+typedef uint64_t libos_time_ticks_t;
+
+#ifndef libos_time_ticks_now
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+static inline libos_time_ticks_t libos_time_ticks_now(void)
+{
+    return (libos_time_ticks_t)__builtin_ia32_rdtsc();
+}
+#elif defined(__GNUC__) && defined(__aarch64__)
+static inline libos_time_ticks_t libos_time_ticks_now(void)
+{
+    uint64_t ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+}
+#elif defined(__GNUC__) && defined(__XTENSA__)
+#ifndef LIBOS_TIME_TICKS_MASK
+#define LIBOS_TIME_TICKS_MASK UINT32_MAX
+#endif // LIBOS_TIME_TICKS_MASK
+static inline libos_time_ticks_t libos_time_ticks_now(void)
+{
+    uint32_t ticks;
+    __asm__ __volatile__("rsr.ccount %0" : "=a"(ticks));
+    return ticks;
+}
+#else
+/**
+ * @brief Set to 1 when the ticks come from libos_time_get_now, in which case a tick is a nanosecond.
+ */
+#define LIBOS_TIME_TICKS_FALLBACK 1
+static inline libos_time_ticks_t libos_time_ticks_now(void)
+{
+    return (libos_time_ticks_t)libos_time_to_ns(libos_time_get_now());
+}
+#endif
+#endif // libos_time_ticks_now
+
+#ifndef LIBOS_TIME_TICKS_FALLBACK
+#define LIBOS_TIME_TICKS_FALLBACK 0
+#endif // LIBOS_TIME_TICKS_FALLBACK
+
+/**
+ * @brief The bits of libos_time_ticks_t that are used by the counter.
+ */
+#ifndef LIBOS_TIME_TICKS_MASK
+#define LIBOS_TIME_TICKS_MASK UINT64_MAX
+#endif // LIBOS_TIME_TICKS_MASK
+
+/**
+ * @brief Returns the number of ticks from @ref start to @ref end, correct when the counter wrapped once.
+ * 
+ * @param start The earlier reading of libos_time_ticks_now.
+ * @param end The later reading of libos_time_ticks_now.
+ * 
+ * @return libos_time_ticks_t The elapsed ticks.
+ */
+static inline libos_time_ticks_t libos_time_ticks_diff(libos_time_ticks_t start, libos_time_ticks_t end)
+{
+    return (end - start) & (libos_time_ticks_t)LIBOS_TIME_TICKS_MASK;
+}
+
+/**
+ * @brief The conversion from ticks to nanoseconds as a multiply and shift.
+ * 
+ * @details
+ * nanoseconds = (ticks * mult) >> shift, calculated without overflowing the
+ * intermediate result.
+ */
+typedef struct {
+    uint32_t mult;  ///< The multiplier of the ticks.
+    uint32_t shift; ///< The shift after the multiplication.
+} libos_time_ticks_calibration_t;
+
+/**
+ * @brief Calculates the conversion for a counter with a known frequency.
+ * 
+ * @param[out] calibration The conversion to fill.
+ * @param[in] hz The frequency of the counter in ticks per second.
+ * 
+ * @retval LIBOS_ERR_OK The conversion is filled.
+ * @retval LIBOS_ERR_INVALID_ARG @ref calibration is NULL, or @ref hz is 0 or too high to represent.
+ * 
+ * @return libos_err_t The libos standard success code for calculating the conversion.
+ */
+static inline libos_err_t libos_time_ticks_calibration_from_hz(libos_time_ticks_calibration_t *calibration, uint64_t hz)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(calibration);
+    LIBOS_ERR_RET_ON_TRUE(hz == 0, LIBOS_ERR_INVALID_ARG);
+
+    // Take the most precise multiplier that still fits in 32 bits.
+    uint32_t shift = 32;
+    uint64_t mult = (UINT64_C(1000000000) << shift) / hz;
+    while (shift > 0 && mult > UINT32_MAX)
+    {
+        shift--;
+        mult = (UINT64_C(1000000000) << shift) / hz;
+    }
+    LIBOS_ERR_RET_ON_TRUE(mult > UINT32_MAX || mult == 0, LIBOS_ERR_INVALID_ARG);
+
+    calibration->mult = (uint32_t)mult;
+    calibration->shift = shift;
+    return LIBOS_ERR_OK;
+}
+
+/**
+ * @brief Measures the frequency of the ticks against libos_time_get_now and calculates the conversion.
+ * 
+ * @details
+ * This busy waits for @ref duration_us, a longer duration gives a more precise
+ * result. A few milliseconds is usually enough.
+ * 
+ * @param[out] calibration The conversion to fill.
+ * @param[in] duration_us The time in microseconds to measure for (at least 1).
+ * 
+ * @retval LIBOS_ERR_OK The conversion is filled.
+ * @retval LIBOS_ERR_INVALID_ARG @ref calibration is NULL, or @ref duration_us is not positive.
+ * @retval LIBOS_ERR_INVALID_STATE The ticks didn't advance during the measurement.
+ * 
+ * @return libos_err_t The libos standard success code for measuring the conversion.
+ */
+static inline libos_err_t libos_time_ticks_calibrate(libos_time_ticks_calibration_t *calibration, libos_time_microseconds_t duration_us)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(calibration);
+    LIBOS_ERR_RET_ON_TRUE(duration_us <= 0, LIBOS_ERR_INVALID_ARG);
+
+    libos_time_t start = libos_time_get_now();
+    libos_time_ticks_t start_ticks = libos_time_ticks_now();
+    libos_time_microseconds_t elapsed_us;
+    libos_time_ticks_t end_ticks;
+    do
+    {
+        end_ticks = libos_time_ticks_now();
+        elapsed_us = libos_time_difference_us(start, libos_time_get_now());
+    } while (elapsed_us < duration_us);
+
+    uint64_t ticks = libos_time_ticks_diff(start_ticks, end_ticks);
+    LIBOS_ERR_RET_ON_TRUE(ticks == 0, LIBOS_ERR_INVALID_STATE);
+    return libos_time_ticks_calibration_from_hz(calibration, (ticks * UINT64_C(1000000)) / (uint64_t)elapsed_us);
+}
+
+/**
+ * @brief Converts a number of ticks (usually from libos_time_ticks_diff) to nanoseconds.
+ * 
+ * @param calibration The conversion from libos_time_ticks_calibration_from_hz or libos_time_ticks_calibrate.
+ * @param ticks The number of ticks.
+ * 
+ * @return uint64_t The number of nanoseconds.
+ */
+static inline uint64_t libos_time_ticks_to_ns(const libos_time_ticks_calibration_t *calibration, libos_time_ticks_t ticks)
+{
+    // Split the ticks at the shift, such that neither of the multiplications overflow.
+    uint64_t low_mask = (UINT64_C(1) << calibration->shift) - 1;
+    return ((ticks >> calibration->shift) * calibration->mult)
+        + (((ticks & low_mask) * calibration->mult) >> calibration->shift);
+}
 
 #ifdef __cplusplus
 }
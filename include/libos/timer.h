@@ -0,0 +1,524 @@
+/**
+ * @file timer.h
+ * @brief Hierarchical timer wheel for large numbers of software timers.
+ * 
+ * @details
+ * The timer wheel keeps track of many timeouts (like one per connection)
+ * without scanning all of them on every tick. Arming and cancelling a timer
+ * are O(1), and advancing the wheel only touches the timers that expire (and
+ * once in a while moves a batch of timers a level down).
+ * 
+ * The time is divided in ticks of a fixed resolution, given at
+ * initialization. The wheel has LIBOS_TIMER_WHEEL_LEVELS levels of
+ * 2^LIBOS_TIMER_WHEEL_SLOT_BITS slots, where every level covers
+ * 2^LIBOS_TIMER_WHEEL_SLOT_BITS times the range of the level below it. With
+ * the defaults (4 levels of 64 slots) and a resolution of 1 ms, timeouts of
+ * up to 4.6 hours are placed directly. Longer timeouts are supported, they
+ * are moved around in the highest level until they get in range.
+ * 
+ * The timers are intrusive, the libos_timer_t is embedded in the object that
+ * needs the timeout and no memory is allocated by the wheel.
+ * 
+ * Example:
+ * @code{.c}
+ * static libos_timer_wheel_t wheel;
+ * 
+ * static void on_timeout(libos_timer_t *timer, void *arg) {
+ *   connection_t *connection = arg;
+ *   // Close the connection
+ * }
+ * 
+ * void init(void) {
+ *   libos_timer_wheel_init(&wheel, libos_time_get_now(), libos_time_from_ms(1));
+ * }
+ * 
+ * void on_connect(connection_t *connection) {
+ *   libos_timer_arm(&wheel, &connection->timeout, libos_time_from_s(30), on_timeout, connection);
+ * }
+ * 
+ * void timer_task(void) {
+ *   while (true) {
+ *     libos_timer_wheel_advance(&wheel, libos_time_get_now());
+ *     // Sleep a tick
+ *   }
+ * }
+ * @endcode
+ * 
+ * The callbacks are allowed to arm and cancel any timer of the wheel,
+ * including timers that expired in the same batch and didn't run yet.
+ * 
+ * The wheel itself is not thread safe. When timers are armed and cancelled
+ * from multiple tasks, protect the wheel with a mutex (see
+ * libos/concurrent/mutex.h). Use libos_timer_wheel_collect and every
+ * libos_timer_wheel_pop_expired under the lock, and call the popped callback
+ * after unlocking:
+ * 
+ * @code{.c}
+ * libos_mutex_lock(lock, timeout);
+ * libos_timer_wheel_collect(&wheel, libos_time_get_now());
+ * libos_timer_t *timer;
+ * libos_timer_callback_t callback;
+ * void *arg;
+ * while (libos_timer_wheel_pop_expired(&wheel, &timer, &callback, &arg)) {
+ *   libos_mutex_unlock(lock);
+ *   callback(timer, arg);
+ *   libos_mutex_lock(lock, timeout);
+ * }
+ * libos_mutex_unlock(lock);
+ * @endcode
+ * 
+ * This way the callbacks don't run with the lock taken, and a timer that is
+ * cancelled by another task before it is popped is never called.
+ * 
+ * The implementation is fully in this header, and only depends on time.h.
+ */
+
+#pragma once
+#ifndef LIBOS_TIMER_H
+#define LIBOS_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "libos/error.h"
+#include "libos/time.h"
+
+/**
+ * @brief The number of levels in the wheel.
+ */
+#ifndef LIBOS_TIMER_WHEEL_LEVELS
+#define LIBOS_TIMER_WHEEL_LEVELS 4
+#endif // LIBOS_TIMER_WHEEL_LEVELS
+
+/**
+ * @brief The number of slots per level, as a power of two.
+ */
+#ifndef LIBOS_TIMER_WHEEL_SLOT_BITS
+#define LIBOS_TIMER_WHEEL_SLOT_BITS 6
+#endif // LIBOS_TIMER_WHEEL_SLOT_BITS
+
+#define LIBOS_TIMER_WHEEL_SLOTS_ (1u << LIBOS_TIMER_WHEEL_SLOT_BITS)
+#define LIBOS_TIMER_WHEEL_SLOT_MASK_ ((uint64_t)LIBOS_TIMER_WHEEL_SLOTS_ - 1)
+#define LIBOS_TIMER_WHEEL_MAX_DELTA_ ((UINT64_C(1) << (LIBOS_TIMER_WHEEL_SLOT_BITS * LIBOS_TIMER_WHEEL_LEVELS)) - 1)
+
+typedef struct libos_timer libos_timer_t;
+
+/**
+ * @brief The function called when the timer expires.
+ * 
+ * @param timer The timer that expired, it is no longer armed and can be armed again.
+ * @param arg The argument given when the timer was armed.
+ */
+typedef void (*libos_timer_callback_t)(libos_timer_t *timer, void *arg);
+
+/**
+ * @brief A single timer, to be embedded in the object that needs the timeout.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly. Initialize it with libos_timer_init before the first use.
+ */
+struct libos_timer {
+    libos_timer_t *next;             ///< The next timer in the same slot or expired list.
+    libos_timer_t **pprev;           ///< The pointer to this timer in the slot or expired list, NULL if idle.
+    bool pending;                    ///< If the timer is in the expired list, waiting for its callback.
+    uint64_t expires;                ///< The tick after which the timer expires.
+    libos_timer_callback_t callback; ///< The function to call on expiry.
+    void *arg;                       ///< The argument for the callback.
+};
+
+/**
+ * @brief The timer wheel.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly.
+ */
+typedef struct {
+    libos_timer_t *slots[LIBOS_TIMER_WHEEL_LEVELS][LIBOS_TIMER_WHEEL_SLOTS_]; ///< The lists of timers per slot.
+    uint64_t current;        ///< The next tick to process.
+    uint64_t resolution_ns;  ///< The duration of a tick.
+    libos_time_t start;      ///< The time of tick 0.
+    uint32_t armed_count;    ///< The number of timers in the slots.
+    libos_timer_t *expired;  ///< The expired timers whose callback wasn't called yet, in expiry order.
+    libos_timer_t **expired_tail; ///< The next pointer of the last expired timer.
+} libos_timer_wheel_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Initializes a timer as not armed.
+ * 
+ * @param[out] timer The timer to initialize.
+ */
+static inline void libos_timer_init(libos_timer_t *timer)
+{
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->pending = false;
+    timer->expires = 0;
+    timer->callback = NULL;
+    timer->arg = NULL;
+}
+
+/**
+ * @brief Checks if the timer is waiting in a wheel.
+ * 
+ * @param[in] timer The timer to check.
+ * 
+ * @retval true The timer is armed.
+ * @retval false The timer is not armed, it expired or is cancelled.
+ */
+static inline bool libos_timer_is_armed(const libos_timer_t *timer)
+{
+    return timer->pprev != NULL && !timer->pending;
+}
+
+/**
+ * @brief Checks if the timer expired and waits for its callback to be called.
+ * 
+ * @param[in] timer The timer to check.
+ * 
+ * @retval true The timer is collected by libos_timer_wheel_collect and not popped yet.
+ * @retval false The timer is idle or armed.
+ */
+static inline bool libos_timer_is_pending(const libos_timer_t *timer)
+{
+    return timer->pending;
+}
+
+/**
+ * @brief Initializes an empty timer wheel.
+ * 
+ * @param[out] wheel The wheel to initialize.
+ * @param[in] now The current time, the start of the first tick.
+ * @param[in] resolution The duration of a tick (at least 1 ns).
+ * 
+ * @retval LIBOS_ERR_OK The wheel is initialized.
+ * @retval LIBOS_ERR_INVALID_ARG @ref wheel is NULL or @ref resolution is not positive.
+ * 
+ * @return libos_err_t The libos standard success code for initializing the wheel.
+ */
+static inline libos_err_t libos_timer_wheel_init(libos_timer_wheel_t *wheel, libos_time_t now, libos_time_t resolution)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(wheel);
+    libos_time_nanoseconds_t resolution_ns = libos_time_to_ns(resolution);
+    LIBOS_ERR_RET_ON_TRUE(resolution_ns <= 0, LIBOS_ERR_INVALID_ARG);
+
+    for (size_t level = 0; level < LIBOS_TIMER_WHEEL_LEVELS; level++)
+    {
+        for (size_t slot = 0; slot < LIBOS_TIMER_WHEEL_SLOTS_; slot++)
+        {
+            wheel->slots[level][slot] = NULL;
+        }
+    }
+    wheel->current = 0;
+    wheel->resolution_ns = (uint64_t)resolution_ns;
+    wheel->start = now;
+    wheel->armed_count = 0;
+    wheel->expired = NULL;
+    wheel->expired_tail = &wheel->expired;
+    return LIBOS_ERR_OK;
+}
+
+static inline void libos_timer_list_insert_(libos_timer_t **head, libos_timer_t *timer)
+{
+    timer->next = *head;
+    if (timer->next != NULL)
+    {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = head;
+    *head = timer;
+}
+
+static inline void libos_timer_list_remove_(libos_timer_t *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next != NULL)
+    {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+// Removes an armed or pending timer from its list, leaving it idle.
+static inline void libos_timer_wheel_unlink_(libos_timer_wheel_t *wheel, libos_timer_t *timer)
+{
+    if (timer->pending)
+    {
+        if (timer->next == NULL)
+        {
+            wheel->expired_tail = timer->pprev;
+        }
+        timer->pending = false;
+    }
+    else
+    {
+        wheel->armed_count--;
+    }
+    libos_timer_list_remove_(timer);
+}
+
+// Places the timer in the slot of the level that covers the distance to its expiry.
+static inline void libos_timer_wheel_place_(libos_timer_wheel_t *wheel, libos_timer_t *timer)
+{
+    uint64_t delta = (timer->expires > wheel->current) ? (timer->expires - wheel->current) : 0;
+    if (delta > LIBOS_TIMER_WHEEL_MAX_DELTA_)
+    {
+        // Out of range, it comes by again in the highest level until it's in range.
+        delta = LIBOS_TIMER_WHEEL_MAX_DELTA_;
+    }
+    uint64_t target = wheel->current + delta;
+
+    size_t level = 0;
+    while (level < (LIBOS_TIMER_WHEEL_LEVELS - 1) && (delta >> (LIBOS_TIMER_WHEEL_SLOT_BITS * (level + 1))) != 0)
+    {
+        level++;
+    }
+    size_t slot = (size_t)((target >> (LIBOS_TIMER_WHEEL_SLOT_BITS * level)) & LIBOS_TIMER_WHEEL_SLOT_MASK_);
+    libos_timer_list_insert_(&wheel->slots[level][slot], timer);
+}
+
+/**
+ * @brief Arms the timer to expire at @ref deadline.
+ * 
+ * @details
+ * If the timer is already armed, or expired but not called yet, it is
+ * moved to the new deadline. The deadline is rounded up to the next tick, so the timer never expires early.
+ * A deadline in the past expires on the next libos_timer_wheel_advance.
+ * 
+ * @param[in] wheel The wheel to arm the timer in.
+ * @param[in] timer The timer to arm, initialized with libos_timer_init.
+ * @param[in] deadline The time at which the timer expires.
+ * @param[in] callback The function to call on expiry.
+ * @param[in] arg The argument for the callback.
+ * 
+ * @retval LIBOS_ERR_OK The timer is armed.
+ * @retval LIBOS_ERR_INVALID_ARG @ref wheel, @ref timer and/or @ref callback is NULL.
+ * 
+ * @return libos_err_t The libos standard success code for arming the timer.
+ */
+static inline libos_err_t libos_timer_arm_at(libos_timer_wheel_t *wheel, libos_timer_t *timer, libos_time_t deadline, libos_timer_callback_t callback, void *arg)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(wheel);
+    LIBOS_ERR_RET_ARG_NOT_NULL(timer);
+    LIBOS_ERR_RET_ARG_NOT_NULL(callback);
+
+    if (timer->pprev != NULL)
+    {
+        libos_timer_wheel_unlink_(wheel, timer);
+    }
+
+    libos_time_nanoseconds_t offset_ns = libos_time_difference_ns(wheel->start, deadline);
+    uint64_t expires = 0;
+    if (offset_ns > 0)
+    {
+        expires = ((uint64_t)offset_ns + wheel->resolution_ns - 1) / wheel->resolution_ns;
+    }
+    timer->expires = (expires > wheel->current) ? expires : wheel->current;
+    timer->callback = callback;
+    timer->arg = arg;
+    libos_timer_wheel_place_(wheel, timer);
+    wheel->armed_count++;
+    return LIBOS_ERR_OK;
+}
+
+/**
+ * @brief Arms the timer to expire @ref timeout from now (libos_time_get_now).
+ * 
+ * @see libos_timer_arm_at
+ * 
+ * @param[in] wheel The wheel to arm the timer in.
+ * @param[in] timer The timer to arm, initialized with libos_timer_init.
+ * @param[in] timeout The time from now at which the timer expires.
+ * @param[in] callback The function to call on expiry.
+ * @param[in] arg The argument for the callback.
+ * 
+ * @retval LIBOS_ERR_OK The timer is armed.
+ * @retval LIBOS_ERR_INVALID_ARG @ref wheel, @ref timer and/or @ref callback is NULL.
+ * 
+ * @return libos_err_t The libos standard success code for arming the timer.
+ */
+static inline libos_err_t libos_timer_arm(libos_timer_wheel_t *wheel, libos_timer_t *timer, libos_time_t timeout, libos_timer_callback_t callback, void *arg)
+{
+    return libos_timer_arm_at(wheel, timer, libos_time_add(libos_time_get_now(), timeout), callback, arg);
+}
+
+/**
+ * @brief Cancels the timer if it is armed or pending.
+ * 
+ * @param[in] wheel The wheel the timer is armed in.
+ * @param[in] timer The timer to cancel.
+ * 
+ * @retval true The timer was armed or pending and is cancelled, the callback won't be called.
+ * @retval false The timer was idle (or its callback is already running).
+ */
+static inline bool libos_timer_cancel(libos_timer_wheel_t *wheel, libos_timer_t *timer)
+{
+    if (timer->pprev == NULL)
+    {
+        return false;
+    }
+    libos_timer_wheel_unlink_(wheel, timer);
+    return true;
+}
+
+// Moves all the timers of a higher level slot to the slots matching their new distance.
+static inline void libos_timer_wheel_cascade_(libos_timer_wheel_t *wheel, size_t level, size_t slot)
+{
+    libos_timer_t *timer = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    while (timer != NULL)
+    {
+        libos_timer_t *next = timer->next;
+        timer->pprev = NULL;
+        libos_timer_wheel_place_(wheel, timer);
+        timer = next;
+    }
+}
+
+/**
+ * @brief Moves all the timers that expired at @ref now to the expired list of the wheel, without calling them.
+ * 
+ * @details
+ * The timers are pending when this returns (see libos_timer_is_pending),
+ * until they are taken by libos_timer_wheel_pop_expired or
+ * libos_timer_run_expired. A pending timer can still be cancelled or armed
+ * again, which removes it from the expired list.
+ * 
+ * @param[in] wheel The wheel to advance.
+ * @param[in] now The current time.
+ * 
+ * @return size_t The number of timers that expired.
+ */
+static inline size_t libos_timer_wheel_collect(libos_timer_wheel_t *wheel, libos_time_t now)
+{
+    libos_time_nanoseconds_t elapsed_ns = libos_time_difference_ns(wheel->start, now);
+    if (elapsed_ns < 0)
+    {
+        return 0;
+    }
+    uint64_t target = (uint64_t)elapsed_ns / wheel->resolution_ns;
+
+    size_t count = 0;
+    while (wheel->current <= target)
+    {
+        if (wheel->armed_count == 0)
+        {
+            // Nothing can expire, skip the remaining ticks at once.
+            wheel->current = target + 1;
+            break;
+        }
+
+        size_t slot = (size_t)(wheel->current & LIBOS_TIMER_WHEEL_SLOT_MASK_);
+        for (size_t level = 1; slot == 0 && level < LIBOS_TIMER_WHEEL_LEVELS; level++)
+        {
+            // The lower level wrapped around, bring down the timers of the next slot of this level.
+            size_t upper = (size_t)((wheel->current >> (LIBOS_TIMER_WHEEL_SLOT_BITS * level)) & LIBOS_TIMER_WHEEL_SLOT_MASK_);
+            libos_timer_wheel_cascade_(wheel, level, upper);
+            slot = upper;
+        }
+
+        libos_timer_t *timer = wheel->slots[0][wheel->current & LIBOS_TIMER_WHEEL_SLOT_MASK_];
+        wheel->slots[0][wheel->current & LIBOS_TIMER_WHEEL_SLOT_MASK_] = NULL;
+        while (timer != NULL)
+        {
+            libos_timer_t *next = timer->next;
+            timer->next = NULL;
+            timer->pprev = wheel->expired_tail;
+            timer->pending = true;
+            *wheel->expired_tail = timer;
+            wheel->expired_tail = &timer->next;
+            wheel->armed_count--;
+            count++;
+            timer = next;
+        }
+        wheel->current++;
+    }
+    return count;
+}
+
+/**
+ * @brief Takes the oldest pending timer from the expired list.
+ * 
+ * @details
+ * The timer is idle when this returns, the caller calls @ref callback with
+ * the timer and @ref arg. The callback and argument are returned separately,
+ * so the call can be made after unlocking a wheel that is shared between
+ * tasks.
+ * 
+ * @param[in] wheel The wheel to take the timer from.
+ * @param[out] timer The expired timer.
+ * @param[out] callback The callback of the timer.
+ * @param[out] arg The argument for the callback.
+ * 
+ * @retval true A timer was taken.
+ * @retval false No timer is pending.
+ */
+static inline bool libos_timer_wheel_pop_expired(libos_timer_wheel_t *wheel, libos_timer_t **timer, libos_timer_callback_t *callback, void **arg)
+{
+    libos_timer_t *first = wheel->expired;
+    if (first == NULL)
+    {
+        return false;
+    }
+    libos_timer_wheel_unlink_(wheel, first);
+    *timer = first;
+    *callback = first->callback;
+    *arg = first->arg;
+    return true;
+}
+
+/**
+ * @brief Calls the callbacks of the pending timers collected by libos_timer_wheel_collect.
+ * 
+ * @details
+ * Every timer is removed from the expired list before its callback is
+ * called, so the callbacks are allowed to arm and cancel timers of this
+ * wheel, including the pending ones.
+ * 
+ * @param[in] wheel The wheel with the expired timers.
+ * 
+ * @return size_t The number of callbacks called.
+ */
+static inline size_t libos_timer_run_expired(libos_timer_wheel_t *wheel)
+{
+    size_t count = 0;
+    libos_timer_t *timer;
+    libos_timer_callback_t callback;
+    void *arg;
+    while (libos_timer_wheel_pop_expired(wheel, &timer, &callback, &arg))
+    {
+        callback(timer, arg);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Processes all the ticks up to @ref now and calls the callbacks of the expired timers.
+ * 
+ * @details
+ * The callbacks are allowed to arm and cancel timers of this wheel.
+ * 
+ * @param[in] wheel The wheel to advance.
+ * @param[in] now The current time.
+ * 
+ * @return size_t The number of callbacks called.
+ */
+static inline size_t libos_timer_wheel_advance(libos_timer_wheel_t *wheel, libos_time_t now)
+{
+    libos_timer_wheel_collect(wheel, now);
+    return libos_timer_run_expired(wheel);
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // LIBOS_TIMER_H
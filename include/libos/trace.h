@@ -0,0 +1,377 @@
+/**
+ * @file trace.h
+ * @brief Lightweight trace event recorder for timelines of the hot paths.
+ * 
+ * @details
+ * With LIBOS_ENABLE_TRACE set to 1, the LIBOS_TRACE_* macros record compact
+ * fixed-size events into a ring buffer per thread. Recording an event is a
+ * libos_time_ticks_now reading and a 16 byte store into the ring of the
+ * calling thread, without any lock. When tracing is disabled the macros
+ * compile to nothing, the arguments aren't even evaluated.
+ * 
+ * @code{.c}
+ * void process(void) {
+ *   LIBOS_TRACE_BEGIN("process");
+ *   LIBOS_TRACE_COUNTER("queue_depth", depth);
+ *   LIBOS_TRACE_INSTANT("flush");
+ *   LIBOS_TRACE_END("process");
+ * }
+ * @endcode
+ * 
+ * Every begin has to be matched by a end with the same name on the same
+ * thread, the events of a thread nest like a call stack.
+ * 
+ * The rings are flight recorders, a full ring overwrites its oldest events.
+ * A thread claims a ring on its first event, up to LIBOS_TRACE_MAX_THREADS
+ * threads are recorded, the events of the other threads are only counted.
+ * Rings are not given back when a thread ends. The storage is defined with
+ * LIBOS_TRACE_DEFINE in exactly one source file.
+ * 
+ * The rings are written to a byte stream with libos_trace_dump, for example
+ * over a serial link or to a file. The host tool tools/libos_trace_convert.py
+ * converts the dump into a Chrome trace event JSON file that can be opened in
+ * Perfetto (ui.perfetto.dev) or chrome://tracing. Stop the recording with
+ * libos_trace_pause before dumping, a event recorded during the dump can end
+ * up torn.
+ * 
+ * Like the binary log (see log_binary.h), the names are placed in a section,
+ * libos_trace_names, and replaced by their offset in that section. The host
+ * tool reads the names from the ELF file of the firmware. The section only
+ * has to be present in the ELF file, see log_binary.h to keep it out of the
+ * image. A toolchain without the __start_libos_trace_names symbol can define
+ * LIBOS_TRACE_NAME_ID(name) to something else.
+ * 
+ * Dump layout (all integers in the byte order of the target, the tool
+ * detects it from the magic):
+ * 
+ *  * a libos_trace_dump_header_t: the magic LIBOS_TRACE_DUMP_MAGIC, the
+ *    version (1), the size of a record (16), the
+ *    libos_time_ticks_calibration_t (0 if unknown) and the number of events
+ *    dropped because all the rings were claimed.
+ *  * per claimed ring: uint32 thread ID, uint32 number of records, uint32
+ *    number of overwritten records, and the records, the oldest first.
+ * 
+ * A record is a libos_trace_record_t: the uint64 tick timestamp, a uint32
+ * with the type in the highest 4 bits and the name ID in the others, and a
+ * uint32 value. The thread ID is stored once per ring.
+ * 
+ * When LIBOS_TRACE_ENABLE_MUTEX is 1 (the default when tracing), mutex.h
+ * provides hooks for the platform mutex implementation, which record the
+ * waits for a contended mutex as libos_mutex_wait slices and the lock and
+ * unlock as instants, with the handle as value.
+ */
+
+#pragma once
+#ifndef LIBOS_TRACE_H
+#define LIBOS_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "libos/error.h"
+#include "libos/time.h"
+
+#ifndef LIBOS_ENABLE_TRACE
+#define LIBOS_ENABLE_TRACE 0
+#endif // LIBOS_ENABLE_TRACE
+
+/**
+ * @brief The event types, stored in the highest 4 bits of the event word.
+ */
+typedef enum {
+    LIBOS_TRACE_TYPE_BEGIN = 0,     ///< Start of a slice.
+    LIBOS_TRACE_TYPE_END = 1,       ///< End of the last started slice.
+    LIBOS_TRACE_TYPE_INSTANT = 2,   ///< A single point in time.
+    LIBOS_TRACE_TYPE_COUNTER = 3,   ///< A new value of a counter.
+} libos_trace_type_t;
+
+#if LIBOS_ENABLE_TRACE==1
+
+#include "libos/concurrent/atomic.h"
+
+/**
+ * @brief The number of records in the ring of a thread (a power of two).
+ */
+#ifndef LIBOS_TRACE_RING_SIZE
+#define LIBOS_TRACE_RING_SIZE 256
+#endif // LIBOS_TRACE_RING_SIZE
+
+#if (LIBOS_TRACE_RING_SIZE & (LIBOS_TRACE_RING_SIZE - 1)) != 0
+#error "LIBOS_TRACE_RING_SIZE has to be a power of two."
+#endif // (LIBOS_TRACE_RING_SIZE & (LIBOS_TRACE_RING_SIZE - 1)) != 0
+
+/**
+ * @brief The maximum number of threads that get a ring.
+ */
+#ifndef LIBOS_TRACE_MAX_THREADS
+#define LIBOS_TRACE_MAX_THREADS 8
+#endif // LIBOS_TRACE_MAX_THREADS
+
+/**
+ * @brief Set to 0 to not record the mutex lock and unlock paths.
+ */
+#ifndef LIBOS_TRACE_ENABLE_MUTEX
+#define LIBOS_TRACE_ENABLE_MUTEX 1
+#endif // LIBOS_TRACE_ENABLE_MUTEX
+
+/**
+ * @brief The first word of a dump ("LTRC" in big endian).
+ */
+#define LIBOS_TRACE_DUMP_MAGIC UINT32_C(0x4C545243)
+
+// The event word of a record.
+#define LIBOS_TRACE_EVENT_SHIFT_ 28
+#define LIBOS_TRACE_EVENT_NAME_MASK_ ((UINT32_C(1) << LIBOS_TRACE_EVENT_SHIFT_) - 1)
+
+#ifndef LIBOS_TRACE_NAME_ID
+#ifdef __cplusplus
+extern "C" const char __start_libos_trace_names[];
+#else // __cplusplus
+extern const char __start_libos_trace_names[];
+#endif // __cplusplus
+/**
+ * @brief The ID of the name, by default the offset in the libos_trace_names section.
+ */
+#define LIBOS_TRACE_NAME_ID(name) ((uint32_t)((uintptr_t)(name) - (uintptr_t)__start_libos_trace_names))
+#endif // LIBOS_TRACE_NAME_ID
+
+/**
+ * @brief A single event.
+ */
+typedef struct {
+    uint64_t ticks;     ///< The libos_time_ticks_now timestamp.
+    uint32_t event;     ///< The type (highest 4 bits) and the name ID.
+    uint32_t value;     ///< The value of a counter, or a user value for the other types.
+} libos_trace_record_t;
+
+/**
+ * @brief The ring of a thread.
+ */
+typedef struct {
+    libos_atomic_uint32_t head;                         ///< The number of records written, only written by the thread.
+    uint32_t thread;                                    ///< The thread ID in the dump, the index of the ring.
+    libos_trace_record_t records[LIBOS_TRACE_RING_SIZE];
+} libos_trace_ring_t;
+
+/**
+ * @brief The global trace state.
+ * 
+ * @details
+ * The members are an implementation detail and should not be accessed
+ * directly. It is zero initialized, which means recording with no rings
+ * claimed.
+ */
+typedef struct {
+    libos_atomic_uint32_t paused;       ///< Nonzero while recording is paused.
+    libos_atomic_uint32_t claimed;      ///< The number of rings handed out.
+    libos_atomic_uint32_t dropped;      ///< Events of threads without a ring.
+    libos_trace_ring_t rings[LIBOS_TRACE_MAX_THREADS];
+} libos_trace_t;
+
+/**
+ * @brief The header at the start of a dump.
+ */
+typedef struct {
+    uint32_t magic;         ///< LIBOS_TRACE_DUMP_MAGIC.
+    uint16_t version;       ///< The version of the layout, 1.
+    uint16_t record_size;   ///< The size of a libos_trace_record_t.
+    uint32_t mult;          ///< The libos_time_ticks_calibration_t multiplier, 0 if unknown.
+    uint32_t shift;         ///< The libos_time_ticks_calibration_t shift.
+    uint32_t dropped;       ///< The events dropped because all the rings were claimed.
+} libos_trace_dump_header_t;
+
+/**
+ * @brief Receives a part of the dump.
+ * 
+ * @param[in] context The context given to libos_trace_dump.
+ * @param[in] data The bytes to write.
+ * @param[in] size The number of bytes.
+ */
+typedef void (*libos_trace_write_fn_t)(void *context, const void *data, size_t size);
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+extern libos_trace_t libos_trace_;
+extern LIBOS_THREAD_LOCAL libos_trace_ring_t *libos_trace_ring_;
+
+// Claims a ring for the calling thread, NULL if they are all taken.
+static inline libos_trace_ring_t *libos_trace_claim_ring_(void)
+{
+    uint32_t index = LIBOS_ATOMIC_LOAD(&libos_trace_.claimed, LIBOS_ATOMIC_RELAXED);
+    do
+    {
+        if (index >= LIBOS_TRACE_MAX_THREADS)
+        {
+            return NULL;
+        }
+    } while (!LIBOS_ATOMIC_COMPARE_EXCHANGE_WEAK(&libos_trace_.claimed, &index, index + 1, LIBOS_ATOMIC_ACQ_REL, LIBOS_ATOMIC_RELAXED));
+
+    libos_trace_ring_t *ring = &libos_trace_.rings[index];
+    ring->thread = index;
+    libos_trace_ring_ = ring;
+    return ring;
+}
+
+/**
+ * @brief Records a event in the ring of the calling thread, used by the LIBOS_TRACE_* macros.
+ * 
+ * @param[in] type The type of the event.
+ * @param[in] name The ID of the name (LIBOS_TRACE_NAME_ID).
+ * @param[in] value The value of the event.
+ */
+static inline void libos_trace_record(libos_trace_type_t type, uint32_t name, uint32_t value)
+{
+    if (LIBOS_ATOMIC_LOAD(&libos_trace_.paused, LIBOS_ATOMIC_RELAXED) != 0)
+    {
+        return;
+    }
+
+    libos_trace_ring_t *ring = libos_trace_ring_;
+    if (ring == NULL)
+    {
+        ring = libos_trace_claim_ring_();
+        if (ring == NULL)
+        {
+            LIBOS_ATOMIC_FETCH_ADD(&libos_trace_.dropped, 1, LIBOS_ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    uint32_t head = LIBOS_ATOMIC_LOAD(&ring->head, LIBOS_ATOMIC_RELAXED);
+    libos_trace_record_t *record = &ring->records[head & (LIBOS_TRACE_RING_SIZE - 1)];
+    record->ticks = libos_time_ticks_now();
+    record->event = ((uint32_t)type << LIBOS_TRACE_EVENT_SHIFT_) | (name & LIBOS_TRACE_EVENT_NAME_MASK_);
+    record->value = value;
+    // Release, so a dump that sees the new head sees the record.
+    LIBOS_ATOMIC_STORE(&ring->head, head + 1, LIBOS_ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Pauses the recording of all threads, for example to dump the rings.
+ */
+static inline void libos_trace_pause(void)
+{
+    LIBOS_ATOMIC_STORE(&libos_trace_.paused, 1, LIBOS_ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Resumes the recording after libos_trace_pause.
+ */
+static inline void libos_trace_resume(void)
+{
+    LIBOS_ATOMIC_STORE(&libos_trace_.paused, 0, LIBOS_ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Empties the rings, they stay claimed by their threads.
+ * 
+ * @details
+ * Only call this while the recording is paused.
+ */
+static inline void libos_trace_clear(void)
+{
+    uint32_t claimed = LIBOS_ATOMIC_LOAD(&libos_trace_.claimed, LIBOS_ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < claimed && i < LIBOS_TRACE_MAX_THREADS; i++)
+    {
+        LIBOS_ATOMIC_STORE(&libos_trace_.rings[i].head, 0, LIBOS_ATOMIC_RELAXED);
+    }
+    LIBOS_ATOMIC_STORE(&libos_trace_.dropped, 0, LIBOS_ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Writes all the recorded events to @ref write, in the dump layout described above.
+ * 
+ * @param[in] write The function that receives the bytes.
+ * @param[in] context The context for @ref write.
+ * @param[in] calibration The conversion of the ticks to nanoseconds, stored in the dump for the host tool (can be NULL).
+ * 
+ * @retval LIBOS_ERR_OK The events are written.
+ * @retval LIBOS_ERR_INVALID_ARG @ref write is NULL.
+ * 
+ * @return libos_err_t The libos standard success code for dumping the events.
+ */
+static inline libos_err_t libos_trace_dump(libos_trace_write_fn_t write, void *context, const libos_time_ticks_calibration_t *calibration)
+{
+    LIBOS_ERR_RET_ARG_NOT_NULL(write);
+
+    libos_trace_dump_header_t header = {
+        LIBOS_TRACE_DUMP_MAGIC,
+        1,
+        (uint16_t)sizeof(libos_trace_record_t),
+        (calibration != NULL) ? calibration->mult : 0,
+        (calibration != NULL) ? calibration->shift : 0,
+        LIBOS_ATOMIC_LOAD(&libos_trace_.dropped, LIBOS_ATOMIC_RELAXED),
+    };
+    write(context, &header, sizeof(header));
+
+    uint32_t claimed = LIBOS_ATOMIC_LOAD(&libos_trace_.claimed, LIBOS_ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < claimed && i < LIBOS_TRACE_MAX_THREADS; i++)
+    {
+        const libos_trace_ring_t *ring = &libos_trace_.rings[i];
+        uint32_t head = LIBOS_ATOMIC_LOAD(&ring->head, LIBOS_ATOMIC_ACQUIRE);
+        uint32_t count = (head < LIBOS_TRACE_RING_SIZE) ? head : LIBOS_TRACE_RING_SIZE;
+        uint32_t ring_header[3] = { i, count, head - count };
+        write(context, ring_header, sizeof(ring_header));
+
+        // The oldest record first, in up to two contiguous parts.
+        uint32_t first = (head - count) & (LIBOS_TRACE_RING_SIZE - 1);
+        uint32_t part = (LIBOS_TRACE_RING_SIZE - first < count) ? LIBOS_TRACE_RING_SIZE - first : count;
+        write(context, &ring->records[first], part * sizeof(libos_trace_record_t));
+        if (part < count)
+        {
+            write(context, &ring->records[0], (count - part) * sizeof(libos_trace_record_t));
+        }
+    }
+    return LIBOS_ERR_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+/**
+ * @brief Defines the trace rings, has to be used in exactly one source file at file scope.
+ */
+#define LIBOS_TRACE_DEFINE() libos_trace_t libos_trace_; LIBOS_THREAD_LOCAL libos_trace_ring_t *libos_trace_ring_
+
+/**
+ * @brief Records a event of @ref type with the string literal @ref name and @ref value.
+ */
+#define LIBOS_TRACE_EVENT(type, name, value) do { \
+        static const char libos_trace_name_[] __attribute__((section("libos_trace_names"), used)) = name; \
+        libos_trace_record((type), LIBOS_TRACE_NAME_ID(libos_trace_name_), (uint32_t)(value)); \
+    } while(0)
+
+#else // LIBOS_ENABLE_TRACE==1
+
+#undef LIBOS_TRACE_ENABLE_MUTEX
+#define LIBOS_TRACE_ENABLE_MUTEX 0
+#define LIBOS_TRACE_DEFINE() extern int libos_trace_disabled_
+#define LIBOS_TRACE_EVENT(type, name, value) do { } while(0)
+
+#endif // LIBOS_ENABLE_TRACE==1
+
+/**
+ * @brief Starts a slice with the string literal @ref name on the calling thread.
+ */
+#define LIBOS_TRACE_BEGIN(name) LIBOS_TRACE_EVENT(LIBOS_TRACE_TYPE_BEGIN, name, 0)
+
+/**
+ * @brief Ends the last started slice (with the same @ref name) on the calling thread.
+ */
+#define LIBOS_TRACE_END(name) LIBOS_TRACE_EVENT(LIBOS_TRACE_TYPE_END, name, 0)
+
+/**
+ * @brief Records a point in time with the string literal @ref name.
+ */
+#define LIBOS_TRACE_INSTANT(name) LIBOS_TRACE_EVENT(LIBOS_TRACE_TYPE_INSTANT, name, 0)
+
+/**
+ * @brief Records the new @ref value (truncated to 32 bits) of the counter with the string literal @ref name.
+ */
+#define LIBOS_TRACE_COUNTER(name, value) LIBOS_TRACE_EVENT(LIBOS_TRACE_TYPE_COUNTER, name, value)
+
+#endif // LIBOS_TRACE_H
@@ -1,12 +1,46 @@
 set(LIBOS_SRCS
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/bitmap.h"
     "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/error.h"
     "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/time.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/timer.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/trace.h"
     "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log_binary.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log_buffered.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log_deferred.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log_ratelimit.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log_runtime.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/atomic.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/condvar.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/event_group.h"
     "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/mutex.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/rwlock.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/semaphore.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/spsc_ring.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/thread.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/wait_address.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/workpool.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/ws_deque.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/memory/arena.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/memory/pool.h"
 )
 
+set(LIBOS_INCLUDE_DIRS "${CMAKE_CURRENT_SOURCE_DIR}/include")
+
+# The benchmarks are built into the component, the application calls libos_bench_run_all (bench/bench.h) from app_main.
+if ("${CONFIG_LIBOS_ENABLE_BENCHMARKS}" STREQUAL "y")
+    list(APPEND LIBOS_SRCS
+        "${CMAKE_CURRENT_SOURCE_DIR}/bench/bench.c"
+        "${CMAKE_CURRENT_SOURCE_DIR}/bench/bench_bits.c"
+        "${CMAKE_CURRENT_SOURCE_DIR}/bench/bench_contention.c"
+        "${CMAKE_CURRENT_SOURCE_DIR}/bench/bench_mutex.c"
+        "${CMAKE_CURRENT_SOURCE_DIR}/bench/bench_time.c"
+    )
+    list(APPEND LIBOS_INCLUDE_DIRS "${CMAKE_CURRENT_SOURCE_DIR}/bench")
+endif()
+
 idf_component_register(SRCS ${LIBOS_SRCS}
-                       INCLUDE_DIRS "${CMAKE_CURRENT_SOURCE_DIR}/include")
+                       INCLUDE_DIRS ${LIBOS_INCLUDE_DIRS})
 
 function(libos_convert_config_to_target var_name)
     if ("${CONFIG_${var_name}}" STREQUAL "y")
@@ -17,8 +51,20 @@ function(libos_convert_config_to_target var_name)
 endfunction()
 
 libos_convert_config_to_target(LIBOS_MUTEX_ENABLE_RECURSIVE)
+libos_convert_config_to_target(LIBOS_MUTEX_ENABLE_ADAPTIVE)
+libos_convert_config_to_target(LIBOS_MUTEX_ENABLE_STATS)
 libos_convert_config_to_target(LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION)
 libos_convert_config_to_target(LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION)
+libos_convert_config_to_target(LIBOS_MUTEX_ENABLE_POOL_ALLOCATION)
+libos_convert_config_to_target(LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK)
+libos_convert_config_to_target(LIBOS_WAIT_ADDRESS_ENABLE_NATIVE)
+libos_convert_config_to_target(LIBOS_ENABLE_TRACE)
+libos_convert_config_to_target(LIBOS_LOG_ENABLE_DEFERRED)
+libos_convert_config_to_target(LIBOS_LOG_ENABLE_BINARY)
+libos_convert_config_to_target(LIBOS_LOG_ENABLE_BUFFERED)
+libos_convert_config_to_target(LIBOS_LOG_ENABLE_RUNTIME_LEVEL)
+libos_convert_config_to_target(LIBOS_ERR_ENABLE_FAILURE_HOOK)
+libos_convert_config_to_target(LIBOS_ERR_ENABLE_TRACE)
 
 if (${CONFIG_LIBOS_ENABLE_TESTING})
     enable_testing()
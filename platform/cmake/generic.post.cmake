@@ -1,14 +1,47 @@
 # By default, all features on. This is what the most generic situation support usually.
 option(LIBOS_ENABLE_TESTING "Enable unit tests" OFF)
+option(LIBOS_ENABLE_BENCHMARKS "Enable the libos-bench micro-benchmark target" OFF)
 option(LIBOS_MUTEX_ENABLE_RECURSIVE "Enable recursive mutexes" ON)
+option(LIBOS_MUTEX_ENABLE_ADAPTIVE "Enable adaptive (spin-then-block) mutexes" ON)
+option(LIBOS_MUTEX_ENABLE_STATS "Enable mutex contention and hold time statistics" OFF)
 option(LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION "Enable dynamic allocation of structures using malloc/free" ON)
 option(LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION "Enable static allocation of structures" ON)
+option(LIBOS_MUTEX_ENABLE_POOL_ALLOCATION "Enable creating mutexes from a fixed-block memory pool" OFF)
+option(LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK "Implement libos_mutex_try_lock with a zero timeout libos_mutex_lock (for ports without a native try-lock)" OFF)
+option(LIBOS_WAIT_ADDRESS_ENABLE_NATIVE "Use the native wait-on-address primitive of the platform (futex) instead of the hashed wait queue" OFF)
+option(LIBOS_ENABLE_TRACE "Enable the trace event recorder (libos/trace.h), including the mutex hooks" OFF)
+option(LIBOS_LOG_ENABLE_DEFERRED "Enable deferred logging (capture in the caller, format in a background task)" OFF)
+option(LIBOS_LOG_ENABLE_BINARY "Enable binary logging (format strings replaced by IDs, decoded on the host)" OFF)
+option(LIBOS_LOG_ENABLE_BUFFERED "Enable buffered logging (lines collected per thread, written in batches)" OFF)
+option(LIBOS_LOG_ENABLE_RUNTIME_LEVEL "Enable per-module log levels that can be changed at run-time" OFF)
+option(LIBOS_ERR_ENABLE_FAILURE_HOOK "Enable calling libos_err_on_failure on every error return of the LIBOS_ERR_* macros" OFF)
+option(LIBOS_ERR_ENABLE_TRACE "Enable recording the error returns of the LIBOS_ERR_* macros in a ring per thread" OFF)
 
 set(LIBOS_SRCS
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/bitmap.h"
     "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/error.h"
     "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/time.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/timer.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/trace.h"
     "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log_binary.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log_buffered.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log_deferred.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log_ratelimit.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/log_runtime.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/atomic.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/condvar.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/event_group.h"
     "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/mutex.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/rwlock.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/semaphore.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/spsc_ring.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/thread.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/wait_address.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/workpool.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/concurrent/ws_deque.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/memory/arena.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/include/libos/memory/pool.h"
 )
 
 add_library(${PROJECT_NAME} INTERFACE ${LIBOS_SRCS})
@@ -25,10 +58,26 @@ if (NOT COMMAND libos_option_to_definition)
 endif()
 
 libos_option_to_definition(${PROJECT_NAME} LIBOS_MUTEX_ENABLE_RECURSIVE LIBOS_MUTEX_ENABLE_RECURSIVE)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_MUTEX_ENABLE_ADAPTIVE LIBOS_MUTEX_ENABLE_ADAPTIVE)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_MUTEX_ENABLE_STATS LIBOS_MUTEX_ENABLE_STATS)
 libos_option_to_definition(${PROJECT_NAME} LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION LIBOS_MUTEX_ENABLE_DYNAMIC_ALLOCATION)
 libos_option_to_definition(${PROJECT_NAME} LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION LIBOS_MUTEX_ENABLE_STATIC_ALLOCATION)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_MUTEX_ENABLE_POOL_ALLOCATION LIBOS_MUTEX_ENABLE_POOL_ALLOCATION)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK LIBOS_MUTEX_ENABLE_TIMED_TRY_LOCK)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_WAIT_ADDRESS_ENABLE_NATIVE LIBOS_WAIT_ADDRESS_ENABLE_NATIVE)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_ENABLE_TRACE LIBOS_ENABLE_TRACE)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_LOG_ENABLE_DEFERRED LIBOS_LOG_ENABLE_DEFERRED)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_LOG_ENABLE_BINARY LIBOS_LOG_ENABLE_BINARY)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_LOG_ENABLE_BUFFERED LIBOS_LOG_ENABLE_BUFFERED)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_LOG_ENABLE_RUNTIME_LEVEL LIBOS_LOG_ENABLE_RUNTIME_LEVEL)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_ERR_ENABLE_FAILURE_HOOK LIBOS_ERR_ENABLE_FAILURE_HOOK)
+libos_option_to_definition(${PROJECT_NAME} LIBOS_ERR_ENABLE_TRACE LIBOS_ERR_ENABLE_TRACE)
 
 if (${LIBOS_ENABLE_TESTING})
     enable_testing()
     add_subdirectory(tests)
 endif()
+
+if (${LIBOS_ENABLE_BENCHMARKS})
+    add_subdirectory(bench)
+endif()
@@ -0,0 +1,134 @@
+#include <stdint.h>
+#include "ctest.h"
+
+#include "libos/memory/arena.h"
+
+// ====================
+//
+// libos_arena_init
+//
+// ====================
+
+CTEST(arena_init, staticStorage)
+{
+	LIBOS_ARENA_STATIC_DATA_STRUCT(data, 60);
+	libos_arena_t arena;
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_ARENA_CREATE_STATIC(data, arena));
+	ASSERT_EQUAL(64, sizeof(data));
+	ASSERT_EQUAL(0, libos_arena_used(&arena));
+	ASSERT_EQUAL(64, libos_arena_remaining(&arena));
+}
+
+CTEST(arena_init, invalidArguments)
+{
+	uint64_t data[4];
+	libos_arena_t arena;
+
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_arena_init(NULL, data, sizeof(data)));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_arena_init(&arena, NULL, sizeof(data)));
+}
+
+// ====================
+//
+// libos_arena_alloc
+//
+// ====================
+
+CTEST(arena_alloc, defaultAlignment)
+{
+	LIBOS_ARENA_STATIC_DATA_STRUCT(data, 32);
+	libos_arena_t arena;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_ARENA_CREATE_STATIC(data, arena));
+
+	uint8_t *first = (uint8_t *)libos_arena_alloc(&arena, 3);
+	uint8_t *second = (uint8_t *)libos_arena_alloc(&arena, 1);
+	ASSERT_TRUE(first == (uint8_t *)data);
+	ASSERT_TRUE(second == first + 8);
+	ASSERT_EQUAL(9, libos_arena_used(&arena));
+}
+
+CTEST(arena_alloc, customAlignment)
+{
+	LIBOS_ARENA_STATIC_DATA_STRUCT(data, 128);
+	libos_arena_t arena;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_ARENA_CREATE_STATIC(data, arena));
+
+	ASSERT_NOT_NULL(libos_arena_alloc_aligned(&arena, 1, 1));
+	uint8_t *aligned = (uint8_t *)libos_arena_alloc_aligned(&arena, 4, 32);
+	ASSERT_NOT_NULL(aligned);
+	ASSERT_EQUAL(0, ((uintptr_t)aligned) % 32);
+
+	ASSERT_NULL(libos_arena_alloc_aligned(&arena, 4, 0));
+	ASSERT_NULL(libos_arena_alloc_aligned(&arena, 4, 12));
+}
+
+CTEST(arena_alloc, exhaust)
+{
+	LIBOS_ARENA_STATIC_DATA_STRUCT(data, 16);
+	libos_arena_t arena;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_ARENA_CREATE_STATIC(data, arena));
+
+	ASSERT_NOT_NULL(libos_arena_alloc(&arena, 12));
+	// Aligning the next allocation already takes the rest
+	ASSERT_NULL(libos_arena_alloc(&arena, 1));
+	ASSERT_NOT_NULL(libos_arena_alloc_aligned(&arena, 4, 1));
+	ASSERT_EQUAL(0, libos_arena_remaining(&arena));
+	ASSERT_NULL(libos_arena_alloc_aligned(&arena, 1, 1));
+	ASSERT_NULL(libos_arena_alloc(&arena, SIZE_MAX));
+}
+
+// ====================
+//
+// libos_arena_rewind
+//
+// ====================
+
+CTEST(arena_rewind, mark)
+{
+	LIBOS_ARENA_STATIC_DATA_STRUCT(data, 64);
+	libos_arena_t arena;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_ARENA_CREATE_STATIC(data, arena));
+
+	ASSERT_NOT_NULL(libos_arena_alloc(&arena, 8));
+	libos_arena_mark_t mark = libos_arena_mark(&arena);
+	uint8_t *scratch = (uint8_t *)libos_arena_alloc(&arena, 16);
+	ASSERT_NOT_NULL(libos_arena_alloc(&arena, 16));
+	ASSERT_EQUAL(40, libos_arena_used(&arena));
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_arena_rewind(&arena, mark));
+	ASSERT_EQUAL(8, libos_arena_used(&arena));
+	ASSERT_TRUE(scratch == libos_arena_alloc(&arena, 16));
+}
+
+CTEST(arena_rewind, pastCurrent)
+{
+	LIBOS_ARENA_STATIC_DATA_STRUCT(data, 64);
+	libos_arena_t arena;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_ARENA_CREATE_STATIC(data, arena));
+
+	ASSERT_NOT_NULL(libos_arena_alloc(&arena, 8));
+	libos_arena_mark_t mark = libos_arena_mark(&arena);
+	libos_arena_reset(&arena);
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_arena_rewind(&arena, mark));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_arena_rewind(NULL, 0));
+}
+
+// ====================
+//
+// libos_arena_reset
+//
+// ====================
+
+CTEST(arena_reset, freesAll)
+{
+	LIBOS_ARENA_STATIC_DATA_STRUCT(data, 64);
+	libos_arena_t arena;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_ARENA_CREATE_STATIC(data, arena));
+
+	uint8_t *first = (uint8_t *)libos_arena_alloc(&arena, 20);
+	ASSERT_NOT_NULL(libos_arena_alloc(&arena, 20));
+	libos_arena_reset(&arena);
+	ASSERT_EQUAL(0, libos_arena_used(&arena));
+	ASSERT_TRUE(first == libos_arena_alloc(&arena, 20));
+}
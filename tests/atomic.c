@@ -0,0 +1,128 @@
+#include <stdint.h>
+#include "ctest.h"
+
+#include "libos/concurrent/atomic.h"
+
+// ====================
+//
+// LIBOS_ATOMIC_LOAD/STORE
+//
+// ====================
+
+CTEST(atomic_LOAD_STORE, allWidths)
+{
+	libos_atomic_uint8_t value8;
+	libos_atomic_uint16_t value16;
+	libos_atomic_uint32_t value32;
+	libos_atomic_uint64_t value64;
+
+	LIBOS_ATOMIC_INIT(&value8, 0);
+	LIBOS_ATOMIC_INIT(&value16, 0);
+	LIBOS_ATOMIC_INIT(&value32, 0);
+	LIBOS_ATOMIC_INIT(&value64, 0);
+
+	LIBOS_ATOMIC_STORE(&value8, 0xAB, LIBOS_ATOMIC_RELEASE);
+	LIBOS_ATOMIC_STORE(&value16, 0xABCD, LIBOS_ATOMIC_RELEASE);
+	LIBOS_ATOMIC_STORE(&value32, 0xABCDEF01, LIBOS_ATOMIC_RELEASE);
+	LIBOS_ATOMIC_STORE(&value64, 0xABCDEF0123456789ULL, LIBOS_ATOMIC_SEQ_CST);
+
+	ASSERT_EQUAL(0xAB, LIBOS_ATOMIC_LOAD(&value8, LIBOS_ATOMIC_ACQUIRE));
+	ASSERT_EQUAL(0xABCD, LIBOS_ATOMIC_LOAD(&value16, LIBOS_ATOMIC_ACQUIRE));
+	ASSERT_EQUAL(0xABCDEF01, LIBOS_ATOMIC_LOAD(&value32, LIBOS_ATOMIC_ACQUIRE));
+	ASSERT_EQUAL_U(0xABCDEF0123456789ULL, LIBOS_ATOMIC_LOAD(&value64, LIBOS_ATOMIC_SEQ_CST));
+}
+
+CTEST(atomic_LOAD_STORE, pointer)
+{
+	int target = 5;
+	libos_atomic_ptr_t ptr;
+
+	LIBOS_ATOMIC_INIT(&ptr, NULL);
+	ASSERT_NULL(LIBOS_ATOMIC_LOAD(&ptr, LIBOS_ATOMIC_RELAXED));
+	LIBOS_ATOMIC_STORE(&ptr, &target, LIBOS_ATOMIC_RELEASE);
+	ASSERT_TRUE(LIBOS_ATOMIC_LOAD(&ptr, LIBOS_ATOMIC_ACQUIRE) == &target);
+}
+
+// ====================
+//
+// LIBOS_ATOMIC_EXCHANGE
+//
+// ====================
+
+CTEST(atomic_EXCHANGE, returnsPrevious)
+{
+	libos_atomic_uint32_t value;
+
+	LIBOS_ATOMIC_INIT(&value, 1);
+	ASSERT_EQUAL(1, LIBOS_ATOMIC_EXCHANGE(&value, 2, LIBOS_ATOMIC_ACQ_REL));
+	ASSERT_EQUAL(2, LIBOS_ATOMIC_LOAD(&value, LIBOS_ATOMIC_RELAXED));
+}
+
+// ====================
+//
+// LIBOS_ATOMIC_COMPARE_EXCHANGE
+//
+// ====================
+
+CTEST(atomic_COMPARE_EXCHANGE, matchingExpected)
+{
+	libos_atomic_uint16_t value;
+	uint16_t expected = 10;
+
+	LIBOS_ATOMIC_INIT(&value, 10);
+	ASSERT_TRUE(LIBOS_ATOMIC_COMPARE_EXCHANGE(&value, &expected, 20, LIBOS_ATOMIC_ACQ_REL, LIBOS_ATOMIC_ACQUIRE));
+	ASSERT_EQUAL(20, LIBOS_ATOMIC_LOAD(&value, LIBOS_ATOMIC_RELAXED));
+	ASSERT_EQUAL(10, expected);
+}
+
+CTEST(atomic_COMPARE_EXCHANGE, mismatchedExpected)
+{
+	libos_atomic_uint64_t value;
+	uint64_t expected = 11;
+
+	LIBOS_ATOMIC_INIT(&value, 10);
+	ASSERT_FALSE(LIBOS_ATOMIC_COMPARE_EXCHANGE(&value, &expected, 20, LIBOS_ATOMIC_ACQ_REL, LIBOS_ATOMIC_ACQUIRE));
+	ASSERT_EQUAL(10, LIBOS_ATOMIC_LOAD(&value, LIBOS_ATOMIC_RELAXED));
+	ASSERT_EQUAL(10, expected);
+}
+
+CTEST(atomic_COMPARE_EXCHANGE_WEAK, retryLoop)
+{
+	libos_atomic_uint32_t value;
+	uint32_t expected;
+
+	LIBOS_ATOMIC_INIT(&value, 7);
+	expected = LIBOS_ATOMIC_LOAD(&value, LIBOS_ATOMIC_RELAXED);
+	while (!LIBOS_ATOMIC_COMPARE_EXCHANGE_WEAK(&value, &expected, expected * 2, LIBOS_ATOMIC_RELAXED, LIBOS_ATOMIC_RELAXED))
+	{
+	}
+	ASSERT_EQUAL(14, LIBOS_ATOMIC_LOAD(&value, LIBOS_ATOMIC_RELAXED));
+}
+
+// ====================
+//
+// LIBOS_ATOMIC_FETCH_*
+//
+// ====================
+
+CTEST(atomic_FETCH_ADD_SUB, returnsPrevious)
+{
+	libos_atomic_uint8_t value;
+
+	LIBOS_ATOMIC_INIT(&value, 254);
+	ASSERT_EQUAL(254, LIBOS_ATOMIC_FETCH_ADD(&value, 1, LIBOS_ATOMIC_RELAXED));
+	ASSERT_EQUAL(255, LIBOS_ATOMIC_FETCH_ADD(&value, 1, LIBOS_ATOMIC_RELAXED));
+	// Wraps around like the unsigned type.
+	ASSERT_EQUAL(0, LIBOS_ATOMIC_FETCH_SUB(&value, 1, LIBOS_ATOMIC_RELAXED));
+	ASSERT_EQUAL(255, LIBOS_ATOMIC_LOAD(&value, LIBOS_ATOMIC_RELAXED));
+}
+
+CTEST(atomic_FETCH_OR_AND, bitManipulation)
+{
+	libos_atomic_uint32_t value;
+
+	LIBOS_ATOMIC_INIT(&value, 0x0F);
+	ASSERT_EQUAL(0x0F, LIBOS_ATOMIC_FETCH_OR(&value, 0xF0, LIBOS_ATOMIC_RELAXED));
+	ASSERT_EQUAL(0xFF, LIBOS_ATOMIC_FETCH_AND(&value, 0x3C, LIBOS_ATOMIC_RELAXED));
+	ASSERT_EQUAL(0x3C, LIBOS_ATOMIC_LOAD(&value, LIBOS_ATOMIC_RELAXED));
+}
@@ -0,0 +1,118 @@
+#include <stdint.h>
+#include "ctest.h"
+
+#include "libos/bitmap.h"
+
+// ====================
+//
+// libos_bitmap_set / libos_bitmap_clear / libos_bitmap_test
+//
+// ====================
+
+CTEST(bitmap_set, crossesWords)
+{
+	LIBOS_BITMAP_DEFINE(bitmap, 130) = {0};
+	libos_bitmap_set(bitmap, 0);
+	libos_bitmap_set(bitmap, 63);
+	libos_bitmap_set(bitmap, 129);
+	ASSERT_TRUE(libos_bitmap_test(bitmap, 0));
+	ASSERT_TRUE(libos_bitmap_test(bitmap, 63));
+	ASSERT_TRUE(libos_bitmap_test(bitmap, 129));
+	ASSERT_FALSE(libos_bitmap_test(bitmap, 64));
+	ASSERT_EQUAL(3, libos_bitmap_count(bitmap, 130));
+
+	libos_bitmap_clear(bitmap, 63);
+	ASSERT_FALSE(libos_bitmap_test(bitmap, 63));
+	ASSERT_EQUAL(2, libos_bitmap_count(bitmap, 130));
+}
+
+// ====================
+//
+// libos_bitmap_set_range / libos_bitmap_clear_range
+//
+// ====================
+
+CTEST(bitmap_set_range, matchesSingleBits)
+{
+	for (size_t first = 0; first < 100; first += 7)
+	{
+		for (size_t count = 0; first + count <= 150; count += 11)
+		{
+			LIBOS_BITMAP_DEFINE(bitmap, 150) = {0};
+			libos_bitmap_set_range(bitmap, first, count);
+			for (size_t bit = 0; bit < 150; bit++)
+			{
+				ASSERT_EQUAL(bit >= first && bit < first + count, libos_bitmap_test(bitmap, bit));
+			}
+			ASSERT_EQUAL(count, libos_bitmap_count(bitmap, 150));
+		}
+	}
+}
+
+CTEST(bitmap_clear_range, partOfFull)
+{
+	LIBOS_BITMAP_DEFINE(bitmap, 200) = {0};
+	libos_bitmap_set_range(bitmap, 0, 200);
+	libos_bitmap_clear_range(bitmap, 30, 100);
+	ASSERT_EQUAL(100, libos_bitmap_count(bitmap, 200));
+	ASSERT_TRUE(libos_bitmap_test(bitmap, 29));
+	ASSERT_FALSE(libos_bitmap_test(bitmap, 30));
+	ASSERT_FALSE(libos_bitmap_test(bitmap, 129));
+	ASSERT_TRUE(libos_bitmap_test(bitmap, 130));
+}
+
+// ====================
+//
+// libos_bitmap_find_*
+//
+// ====================
+
+CTEST(bitmap_find_first_set, empty)
+{
+	LIBOS_BITMAP_DEFINE(bitmap, 100) = {0};
+	ASSERT_EQUAL(100, libos_bitmap_find_first_set(bitmap, 100));
+	ASSERT_EQUAL(0, libos_bitmap_find_first_clear(bitmap, 100));
+}
+
+CTEST(bitmap_find_first_set, lastBit)
+{
+	LIBOS_BITMAP_DEFINE(bitmap, 100) = {0};
+	libos_bitmap_set(bitmap, 99);
+	ASSERT_EQUAL(99, libos_bitmap_find_first_set(bitmap, 100));
+}
+
+CTEST(bitmap_find_first_clear, ignoresBitsBeyondSize)
+{
+	LIBOS_BITMAP_DEFINE(bitmap, 70) = {0};
+	libos_bitmap_set_range(bitmap, 0, 70);
+	ASSERT_EQUAL(70, libos_bitmap_find_first_clear(bitmap, 70));
+	libos_bitmap_clear(bitmap, 66);
+	ASSERT_EQUAL(66, libos_bitmap_find_first_clear(bitmap, 70));
+}
+
+CTEST(bitmap_find_next_set, iterates)
+{
+	LIBOS_BITMAP_DEFINE(bitmap, 300) = {0};
+	const size_t kBits[] = {3, 64, 65, 127, 128, 299};
+	for (size_t i = 0; i < sizeof(kBits) / sizeof(kBits[0]); i++)
+	{
+		libos_bitmap_set(bitmap, kBits[i]);
+	}
+
+	size_t found = 0;
+	for (size_t bit = libos_bitmap_find_first_set(bitmap, 300); bit < 300; bit = libos_bitmap_find_next_set(bitmap, 300, bit + 1))
+	{
+		ASSERT_EQUAL(kBits[found], bit);
+		found++;
+	}
+	ASSERT_EQUAL(6, found);
+	ASSERT_EQUAL(300, libos_bitmap_find_next_set(bitmap, 300, 300));
+}
+
+CTEST(bitmap_find_next_clear, skipsSetRun)
+{
+	LIBOS_BITMAP_DEFINE(bitmap, 256) = {0};
+	libos_bitmap_set_range(bitmap, 10, 150);
+	ASSERT_EQUAL(160, libos_bitmap_find_next_clear(bitmap, 256, 10));
+	ASSERT_EQUAL(5, libos_bitmap_find_next_clear(bitmap, 256, 5));
+}
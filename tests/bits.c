@@ -606,3 +606,280 @@ CTEST(bits_REVERSE_BYTES_32, simpleData)
   ASSERT_EQUAL(0xBB, data[4]);
   ASSERT_EQUAL(0x22, data[5]);
 }
+
+// ====================
+//
+// LIBOS_BSWAP16 / LIBOS_BSWAP32
+//
+// ====================
+
+CTEST(bits_LIBOS_BSWAP, values)
+{
+	static const uint32_t kStatic = LIBOS_BSWAP32(0x11223344);
+	ASSERT_EQUAL(0x3412, LIBOS_BSWAP16(0x1234));
+	ASSERT_EQUAL(0x44332211, kStatic);
+	ASSERT_EQUAL(0x000000FF, LIBOS_BSWAP32(0xFF000000));
+}
+
+// ====================
+//
+// libos_bswap16_array
+//
+// ====================
+
+CTEST(bits_libos_bswap16_array, inPlaceOddCount)
+{
+	uint8_t data[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A};
+	const uint8_t kExpected[] = {0x02, 0x01, 0x04, 0x03, 0x06, 0x05, 0x08, 0x07, 0x0A, 0x09};
+	libos_bswap16_array(data, data, 5);
+	ASSERT_DATA(kExpected, sizeof(kExpected), data, sizeof(data));
+}
+
+CTEST(bits_libos_bswap16_array, zeroCount)
+{
+	uint8_t data[] = {0x01, 0x02};
+	libos_bswap16_array(data, data, 0);
+	ASSERT_EQUAL(0x01, data[0]);
+}
+
+// ====================
+//
+// libos_bswap32_array
+//
+// ====================
+
+CTEST(bits_libos_bswap32_array, unaligned)
+{
+	uint8_t src[] = {0xFF, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+	uint8_t dst[9] = {0};
+	const uint8_t kExpected[] = {0x00, 0x04, 0x03, 0x02, 0x01, 0x08, 0x07, 0x06, 0x05};
+	libos_bswap32_array(&dst[1], &src[1], 2);
+	ASSERT_DATA(kExpected, sizeof(kExpected), dst, sizeof(dst));
+}
+
+// ====================
+//
+// libos_load_be16_array / libos_load_be32_array
+//
+// ====================
+
+CTEST(bits_libos_load_be16_array, values)
+{
+	const uint8_t kData[] = {0x12, 0x34, 0xAB, 0xCD, 0x00, 0x01};
+	uint16_t values[3];
+	libos_load_be16_array(values, kData, 3);
+	ASSERT_EQUAL(0x1234, values[0]);
+	ASSERT_EQUAL(0xABCD, values[1]);
+	ASSERT_EQUAL(0x0001, values[2]);
+}
+
+CTEST(bits_libos_load_be32_array, matchesGet32InArray)
+{
+	uint8_t data[64];
+	uint32_t values[16];
+	for (size_t i = 0; i < sizeof(data); i++)
+	{
+		data[i] = (uint8_t)(i * 7 + 3);
+	}
+	libos_load_be32_array(values, data, 16);
+	for (size_t i = 0; i < 16; i++)
+	{
+		ASSERT_EQUAL(GET_32_IN_ARRAY(data, i * 4), values[i]);
+	}
+}
+
+// ====================
+//
+// libos_store_be16_array / libos_store_be32_array
+//
+// ====================
+
+CTEST(bits_libos_store_be16_array, values)
+{
+	const uint16_t kValues[] = {0x1234, 0xABCD};
+	const uint8_t kExpected[] = {0x12, 0x34, 0xAB, 0xCD};
+	uint8_t data[4];
+	libos_store_be16_array(data, kValues, 2);
+	ASSERT_DATA(kExpected, sizeof(kExpected), data, sizeof(data));
+}
+
+CTEST(bits_libos_store_be32_array, roundTrip)
+{
+	const uint32_t kValues[] = {0x01020304, 0xDEADBEEF, 0x00000000, 0xFFFFFFFF, 0x80000001};
+	uint8_t data[sizeof(kValues)];
+	uint32_t values[5];
+	libos_store_be32_array(data, kValues, 5);
+	ASSERT_EQUAL(0xDEADBEEF, GET_32_IN_ARRAY(data, 4));
+	libos_load_be32_array(values, data, 5);
+	ASSERT_DATA((const uint8_t*)kValues, sizeof(kValues), (const uint8_t*)values, sizeof(values));
+}
+
+// ====================
+//
+// COMBINE_BYTES_64
+//
+// ====================
+
+CTEST(bits_COMBINE_BYTES_64, simpleData)
+{
+	static const uint64_t kStatic = COMBINE_BYTES_64(0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF);
+	ASSERT_TRUE(kStatic == UINT64_C(0x0123456789ABCDEF));
+}
+
+// ====================
+//
+// SET_64_IN_ARRAY / GET_64_IN_ARRAY
+//
+// ====================
+
+CTEST(bits_64_IN_ARRAY, bigEndian)
+{
+	uint8_t data[10] = {0};
+	const uint8_t kExpected[10] = {0x00, 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0x00};
+	SET_64_IN_ARRAY(data, UINT64_C(0x0123456789ABCDEF), 1);
+	ASSERT_DATA(kExpected, sizeof(kExpected), data, sizeof(data));
+	ASSERT_TRUE(GET_64_IN_ARRAY(data, 1) == UINT64_C(0x0123456789ABCDEF));
+}
+
+// ====================
+//
+// SET_*_IN_ARRAY_LE / GET_*_IN_ARRAY_LE
+//
+// ====================
+
+CTEST(bits_IN_ARRAY_LE, bits16)
+{
+	uint8_t data[3] = {0};
+	SET_16_IN_ARRAY_LE(data, 0x1234, 1);
+	ASSERT_EQUAL(0x00, data[0]);
+	ASSERT_EQUAL(0x34, data[1]);
+	ASSERT_EQUAL(0x12, data[2]);
+	ASSERT_EQUAL(0x1234, GET_16_IN_ARRAY_LE(data, 1));
+}
+
+CTEST(bits_IN_ARRAY_LE, bits32)
+{
+	uint8_t data[4] = {0};
+	const uint8_t kExpected[4] = {0xEF, 0xBE, 0xAD, 0xDE};
+	SET_32_IN_ARRAY_LE(data, 0xDEADBEEF, 0);
+	ASSERT_DATA(kExpected, sizeof(kExpected), data, sizeof(data));
+	ASSERT_EQUAL(0xDEADBEEF, GET_32_IN_ARRAY_LE(data, 0));
+}
+
+CTEST(bits_IN_ARRAY_LE, bits64)
+{
+	uint8_t data[8] = {0};
+	const uint8_t kExpected[8] = {0xEF, 0xCD, 0xAB, 0x89, 0x67, 0x45, 0x23, 0x01};
+	SET_64_IN_ARRAY_LE(data, UINT64_C(0x0123456789ABCDEF), 0);
+	ASSERT_DATA(kExpected, sizeof(kExpected), data, sizeof(data));
+	ASSERT_TRUE(GET_64_IN_ARRAY_LE(data, 0) == UINT64_C(0x0123456789ABCDEF));
+	ASSERT_TRUE(GET_64_IN_ARRAY(data, 0) == LIBOS_BSWAP64(UINT64_C(0x0123456789ABCDEF)));
+}
+
+// ====================
+//
+// LIBOS_CLZ / LIBOS_CTZ / LIBOS_POPCOUNT
+//
+// ====================
+
+CTEST(bits_LIBOS_CLZ, constMatchesBuiltin)
+{
+	static const int kStatic[] = {LIBOS_CLZ32_CONST(1), LIBOS_CTZ32_CONST(0x80000000), LIBOS_POPCOUNT32_CONST(0xFFFFFFFF), LIBOS_CLZ64_CONST(0)};
+	ASSERT_EQUAL(31, kStatic[0]);
+	ASSERT_EQUAL(31, kStatic[1]);
+	ASSERT_EQUAL(32, kStatic[2]);
+	ASSERT_EQUAL(64, kStatic[3]);
+
+	uint64_t value = UINT64_C(0x9E3779B97F4A7C15);
+	for (int i = 0; i < 200; i++)
+	{
+		value ^= value << 13;
+		value ^= value >> 7;
+		value ^= value << 17;
+		uint64_t sample = value >> (i % 64);
+		uint32_t sample32 = (uint32_t)sample;
+		ASSERT_EQUAL(LIBOS_POPCOUNT64_CONST(sample), LIBOS_POPCOUNT64(sample));
+		ASSERT_EQUAL(LIBOS_POPCOUNT32_CONST(sample32), LIBOS_POPCOUNT32(sample32));
+		if (sample != 0)
+		{
+			ASSERT_EQUAL(LIBOS_CLZ64_CONST(sample), LIBOS_CLZ64(sample));
+			ASSERT_EQUAL(LIBOS_CTZ64_CONST(sample), LIBOS_CTZ64(sample));
+		}
+		if (sample32 != 0)
+		{
+			ASSERT_EQUAL(LIBOS_CLZ32_CONST(sample32), LIBOS_CLZ32(sample32));
+			ASSERT_EQUAL(LIBOS_CTZ32_CONST(sample32), LIBOS_CTZ32(sample32));
+		}
+	}
+}
+
+CTEST(bits_LIBOS_CLZ, edges)
+{
+	ASSERT_EQUAL(0, LIBOS_CLZ32(0x80000000));
+	ASSERT_EQUAL(31, LIBOS_CLZ32(1));
+	ASSERT_EQUAL(32, LIBOS_CLZ32_CONST(0));
+	ASSERT_EQUAL(32, LIBOS_CTZ32_CONST(0));
+	ASSERT_EQUAL(0, LIBOS_POPCOUNT32(0));
+	ASSERT_EQUAL(63, LIBOS_CTZ64(UINT64_C(0x8000000000000000)));
+	ASSERT_EQUAL(32, LIBOS_CLZ64(UINT64_C(0x80000000)));
+}
+
+// ====================
+//
+// LIBOS_BIT / HAS_FLAG above 31 bits
+//
+// ====================
+
+CTEST(bits_LIBOS_BIT, highFlags)
+{
+	uint64_t value = 0;
+	SET_FLAG(value, 40);
+	ASSERT_TRUE(value == UINT64_C(0x10000000000));
+	ASSERT_TRUE(HAS_FLAG(value, 40));
+	ASSERT_TRUE(ONLY_FLAG(value, 40));
+	ASSERT_FALSE(HAS_FLAG(value, 8));
+	CLEAR_FLAG(value, 40);
+	ASSERT_TRUE(value == 0);
+}
+
+// ====================
+//
+// LIBOS_GENMASK32 / LIBOS_GENMASK64
+//
+// ====================
+
+CTEST(bits_LIBOS_GENMASK, values)
+{
+	static const uint32_t kStatic = LIBOS_GENMASK32(7, 4);
+	ASSERT_EQUAL(0xF0, kStatic);
+	ASSERT_EQUAL(0xFFFFFFFF, LIBOS_GENMASK32(31, 0));
+	ASSERT_EQUAL(0x80000000, LIBOS_GENMASK32(31, 31));
+	ASSERT_TRUE(LIBOS_GENMASK64(63, 0) == UINT64_MAX);
+	ASSERT_TRUE(LIBOS_GENMASK64(47, 40) == UINT64_C(0xFF0000000000));
+	ASSERT_EQUAL(0x7, LIBOS_BITMASK32(3));
+}
+
+// ====================
+//
+// LIBOS_BITFIELD_GET / LIBOS_BITFIELD_SET
+//
+// ====================
+
+CTEST(bits_LIBOS_BITFIELD, get)
+{
+	const uint32_t kHeader = 0xABCD1234;
+	ASSERT_EQUAL(0x4, LIBOS_BITFIELD_GET(kHeader, 0, 4));
+	ASSERT_EQUAL(0xCD, LIBOS_BITFIELD_GET(kHeader, 16, 8));
+	ASSERT_EQUAL(0xABCD1234, LIBOS_BITFIELD_GET(kHeader, 0, 32));
+	ASSERT_TRUE(LIBOS_BITFIELD_GET(UINT64_C(0xF123456789ABCDEF), 60, 4) == 0xF);
+}
+
+CTEST(bits_LIBOS_BITFIELD, set)
+{
+	static const uint32_t kStatic = (uint32_t)LIBOS_BITFIELD_SET(0, 4, 4, 0xA);
+	ASSERT_EQUAL(0xA0, kStatic);
+	ASSERT_EQUAL(0xABC56234, (uint32_t)LIBOS_BITFIELD_SET(0xABCD1234, 12, 8, 0x56));
+	// Bits that don't fit in the field are ignored.
+	ASSERT_EQUAL(0x00000F0F, (uint32_t)LIBOS_BITFIELD_SET(0x00000F0F, 4, 4, 0x10));
+	ASSERT_TRUE(LIBOS_BITFIELD_SET(0, 63, 1, 1) == UINT64_C(0x8000000000000000));
+}
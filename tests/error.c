@@ -0,0 +1,236 @@
+#include <stddef.h>
+#include <stdbool.h>
+#include "ctest.h"
+
+// Record the error returns of the macros in this file.
+#undef LIBOS_ERR_ENABLE_FAILURE_HOOK
+#define LIBOS_ERR_ENABLE_FAILURE_HOOK 1
+#undef LIBOS_ERR_ENABLE_TRACE
+#define LIBOS_ERR_ENABLE_TRACE 1
+
+#include "libos/error.h"
+
+LIBOS_ERR_TRACE_DEFINE();
+
+static int error_test_failures;
+static int error_test_line;
+static libos_err_t error_test_err;
+
+void libos_err_on_failure(const char *file, int line, libos_err_t err)
+{
+	(void)file;
+	error_test_failures++;
+	error_test_line = line;
+	error_test_err = err;
+}
+
+static void error_test_reset(void)
+{
+	error_test_failures = 0;
+	error_test_line = 0;
+	error_test_err = LIBOS_ERR_OK;
+}
+
+static libos_err_t error_test_return(libos_err_t err)
+{
+	return err;
+}
+
+static int error_test_check_line;
+
+static libos_err_t error_test_check(libos_err_t err)
+{
+	error_test_check_line = __LINE__ + 1;
+	LIBOS_ERR_CHECK(error_test_return(err));
+	return LIBOS_ERR_OK;
+}
+
+static int error_test_check_void_line;
+static bool error_test_check_void_passed;
+
+static void error_test_check_void(libos_err_t err)
+{
+	error_test_check_void_passed = false;
+	error_test_check_void_line = __LINE__ + 1;
+	LIBOS_ERR_CHECK_VOID(error_test_return(err));
+	error_test_check_void_passed = true;
+}
+
+static libos_err_t error_test_not_null(const void *arg)
+{
+	LIBOS_ERR_RET_ARG_NOT_NULL(arg);
+	return LIBOS_ERR_OK;
+}
+
+static int error_test_layer_lines[2];
+
+static libos_err_t error_test_layer_inner(void)
+{
+	error_test_layer_lines[0] = __LINE__ + 1;
+	LIBOS_ERR_RET_ON_TRUE(true, LIBOS_ERR_IO);
+	return LIBOS_ERR_OK;
+}
+
+static libos_err_t error_test_layer_outer(void)
+{
+	error_test_layer_lines[1] = __LINE__ + 1;
+	LIBOS_ERR_CHECK(error_test_layer_inner());
+	return LIBOS_ERR_OK;
+}
+
+static int error_test_value(int value)
+{
+	LIBOS_RET_VAL_ON_TRUE(value < 0, -1);
+	return value;
+}
+
+// ====================
+//
+// LIBOS_LIKELY / LIBOS_UNLIKELY
+//
+// ====================
+
+CTEST(error_likely, valueIsBoolean)
+{
+	ASSERT_EQUAL(1, LIBOS_LIKELY(42));
+	ASSERT_EQUAL(0, LIBOS_LIKELY(0));
+	ASSERT_EQUAL(1, LIBOS_UNLIKELY(-3));
+	ASSERT_EQUAL(0, LIBOS_UNLIKELY(NULL != NULL));
+}
+
+// ====================
+//
+// LIBOS_ERR_CHECK
+//
+// ====================
+
+CTEST(error_check, okPassesWithoutHook)
+{
+	error_test_reset();
+	ASSERT_EQUAL(LIBOS_ERR_OK, error_test_check(LIBOS_ERR_OK));
+	ASSERT_EQUAL(0, error_test_failures);
+}
+
+CTEST(error_check, errorReturnsAndCallsHook)
+{
+	error_test_reset();
+	ASSERT_EQUAL(LIBOS_ERR_TIMEOUT, error_test_check(LIBOS_ERR_TIMEOUT));
+	ASSERT_EQUAL(1, error_test_failures);
+	ASSERT_EQUAL(LIBOS_ERR_TIMEOUT, error_test_err);
+	ASSERT_EQUAL(error_test_check_line, error_test_line);
+}
+
+// ====================
+//
+// LIBOS_ERR_CHECK_VOID
+//
+// ====================
+
+CTEST(error_check_void, okPassesWithoutHook)
+{
+	error_test_reset();
+	error_test_check_void(LIBOS_ERR_OK);
+	ASSERT_TRUE(error_test_check_void_passed);
+	ASSERT_EQUAL(0, error_test_failures);
+}
+
+CTEST(error_check_void, errorReturnsAndCallsHook)
+{
+	libos_err_trace_entry_t entries[4];
+	error_test_reset();
+	libos_err_trace_clear();
+	error_test_check_void(LIBOS_ERR_TIMEOUT);
+	ASSERT_FALSE(error_test_check_void_passed);
+	ASSERT_EQUAL(1, error_test_failures);
+	ASSERT_EQUAL(LIBOS_ERR_TIMEOUT, error_test_err);
+	ASSERT_EQUAL(error_test_check_void_line, error_test_line);
+	ASSERT_EQUAL(1, libos_err_trace_get(entries, 4));
+	ASSERT_EQUAL(error_test_check_void_line, entries[0].line);
+}
+
+// ====================
+//
+// LIBOS_ERR_RET_ARG_NOT_NULL
+//
+// ====================
+
+CTEST(error_ret_arg_not_null, null)
+{
+	error_test_reset();
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, error_test_not_null(NULL));
+	ASSERT_EQUAL(1, error_test_failures);
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, error_test_err);
+}
+
+CTEST(error_ret_arg_not_null, notNull)
+{
+	error_test_reset();
+	ASSERT_EQUAL(LIBOS_ERR_OK, error_test_not_null(&error_test_failures));
+	ASSERT_EQUAL(0, error_test_failures);
+}
+
+// ====================
+//
+// LIBOS_RET_VAL_ON_TRUE
+//
+// ====================
+
+CTEST(error_ret_val_on_true, userValueWithoutHook)
+{
+	error_test_reset();
+	ASSERT_EQUAL(-1, error_test_value(-5));
+	ASSERT_EQUAL(5, error_test_value(5));
+	ASSERT_EQUAL(0, error_test_failures);
+}
+
+// ====================
+//
+// libos_err_trace_get
+//
+// ====================
+
+CTEST(error_trace_get, empty)
+{
+	libos_err_trace_entry_t entries[4];
+	libos_err_trace_clear();
+	ASSERT_EQUAL(0, libos_err_trace_get(entries, 4));
+}
+
+CTEST(error_trace_get, pathOfError)
+{
+	libos_err_trace_entry_t entries[4];
+	libos_err_trace_clear();
+	ASSERT_EQUAL(LIBOS_ERR_IO, error_test_layer_outer());
+	ASSERT_EQUAL(2, libos_err_trace_get(entries, 4));
+	ASSERT_EQUAL(error_test_layer_lines[0], entries[0].line);
+	ASSERT_EQUAL(error_test_layer_lines[1], entries[1].line);
+	ASSERT_EQUAL(LIBOS_ERR_IO, entries[0].err);
+	ASSERT_EQUAL(LIBOS_ERR_IO, entries[1].err);
+	ASSERT_STR(__FILE__, entries[0].file);
+}
+
+CTEST(error_trace_get, keepsNewest)
+{
+	libos_err_trace_entry_t entries[LIBOS_ERR_TRACE_DEPTH];
+	libos_err_trace_clear();
+	for (int i = 0; i < LIBOS_ERR_TRACE_DEPTH + 3; i++)
+	{
+		error_test_not_null(NULL);
+	}
+	ASSERT_EQUAL(LIBOS_ERR_IO, error_test_layer_outer());
+	ASSERT_EQUAL(LIBOS_ERR_TRACE_DEPTH, libos_err_trace_get(entries, LIBOS_ERR_TRACE_DEPTH));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, entries[0].err);
+	ASSERT_EQUAL(error_test_layer_lines[1], entries[LIBOS_ERR_TRACE_DEPTH - 1].line);
+
+	// A smaller buffer gets the newest entries.
+	ASSERT_EQUAL(1, libos_err_trace_get(entries, 1));
+	ASSERT_EQUAL(error_test_layer_lines[1], entries[0].line);
+}
+
+CTEST(error_trace_get, successNotRecorded)
+{
+	libos_err_trace_entry_t entries[4];
+	libos_err_trace_clear();
+	ASSERT_EQUAL(LIBOS_ERR_OK, error_test_check(LIBOS_ERR_OK));
+	ASSERT_EQUAL(0, libos_err_trace_get(entries, 4));
+}
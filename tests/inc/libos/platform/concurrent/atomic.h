@@ -0,0 +1,3 @@
+#pragma once
+
+// No need to, this header exists to please the optional platform integration.
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+// Minimal error codes, this header exists to please the platform integration of error.h.
+typedef int libos_err_t;
+
+#define LIBOS_ERR_OK            0
+#define LIBOS_ERR_FAIL          -1
+#define LIBOS_ERR_NO_MEM        -2
+#define LIBOS_ERR_INVALID_ARG   -3
+#define LIBOS_ERR_NOTSUP        -4
+#define LIBOS_ERR_BUSY          -5
+#define LIBOS_ERR_TIMEOUT       -6
+#define LIBOS_ERR_INVALID_STATE -7
+#define LIBOS_ERR_INVALID_DATA  -8
+#define LIBOS_ERR_IO            -9
@@ -0,0 +1,15 @@
+#pragma once
+
+// Test platform for log.h, the statements are counted instead of printed.
+#define LIBOS_LOG_LEVEL_ERR 1
+#define LIBOS_LOG_LEVEL_WRN 2
+#define LIBOS_LOG_LEVEL_INF 3
+#define LIBOS_LOG_LEVEL_DBG 4
+
+extern int test_log_print_count;
+extern int test_log_print_level;
+void test_log_print(const char *format, ...);
+
+#define LIBOS_LOG_PRINT(level, ...) do { test_log_print_count++; test_log_print_level = (level); test_log_print(__VA_ARGS__); } while (0)
+#define LIBOS_LOG_MODULE_MIN_LEVEL(log_name, log_level) typedef int test_log_module_##log_name##_t
+#define LIBOS_LOG_INIT()
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+// Minimal time types, this header exists to please the platform integration of time.h.
+typedef int64_t libos_time_t;
+typedef int64_t libos_time_seconds_t;
+typedef int64_t libos_time_milliseconds_t;
+typedef int64_t libos_time_microseconds_t;
+typedef int64_t libos_time_nanoseconds_t;
+
+// Use the generic implementations of libos/time.h.
+#define LIBOS_TIME_NS_INT64 1
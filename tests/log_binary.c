@@ -0,0 +1,132 @@
+#include <stdint.h>
+#include <string.h>
+#include "ctest.h"
+
+#include "libos/log_binary.h"
+
+static uint8_t log_binary_test_frame[LIBOS_LOG_BINARY_MAX_FRAME];
+static size_t log_binary_test_length;
+
+// The test platform keeps the last frame.
+void libos_log_binary_write(const uint8_t *frame, size_t length)
+{
+	memcpy(log_binary_test_frame, frame, length);
+	log_binary_test_length = length;
+}
+
+static size_t log_binary_test_get_varint(const uint8_t *buffer, size_t offset, uint64_t *value)
+{
+	unsigned shift = 0;
+	*value = 0;
+	while (true)
+	{
+		uint8_t byte = buffer[offset++];
+		*value |= (uint64_t)(byte & 0x7F) << shift;
+		shift += 7;
+		if ((byte & 0x80) == 0)
+		{
+			return offset;
+		}
+	}
+}
+
+// ====================
+//
+// libos_log_binary_encode
+//
+// ====================
+
+CTEST(log_binary_encode, header)
+{
+	uint8_t buffer[16];
+	ASSERT_EQUAL(5, libos_log_binary_encode(buffer, sizeof(buffer), 3, 200, 5, NULL, 0));
+	// length, level, timestamp (2 bytes), ID
+	const uint8_t expected[] = {4, 3, 0xC8, 0x01, 5};
+	ASSERT_DATA(expected, sizeof(expected), buffer, 5);
+}
+
+CTEST(log_binary_encode, arguments)
+{
+	uint8_t buffer[64];
+	const libos_log_arg_t args[] = {
+		libos_log_arg_int_(-2),
+		libos_log_arg_uint_(300),
+		libos_log_arg_string_("hi"),
+		libos_log_arg_double_(1.0),
+	};
+	size_t length = libos_log_binary_encode(buffer, sizeof(buffer), 0, 0, 1, args, 4);
+	const uint8_t expected[] = {
+		21, 0, 0, 1,
+		0x40 | LIBOS_LOG_ARG_SIGNED, 3,
+		0x40 | LIBOS_LOG_ARG_UNSIGNED, 0xAC, 0x02,
+		0x80 | LIBOS_LOG_ARG_STRING, 2, 'h', 'i',
+		0x80 | LIBOS_LOG_ARG_DOUBLE, 0, 0, 0, 0, 0, 0, 0xF0, 0x3F,
+	};
+	ASSERT_DATA(expected, sizeof(expected), buffer, length);
+}
+
+CTEST(log_binary_encode, truncatesArguments)
+{
+	uint8_t buffer[8];
+	const libos_log_arg_t args[] = {
+		libos_log_arg_int_(1),
+		libos_log_arg_string_("too long for the frame"),
+	};
+	// The string doesn't fit anymore and is left out
+	ASSERT_EQUAL(6, libos_log_binary_encode(buffer, sizeof(buffer), 0, 0, 1, args, 2));
+	ASSERT_EQUAL(5, buffer[0]);
+	ASSERT_EQUAL(0, libos_log_binary_encode(buffer, 2, 0, 0, 1, args, 2));
+}
+
+CTEST(log_binary_encode, longFrame)
+{
+	uint8_t buffer[200];
+	libos_log_arg_t args[8];
+	for (size_t i = 0; i < 8; i++)
+	{
+		args[i] = libos_log_arg_string_("0123456789abcdef");
+	}
+	size_t length = libos_log_binary_encode(buffer, sizeof(buffer), 0, 0, 1, args, 8);
+	uint64_t payload;
+	size_t offset = log_binary_test_get_varint(buffer, 0, &payload);
+	ASSERT_EQUAL(2, offset);
+	ASSERT_EQUAL(3 + 8 * 18, payload);
+	ASSERT_EQUAL(length, offset + payload);
+}
+
+// ====================
+//
+// LIBOS_LOG_BINARY
+//
+// ====================
+
+CTEST(log_binary, formatInSection)
+{
+	LIBOS_LOG_BINARY(1, "%d apples", 7);
+
+	uint64_t payload;
+	uint64_t timestamp;
+	uint64_t id;
+	size_t offset = log_binary_test_get_varint(log_binary_test_frame, 0, &payload);
+	ASSERT_EQUAL(log_binary_test_length, offset + payload);
+	ASSERT_EQUAL(1, log_binary_test_frame[offset++]);
+	offset = log_binary_test_get_varint(log_binary_test_frame, offset, &timestamp);
+	offset = log_binary_test_get_varint(log_binary_test_frame, offset, &id);
+	ASSERT_STR("%d apples", &__start_libos_log_fmt[id]);
+	ASSERT_EQUAL(LIBOS_LOG_ARG_SIGNED, log_binary_test_frame[offset] & 0x0F);
+	ASSERT_EQUAL(14, log_binary_test_frame[offset + 1]);
+}
+
+CTEST(log_binary, noArguments)
+{
+	LIBOS_LOG_BINARY(2, "plain");
+
+	uint64_t payload;
+	uint64_t value;
+	size_t offset = log_binary_test_get_varint(log_binary_test_frame, 0, &payload);
+	offset++;
+	offset = log_binary_test_get_varint(log_binary_test_frame, offset, &value);
+	offset = log_binary_test_get_varint(log_binary_test_frame, offset, &value);
+	ASSERT_STR("plain", &__start_libos_log_fmt[value]);
+	ASSERT_EQUAL(log_binary_test_length, offset);
+}
@@ -0,0 +1,142 @@
+#include <stdint.h>
+#include <string.h>
+#include "ctest.h"
+
+// Buffer the statements of this file, with a small buffer and flush interval.
+#undef LIBOS_LOG_ENABLE_DEFERRED
+#define LIBOS_LOG_ENABLE_DEFERRED 0
+#undef LIBOS_LOG_ENABLE_BINARY
+#define LIBOS_LOG_ENABLE_BINARY 0
+#undef LIBOS_LOG_ENABLE_RUNTIME_LEVEL
+#define LIBOS_LOG_ENABLE_RUNTIME_LEVEL 0
+#undef LIBOS_LOG_ENABLE_BUFFERED
+#define LIBOS_LOG_ENABLE_BUFFERED 1
+#define LIBOS_LOG_LEVEL_MIN LIBOS_LOG_LEVEL_DBG
+#define LIBOS_LOG_BUFFERED_SIZE 64
+#define LIBOS_LOG_BUFFERED_FLUSH_MS 20
+
+#include "libos/log.h"
+
+LIBOS_LOG_MODULE(buf);
+LIBOS_LOG_BUFFERED_DEFINE();
+
+static char log_buffered_test_output[256];
+static size_t log_buffered_test_length;
+static int log_buffered_test_writes;
+
+// The test platform appends the writes to one output, dropping what doesn't fit.
+void libos_log_buffered_write(const char *data, size_t length)
+{
+	if (log_buffered_test_length + length >= sizeof(log_buffered_test_output))
+	{
+		return;
+	}
+	memcpy(&log_buffered_test_output[log_buffered_test_length], data, length);
+	log_buffered_test_length += length;
+	log_buffered_test_output[log_buffered_test_length] = '\0';
+	log_buffered_test_writes++;
+}
+
+// The length of the first line, the timestamp is at least 12 digits wide.
+static size_t log_buffered_test_line_length(void)
+{
+	const char *end = strchr(log_buffered_test_output, '\n');
+	return (end != NULL) ? (size_t)(end - log_buffered_test_output) + 1 : 0;
+}
+
+static void log_buffered_test_reset(void)
+{
+	libos_log_buffered_flush();
+	log_buffered_test_length = 0;
+	log_buffered_test_output[0] = '\0';
+	log_buffered_test_writes = 0;
+}
+
+// ====================
+//
+// LIBOS_LOG_* (buffered)
+//
+// ====================
+
+CTEST(log_buffered, linesAreBatched)
+{
+	log_buffered_test_reset();
+	LIBOS_LOG_INF("a");
+	LIBOS_LOG_DBG("b");
+	ASSERT_EQUAL(0, log_buffered_test_writes);
+
+	libos_log_buffered_flush();
+	ASSERT_EQUAL(1, log_buffered_test_writes);
+	// "<timestamp> I buf: a\n" and "<timestamp> D buf: b\n".
+	size_t line = log_buffered_test_line_length();
+	ASSERT_TRUE(line >= 12 + 9);
+	ASSERT_EQUAL(2 * line, log_buffered_test_length);
+	ASSERT_DATA((const unsigned char *)" I buf: a\n", 10, (const unsigned char *)&log_buffered_test_output[line - 10], 10);
+	ASSERT_DATA((const unsigned char *)" D buf: b\n", 10, (const unsigned char *)&log_buffered_test_output[2 * line - 10], 10);
+}
+
+CTEST(log_buffered, timestampsAreOrdered)
+{
+	log_buffered_test_reset();
+	LIBOS_LOG_INF("1");
+	LIBOS_LOG_INF("2");
+	libos_log_buffered_flush();
+
+	// The zero padded timestamps sort like the numbers.
+	size_t line = log_buffered_test_line_length();
+	ASSERT_EQUAL(2 * line, log_buffered_test_length);
+	ASSERT_TRUE(memcmp(&log_buffered_test_output[0], &log_buffered_test_output[line], line - 10) <= 0);
+}
+
+CTEST(log_buffered, errorFlushesImmediately)
+{
+	log_buffered_test_reset();
+	LIBOS_LOG_INF("a");
+	LIBOS_LOG_ERR("e");
+	ASSERT_EQUAL(1, log_buffered_test_writes);
+	size_t line = log_buffered_test_line_length();
+	ASSERT_EQUAL(2 * line, log_buffered_test_length);
+	ASSERT_DATA((const unsigned char *)" E buf: e\n", 10, (const unsigned char *)&log_buffered_test_output[2 * line - 10], 10);
+}
+
+CTEST(log_buffered, fullBufferIsFlushedFirst)
+{
+	log_buffered_test_reset();
+	// Only whole lines are written, the one that didn't fit stays buffered.
+	int lines = 0;
+	while (log_buffered_test_writes == 0)
+	{
+		LIBOS_LOG_INF("%d", lines % 10);
+		lines++;
+	}
+	size_t line = log_buffered_test_line_length();
+	ASSERT_TRUE(lines >= 2);
+	ASSERT_EQUAL((size_t)(lines - 1) * line, log_buffered_test_length);
+	ASSERT_TRUE((size_t)lines * line > LIBOS_LOG_BUFFERED_SIZE);
+
+	libos_log_buffered_flush();
+	ASSERT_EQUAL(2, log_buffered_test_writes);
+	ASSERT_EQUAL((size_t)lines * line, log_buffered_test_length);
+}
+
+CTEST(log_buffered, longLineIsTruncated)
+{
+	log_buffered_test_reset();
+	LIBOS_LOG_INF("%s", "0123456789012345678901234567890123456789012345678901234567890123456789");
+	ASSERT_EQUAL(1, log_buffered_test_writes);
+	ASSERT_EQUAL(LIBOS_LOG_BUFFERED_SIZE, log_buffered_test_length);
+	ASSERT_EQUAL('\n', log_buffered_test_output[LIBOS_LOG_BUFFERED_SIZE - 1]);
+}
+
+CTEST(log_buffered, oldLinesAreFlushed)
+{
+	log_buffered_test_reset();
+	LIBOS_LOG_INF("a");
+	libos_time_t start = libos_time_get_now();
+	while (libos_time_difference_ms(start, libos_time_get_now()) < LIBOS_LOG_BUFFERED_FLUSH_MS) { }
+	ASSERT_EQUAL(0, log_buffered_test_writes);
+
+	LIBOS_LOG_INF("b");
+	ASSERT_EQUAL(1, log_buffered_test_writes);
+	ASSERT_EQUAL(2 * log_buffered_test_line_length(), log_buffered_test_length);
+}
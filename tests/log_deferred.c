@@ -0,0 +1,184 @@
+#include <stdint.h>
+#include <string.h>
+#include "ctest.h"
+
+#include "libos/log_deferred.h"
+
+static LIBOS_LOG_RING_STATIC_DATA_STRUCT(log_test_ring_data, 4);
+static libos_log_ring_t log_test_ring;
+
+// The test platform pushes every statement into the test ring.
+void libos_log_deferred_push(int level, const char *tag, const libos_log_arg_t *args, size_t count)
+{
+	libos_log_ring_push(&log_test_ring, level, tag, args, count);
+}
+
+static const char *log_test_format(const libos_log_record_t *record)
+{
+	static char buffer[128];
+	libos_log_record_format(buffer, sizeof(buffer), record);
+	return buffer;
+}
+
+// ====================
+//
+// libos_log_ring_init
+//
+// ====================
+
+CTEST(log_ring_init, notPowerOfTwo)
+{
+	libos_log_ring_slot_t slots[3];
+	libos_log_ring_t ring;
+
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_log_ring_init(&ring, slots, 3));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_log_ring_init(&ring, slots, 0));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_log_ring_init(NULL, slots, 2));
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_log_ring_init(&ring, slots, 2));
+}
+
+// ====================
+//
+// LIBOS_LOG_DEFERRED
+//
+// ====================
+
+CTEST(log_deferred, capture)
+{
+	libos_log_record_t record;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_LOG_RING_CREATE_STATIC(log_test_ring_data, log_test_ring));
+
+	LIBOS_LOG_DEFERRED(2, "value %d", 42);
+	ASSERT_TRUE(libos_log_ring_pop(&log_test_ring, &record));
+	ASSERT_EQUAL(2, record.level);
+	ASSERT_STR("value %d", record.format);
+	ASSERT_EQUAL(1, record.arg_count);
+	ASSERT_EQUAL(LIBOS_LOG_ARG_SIGNED, record.args[0].type);
+	ASSERT_EQUAL(42, record.args[0].value.i);
+	ASSERT_FALSE(libos_log_ring_pop(&log_test_ring, &record));
+}
+
+CTEST(log_deferred, noArguments)
+{
+	libos_log_record_t record;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_LOG_RING_CREATE_STATIC(log_test_ring_data, log_test_ring));
+
+	LIBOS_LOG_DEFERRED(1, "plain");
+	ASSERT_TRUE(libos_log_ring_pop(&log_test_ring, &record));
+	ASSERT_EQUAL(0, record.arg_count);
+	ASSERT_STR("plain", log_test_format(&record));
+}
+
+CTEST(log_deferred, argumentTypes)
+{
+	libos_log_record_t record;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_LOG_RING_CREATE_STATIC(log_test_ring_data, log_test_ring));
+
+	unsigned char small = 200;
+	int64_t big = INT64_MIN;
+	const char *name = "abc";
+	LIBOS_LOG_DEFERRED(0, "%u %lld %s %f %p", small, (long long)big, name, 1.5f, (void *)name);
+	ASSERT_TRUE(libos_log_ring_pop(&log_test_ring, &record));
+	ASSERT_EQUAL(5, record.arg_count);
+	ASSERT_EQUAL(LIBOS_LOG_ARG_UNSIGNED, record.args[0].type);
+	ASSERT_EQUAL(1, record.args[0].size);
+	ASSERT_EQUAL(LIBOS_LOG_ARG_SIGNED, record.args[1].type);
+	ASSERT_TRUE(record.args[1].value.i == INT64_MIN);
+	ASSERT_EQUAL(LIBOS_LOG_ARG_STRING, record.args[2].type);
+	ASSERT_TRUE(record.args[2].value.p == name);
+	ASSERT_EQUAL(LIBOS_LOG_ARG_DOUBLE, record.args[3].type);
+	ASSERT_EQUAL(LIBOS_LOG_ARG_POINTER, record.args[4].type);
+}
+
+CTEST(log_deferred, fullDrops)
+{
+	libos_log_record_t record;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_LOG_RING_CREATE_STATIC(log_test_ring_data, log_test_ring));
+
+	for (int i = 0; i < 6; i++)
+	{
+		LIBOS_LOG_DEFERRED(0, "%d", i);
+	}
+	ASSERT_EQUAL(2, libos_log_ring_take_dropped(&log_test_ring));
+	ASSERT_EQUAL(0, libos_log_ring_take_dropped(&log_test_ring));
+	for (int i = 0; i < 4; i++)
+	{
+		ASSERT_TRUE(libos_log_ring_pop(&log_test_ring, &record));
+		ASSERT_EQUAL(i, record.args[0].value.i);
+	}
+	ASSERT_FALSE(libos_log_ring_pop(&log_test_ring, &record));
+
+	// The ring wraps around
+	LIBOS_LOG_DEFERRED(0, "%d", 7);
+	ASSERT_TRUE(libos_log_ring_pop(&log_test_ring, &record));
+	ASSERT_EQUAL(7, record.args[0].value.i);
+}
+
+static void log_test_count(const libos_log_record_t *record, void *context)
+{
+	(void)record;
+	(*(int *)context)++;
+}
+
+CTEST(log_deferred, drainBatch)
+{
+	int handled = 0;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_LOG_RING_CREATE_STATIC(log_test_ring_data, log_test_ring));
+
+	LIBOS_LOG_DEFERRED(0, "a");
+	LIBOS_LOG_DEFERRED(0, "b");
+	LIBOS_LOG_DEFERRED(0, "c");
+	ASSERT_EQUAL(2, libos_log_ring_drain(&log_test_ring, log_test_count, &handled, 2));
+	ASSERT_EQUAL(1, libos_log_ring_drain(&log_test_ring, log_test_count, &handled, 10));
+	ASSERT_EQUAL(3, handled);
+}
+
+// ====================
+//
+// libos_log_record_format
+//
+// ====================
+
+CTEST(log_record_format, conversions)
+{
+	libos_log_record_t record;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_LOG_RING_CREATE_STATIC(log_test_ring_data, log_test_ring));
+
+	LIBOS_LOG_DEFERRED(0, "%d|%5u|%-3x|%hhd|%c|%s|%.2f|%%|%lu", -12, 34u, 255, (signed char)-1, 'z', "str", 3.14159, 9ul);
+	ASSERT_TRUE(libos_log_ring_pop(&log_test_ring, &record));
+	ASSERT_STR("-12|   34|ff |-1|z|str|3.14|%|9", log_test_format(&record));
+}
+
+CTEST(log_record_format, unsignedOfNegative)
+{
+	libos_log_record_t record;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_LOG_RING_CREATE_STATIC(log_test_ring_data, log_test_ring));
+
+	// Like printf, a negative int shows as a 32-bit pattern
+	LIBOS_LOG_DEFERRED(0, "%x %x", -1, (short)-2);
+	ASSERT_TRUE(libos_log_ring_pop(&log_test_ring, &record));
+	ASSERT_STR("ffffffff fffffffe", log_test_format(&record));
+}
+
+CTEST(log_record_format, missingAndUnsupported)
+{
+	libos_log_record_t record;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_LOG_RING_CREATE_STATIC(log_test_ring_data, log_test_ring));
+
+	LIBOS_LOG_DEFERRED(0, "%d %*d %d", 1);
+	ASSERT_TRUE(libos_log_ring_pop(&log_test_ring, &record));
+	ASSERT_STR("1 %*d %d", log_test_format(&record));
+}
+
+CTEST(log_record_format, truncates)
+{
+	libos_log_record_t record;
+	char buffer[8];
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_LOG_RING_CREATE_STATIC(log_test_ring_data, log_test_ring));
+
+	LIBOS_LOG_DEFERRED(0, "abc %s", "defghijk");
+	ASSERT_TRUE(libos_log_ring_pop(&log_test_ring, &record));
+	ASSERT_EQUAL(7, libos_log_record_format(buffer, sizeof(buffer), &record));
+	ASSERT_STR("abc def", buffer);
+	ASSERT_EQUAL(0, libos_log_record_format(buffer, 0, &record));
+}
@@ -0,0 +1,129 @@
+#include <stdint.h>
+#include "ctest.h"
+
+// The statements go to the LIBOS_LOG_PRINT of the test platform.
+#undef LIBOS_LOG_ENABLE_DEFERRED
+#define LIBOS_LOG_ENABLE_DEFERRED 0
+#undef LIBOS_LOG_ENABLE_BINARY
+#define LIBOS_LOG_ENABLE_BINARY 0
+#undef LIBOS_LOG_ENABLE_BUFFERED
+#define LIBOS_LOG_ENABLE_BUFFERED 0
+
+#include "libos/log.h"
+#include "libos/log_ratelimit.h"
+
+LIBOS_LOG_MODULE(log_ratelimit_test);
+
+// ====================
+//
+// libos_log_ratelimit_check
+//
+// ====================
+
+CTEST(log_ratelimit_check, firstIsOutput)
+{
+	libos_log_ratelimit_t state = {0};
+	uint32_t suppressed = 1234;
+	ASSERT_TRUE(libos_log_ratelimit_check(&state, 0, 100, &suppressed));
+	ASSERT_EQUAL(0, suppressed);
+}
+
+CTEST(log_ratelimit_check, suppressedWithinInterval)
+{
+	libos_log_ratelimit_t state = {0};
+	uint32_t suppressed = 0;
+	ASSERT_TRUE(libos_log_ratelimit_check(&state, 1000, 100, &suppressed));
+	ASSERT_FALSE(libos_log_ratelimit_check(&state, 1001, 100, &suppressed));
+	ASSERT_FALSE(libos_log_ratelimit_check(&state, 1099, 100, &suppressed));
+	ASSERT_TRUE(libos_log_ratelimit_check(&state, 1100, 100, &suppressed));
+	ASSERT_EQUAL(2, suppressed);
+	ASSERT_FALSE(libos_log_ratelimit_check(&state, 1150, 100, &suppressed));
+	ASSERT_TRUE(libos_log_ratelimit_check(&state, 5000, 100, &suppressed));
+	ASSERT_EQUAL(1, suppressed);
+}
+
+CTEST(log_ratelimit_check, clockWraps)
+{
+	libos_log_ratelimit_t state = {0};
+	uint32_t suppressed = 0;
+	ASSERT_TRUE(libos_log_ratelimit_check(&state, UINT32_MAX - 10, 100, &suppressed));
+	ASSERT_FALSE(libos_log_ratelimit_check(&state, 50, 100, &suppressed));
+	ASSERT_TRUE(libos_log_ratelimit_check(&state, 89, 100, &suppressed));
+	ASSERT_EQUAL(1, suppressed);
+}
+
+CTEST(log_ratelimit_check, longSilenceIsOutput)
+{
+	// Quiet for half the clock range (and more), the statement is not muted.
+	static const uint32_t silences[] = { UINT32_C(0x80000000), UINT32_C(0x80000001), UINT32_C(0xC0000000), UINT32_MAX - 100 };
+	for (size_t i = 0; i < sizeof(silences) / sizeof(silences[0]); i++)
+	{
+		libos_log_ratelimit_t state = {0};
+		uint32_t suppressed = 1234;
+		ASSERT_TRUE(libos_log_ratelimit_check(&state, 1000, 100, &suppressed));
+		ASSERT_TRUE(libos_log_ratelimit_check(&state, 1100 + silences[i], 100, &suppressed));
+		ASSERT_EQUAL(0, suppressed);
+	}
+}
+
+CTEST(log_ratelimit_check, outputAtZero)
+{
+	libos_log_ratelimit_t state = {0};
+	uint32_t suppressed = 0;
+	ASSERT_TRUE(libos_log_ratelimit_check(&state, 0, 100, &suppressed));
+	ASSERT_FALSE(libos_log_ratelimit_check(&state, 50, 100, &suppressed));
+	ASSERT_TRUE(libos_log_ratelimit_check(&state, 101, 100, &suppressed));
+	ASSERT_EQUAL(1, suppressed);
+}
+
+// ====================
+//
+// libos_log_every_n_check
+//
+// ====================
+
+CTEST(log_every_n_check, everyThird)
+{
+	libos_log_every_n_t state = {0};
+	int output = 0;
+	for (int i = 0; i < 10; i++)
+	{
+		output += libos_log_every_n_check(&state, 3) ? 1 : 0;
+	}
+	ASSERT_EQUAL(4, output);
+}
+
+CTEST(log_every_n_check, zeroIsEvery)
+{
+	libos_log_every_n_t state = {0};
+	ASSERT_TRUE(libos_log_every_n_check(&state, 0));
+	ASSERT_TRUE(libos_log_every_n_check(&state, 0));
+	ASSERT_TRUE(libos_log_every_n_check(&state, 1));
+}
+
+// ====================
+//
+// LIBOS_LOG_*_RATELIMITED / LIBOS_LOG_*_EVERY_N
+//
+// ====================
+
+CTEST(log_ratelimit_macros, ratelimited)
+{
+	test_log_print_count = 0;
+	for (int i = 0; i < 5; i++)
+	{
+		LIBOS_LOG_ERR_RATELIMITED(60000, "repeated %d", i);
+	}
+	ASSERT_EQUAL(1, test_log_print_count);
+}
+
+CTEST(log_ratelimit_macros, everyN)
+{
+	test_log_print_count = 0;
+	for (int i = 0; i < 10; i++)
+	{
+		LIBOS_LOG_WRN_EVERY_N(5, "sampled %d", i);
+	}
+	ASSERT_EQUAL(2, test_log_print_count);
+	ASSERT_EQUAL(LIBOS_LOG_LEVEL_WRN, test_log_print_level);
+}
@@ -0,0 +1,132 @@
+#include <stdint.h>
+#include "ctest.h"
+
+// Compile all statements in, the run-time level of the module selects.
+// The statements go to the LIBOS_LOG_PRINT of the test platform.
+#undef LIBOS_LOG_ENABLE_DEFERRED
+#define LIBOS_LOG_ENABLE_DEFERRED 0
+#undef LIBOS_LOG_ENABLE_BINARY
+#define LIBOS_LOG_ENABLE_BINARY 0
+#undef LIBOS_LOG_ENABLE_BUFFERED
+#define LIBOS_LOG_ENABLE_BUFFERED 0
+#undef LIBOS_LOG_ENABLE_RUNTIME_LEVEL
+#define LIBOS_LOG_ENABLE_RUNTIME_LEVEL 1
+#define LIBOS_LOG_LEVEL_MIN LIBOS_LOG_LEVEL_DBG
+#define LIBOS_LOG_LEVEL_DEFAULT LIBOS_LOG_LEVEL_WRN
+
+#include "libos/log.h"
+
+LIBOS_LOG_MODULE(log_runtime_test);
+
+int test_log_print_count;
+int test_log_print_level;
+
+void test_log_print(const char *format, ...)
+{
+	(void)format;
+}
+
+static int log_runtime_evaluated;
+
+static int log_runtime_argument(void)
+{
+	log_runtime_evaluated++;
+	return 0;
+}
+
+static void log_runtime_reset(void)
+{
+	test_log_print_count = 0;
+	test_log_print_level = 0;
+	log_runtime_evaluated = 0;
+	libos_log_set_level("log_runtime_test", LIBOS_LOG_LEVEL_DEFAULT);
+}
+
+// ====================
+//
+// LIBOS_LOG_MODULE
+//
+// ====================
+
+CTEST(log_runtime_module, defaultLevel)
+{
+	log_runtime_reset();
+	LIBOS_LOG_ERR("error %d", log_runtime_argument());
+	LIBOS_LOG_WRN("warning %d", log_runtime_argument());
+	LIBOS_LOG_INF("info %d", log_runtime_argument());
+	LIBOS_LOG_DBG("debug %d", log_runtime_argument());
+	ASSERT_EQUAL(2, test_log_print_count);
+	ASSERT_EQUAL(LIBOS_LOG_LEVEL_WRN, test_log_print_level);
+}
+
+CTEST(log_runtime_module, disabledArgumentsNotEvaluated)
+{
+	log_runtime_reset();
+	LIBOS_LOG_DBG("debug %d", log_runtime_argument());
+	ASSERT_EQUAL(0, log_runtime_evaluated);
+	ASSERT_EQUAL(0, test_log_print_count);
+}
+
+// ====================
+//
+// libos_log_set_level
+//
+// ====================
+
+CTEST(log_runtime_set_level, enableDebug)
+{
+	log_runtime_reset();
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_log_set_level("log_runtime_test", LIBOS_LOG_LEVEL_DBG));
+	LIBOS_LOG_DBG("debug %d", log_runtime_argument());
+	ASSERT_EQUAL(1, log_runtime_evaluated);
+	ASSERT_EQUAL(1, test_log_print_count);
+	ASSERT_EQUAL(LIBOS_LOG_LEVEL_DBG, test_log_print_level);
+	log_runtime_reset();
+}
+
+CTEST(log_runtime_set_level, onlyErrors)
+{
+	log_runtime_reset();
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_log_set_level("log_runtime_test", LIBOS_LOG_LEVEL_ERR));
+	LIBOS_LOG_WRN("warning");
+	LIBOS_LOG_ERR("error");
+	ASSERT_EQUAL(1, test_log_print_count);
+	ASSERT_EQUAL(LIBOS_LOG_LEVEL_ERR, test_log_print_level);
+	log_runtime_reset();
+}
+
+CTEST(log_runtime_set_level, unknownModule)
+{
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_log_set_level("no_such_module", LIBOS_LOG_LEVEL_DBG));
+}
+
+CTEST(log_runtime_set_level, nullName)
+{
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_log_set_level(NULL, LIBOS_LOG_LEVEL_DBG));
+}
+
+// ====================
+//
+// libos_log_get_level
+//
+// ====================
+
+CTEST(log_runtime_get_level, afterSet)
+{
+	int level = 0;
+	log_runtime_reset();
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_log_get_level("log_runtime_test", &level));
+	ASSERT_EQUAL(LIBOS_LOG_LEVEL_WRN, level);
+	libos_log_set_level_all(LIBOS_LOG_LEVEL_INF);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_log_get_level("log_runtime_test", &level));
+	ASSERT_EQUAL(LIBOS_LOG_LEVEL_INF, level);
+	log_runtime_reset();
+}
+
+CTEST(log_runtime_get_level, invalidArgs)
+{
+	int level = 0;
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_log_get_level(NULL, &level));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_log_get_level("log_runtime_test", NULL));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_log_get_level("no_such_module", &level));
+}
@@ -0,0 +1,128 @@
+#include <stdint.h>
+#include "ctest.h"
+
+#include "libos/memory/pool.h"
+
+typedef struct {
+	uint32_t a;
+	uint8_t b[9];
+} pool_test_item_t;
+
+// ====================
+//
+// libos_pool_init
+//
+// ====================
+
+CTEST(pool_init, staticStorage)
+{
+	LIBOS_POOL_STATIC_DATA_STRUCT(data, sizeof(pool_test_item_t), 4);
+	libos_pool_t pool;
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_POOL_CREATE_STATIC(data, pool, sizeof(pool_test_item_t), false));
+	ASSERT_EQUAL(16, libos_pool_block_size(&pool));
+	ASSERT_EQUAL(4 * 16, sizeof(data));
+}
+
+CTEST(pool_init, blockSizeRounding)
+{
+	ASSERT_EQUAL(8, LIBOS_POOL_BLOCK_SIZE(1));
+	ASSERT_EQUAL(8, LIBOS_POOL_BLOCK_SIZE(8));
+	ASSERT_EQUAL(16, LIBOS_POOL_BLOCK_SIZE(9));
+	ASSERT_EQUAL(24, LIBOS_POOL_BLOCK_SIZE(17));
+}
+
+CTEST(pool_init, invalidArguments)
+{
+	uint64_t data[8];
+	libos_pool_t pool;
+
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_pool_init(NULL, data, 8, 8, false));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_pool_init(&pool, NULL, 8, 8, false));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_pool_init(&pool, data, 0, 8, false));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_pool_init(&pool, data, 8, 0, false));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_pool_init(&pool, ((uint8_t*)data) + 1, 8, 4, false));
+}
+
+// ====================
+//
+// libos_pool_alloc
+//
+// ====================
+
+CTEST(pool_alloc, exhaust)
+{
+	LIBOS_POOL_STATIC_DATA_STRUCT(data, sizeof(pool_test_item_t), 3);
+	libos_pool_t pool;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_POOL_CREATE_STATIC(data, pool, sizeof(pool_test_item_t), true));
+
+	uint8_t *first = (uint8_t *)libos_pool_alloc(&pool);
+	uint8_t *second = (uint8_t *)libos_pool_alloc(&pool);
+	uint8_t *third = (uint8_t *)libos_pool_alloc(&pool);
+	ASSERT_TRUE(first == (uint8_t *)data);
+	ASSERT_TRUE(second == first + 16);
+	ASSERT_TRUE(third == first + 32);
+	ASSERT_NULL(libos_pool_alloc(&pool));
+}
+
+CTEST(pool_alloc, reuseFreed)
+{
+	LIBOS_POOL_STATIC_DATA_STRUCT(data, sizeof(pool_test_item_t), 2);
+	libos_pool_t pool;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_POOL_CREATE_STATIC(data, pool, sizeof(pool_test_item_t), true));
+
+	void *first = libos_pool_alloc(&pool);
+	void *second = libos_pool_alloc(&pool);
+	ASSERT_NULL(libos_pool_alloc(&pool));
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_pool_free(&pool, first));
+	ASSERT_TRUE(first == libos_pool_alloc(&pool));
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_pool_free(&pool, second));
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_pool_free(&pool, first));
+	// Last freed is the first to be allocated again
+	ASSERT_TRUE(first == libos_pool_alloc(&pool));
+	ASSERT_TRUE(second == libos_pool_alloc(&pool));
+	ASSERT_NULL(libos_pool_alloc(&pool));
+}
+
+CTEST(pool_alloc, notThreadSafe)
+{
+	LIBOS_POOL_STATIC_DATA_STRUCT(data, sizeof(uint32_t), 2);
+	libos_pool_t pool;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_POOL_CREATE_STATIC(data, pool, sizeof(uint32_t), false));
+
+	uint32_t *first = (uint32_t *)libos_pool_alloc(&pool);
+	uint32_t *second = (uint32_t *)libos_pool_alloc(&pool);
+	ASSERT_NOT_NULL(first);
+	ASSERT_NOT_NULL(second);
+	ASSERT_NULL(libos_pool_alloc(&pool));
+
+	*first = 0xDEADBEEF;
+	*second = 0xCAFEBABE;
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_pool_free(&pool, second));
+	ASSERT_EQUAL(0xDEADBEEF, *first);
+	ASSERT_TRUE(second == libos_pool_alloc(&pool));
+}
+
+// ====================
+//
+// libos_pool_free
+//
+// ====================
+
+CTEST(pool_free, foreignPointer)
+{
+	LIBOS_POOL_STATIC_DATA_STRUCT(data, sizeof(pool_test_item_t), 2);
+	libos_pool_t pool;
+	uint64_t other;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_POOL_CREATE_STATIC(data, pool, sizeof(pool_test_item_t), true));
+
+	uint8_t *block = (uint8_t *)libos_pool_alloc(&pool);
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_pool_free(&pool, NULL));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_pool_free(NULL, block));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_pool_free(&pool, block + 1));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_pool_free(&pool, block + 32));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_pool_free(&pool, &other));
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_pool_free(&pool, block));
+}
@@ -0,0 +1,163 @@
+#include <stdint.h>
+#include "ctest.h"
+
+#include "libos/concurrent/spsc_ring.h"
+
+// ====================
+//
+// libos_spsc_ring_init
+//
+// ====================
+
+CTEST(spsc_ring_init, staticStorage)
+{
+	LIBOS_SPSC_RING_STATIC_DATA_STRUCT(data, uint32_t, 8);
+	libos_spsc_ring_t ring;
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_SPSC_RING_CREATE_STATIC(data, ring));
+	ASSERT_EQUAL(8, libos_spsc_ring_capacity(&ring));
+	ASSERT_EQUAL(0, libos_spsc_ring_size(&ring));
+}
+
+CTEST(spsc_ring_init, notPowerOfTwo)
+{
+	uint32_t data[6];
+	libos_spsc_ring_t ring;
+
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_spsc_ring_init(&ring, data, sizeof(data[0]), 6));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_spsc_ring_init(&ring, data, sizeof(data[0]), 0));
+}
+
+CTEST(spsc_ring_init, invalidArguments)
+{
+	uint32_t data[4];
+	libos_spsc_ring_t ring;
+
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_spsc_ring_init(NULL, data, sizeof(data[0]), 4));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_spsc_ring_init(&ring, NULL, sizeof(data[0]), 4));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_spsc_ring_init(&ring, data, 0, 4));
+}
+
+// ====================
+//
+// libos_spsc_ring_push/pop
+//
+// ====================
+
+CTEST(spsc_ring_push_pop, singleElement)
+{
+	LIBOS_SPSC_RING_STATIC_DATA_STRUCT(data, uint32_t, 4);
+	libos_spsc_ring_t ring;
+	uint32_t value = 0x12345678;
+	uint32_t result = 0;
+
+	LIBOS_SPSC_RING_CREATE_STATIC(data, ring);
+	ASSERT_TRUE(libos_spsc_ring_push(&ring, &value));
+	ASSERT_EQUAL(1, libos_spsc_ring_size(&ring));
+	ASSERT_TRUE(libos_spsc_ring_pop(&ring, &result));
+	ASSERT_EQUAL(value, result);
+	ASSERT_EQUAL(0, libos_spsc_ring_size(&ring));
+}
+
+CTEST(spsc_ring_push_pop, popEmpty)
+{
+	LIBOS_SPSC_RING_STATIC_DATA_STRUCT(data, uint32_t, 4);
+	libos_spsc_ring_t ring;
+	uint32_t result = 0xAA;
+
+	LIBOS_SPSC_RING_CREATE_STATIC(data, ring);
+	ASSERT_FALSE(libos_spsc_ring_pop(&ring, &result));
+	ASSERT_EQUAL(0xAA, result);
+}
+
+CTEST(spsc_ring_push_pop, pushFull)
+{
+	LIBOS_SPSC_RING_STATIC_DATA_STRUCT(data, uint32_t, 4);
+	libos_spsc_ring_t ring;
+
+	LIBOS_SPSC_RING_CREATE_STATIC(data, ring);
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		ASSERT_TRUE(libos_spsc_ring_push(&ring, &i));
+	}
+	uint32_t value = 4;
+	ASSERT_FALSE(libos_spsc_ring_push(&ring, &value));
+	ASSERT_EQUAL(4, libos_spsc_ring_size(&ring));
+}
+
+CTEST(spsc_ring_push_pop, fifoOrderOverWrapAround)
+{
+	LIBOS_SPSC_RING_STATIC_DATA_STRUCT(data, uint32_t, 4);
+	libos_spsc_ring_t ring;
+	uint32_t next_push = 0;
+	uint32_t next_pop = 0;
+
+	LIBOS_SPSC_RING_CREATE_STATIC(data, ring);
+	for (int round = 0; round < 10; round++)
+	{
+		for (int i = 0; i < 3; i++, next_push++)
+		{
+			ASSERT_TRUE(libos_spsc_ring_push(&ring, &next_push));
+		}
+		for (int i = 0; i < 3; i++, next_pop++)
+		{
+			uint32_t result;
+			ASSERT_TRUE(libos_spsc_ring_pop(&ring, &result));
+			ASSERT_EQUAL(next_pop, result);
+		}
+	}
+}
+
+// ====================
+//
+// libos_spsc_ring_push_n/pop_n
+//
+// ====================
+
+CTEST(spsc_ring_push_n_pop_n, partialPushWhenFull)
+{
+	LIBOS_SPSC_RING_STATIC_DATA_STRUCT(data, uint8_t, 8);
+	libos_spsc_ring_t ring;
+	const uint8_t kValues[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	uint8_t result[10] = { 0 };
+
+	LIBOS_SPSC_RING_CREATE_STATIC(data, ring);
+	ASSERT_EQUAL(8, libos_spsc_ring_push_n(&ring, kValues, 10));
+	ASSERT_EQUAL(0, libos_spsc_ring_push_n(&ring, kValues, 1));
+	ASSERT_EQUAL(8, libos_spsc_ring_pop_n(&ring, result, 10));
+	ASSERT_DATA(kValues, 8, result, 8);
+	ASSERT_EQUAL(0, libos_spsc_ring_pop_n(&ring, result, 10));
+}
+
+CTEST(spsc_ring_push_n_pop_n, spansOverWrapAround)
+{
+	LIBOS_SPSC_RING_STATIC_DATA_STRUCT(data, uint16_t, 8);
+	libos_spsc_ring_t ring;
+	const uint16_t kValues[6] = { 0x1111, 0x2222, 0x3333, 0x4444, 0x5555, 0x6666 };
+	uint16_t result[6] = { 0 };
+
+	LIBOS_SPSC_RING_CREATE_STATIC(data, ring);
+	// Move the indices close to the end of the storage.
+	ASSERT_EQUAL(5, libos_spsc_ring_push_n(&ring, kValues, 5));
+	ASSERT_EQUAL(5, libos_spsc_ring_pop_n(&ring, result, 5));
+
+	ASSERT_EQUAL(6, libos_spsc_ring_push_n(&ring, kValues, 6));
+	ASSERT_EQUAL(6, libos_spsc_ring_size(&ring));
+	ASSERT_EQUAL(6, libos_spsc_ring_pop_n(&ring, result, 6));
+	ASSERT_DATA((const uint8_t*)kValues, sizeof(kValues), (const uint8_t*)result, sizeof(result));
+}
+
+CTEST(spsc_ring_push_n_pop_n, largerElements)
+{
+	typedef struct { uint32_t a; uint8_t b[5]; } element_t;
+	LIBOS_SPSC_RING_STATIC_DATA_STRUCT(data, element_t, 2);
+	libos_spsc_ring_t ring;
+	element_t in[2] = { { 1, { 1, 2, 3, 4, 5 } }, { 2, { 6, 7, 8, 9, 10 } } };
+	element_t out[2];
+
+	LIBOS_SPSC_RING_CREATE_STATIC(data, ring);
+	ASSERT_EQUAL(2, libos_spsc_ring_push_n(&ring, in, 2));
+	ASSERT_EQUAL(2, libos_spsc_ring_pop_n(&ring, out, 2));
+	ASSERT_EQUAL(2, out[1].a);
+	ASSERT_EQUAL(10, out[1].b[4]);
+}
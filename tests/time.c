@@ -0,0 +1,178 @@
+#include <stdint.h>
+#include <time.h>
+#include "ctest.h"
+
+#include "libos/time.h"
+
+// The test platform counts the time in nanoseconds since an unspecified point.
+libos_time_t libos_time_get_now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((libos_time_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+// ====================
+//
+// libos_time_from_*
+//
+// ====================
+
+CTEST(time_from, units)
+{
+	ASSERT_EQUAL(7, libos_time_to_ns(libos_time_from_ns(7)));
+	ASSERT_EQUAL(7000, libos_time_to_ns(libos_time_from_us(7)));
+	ASSERT_EQUAL(7000000, libos_time_to_ns(libos_time_from_ms(7)));
+	ASSERT_EQUAL(7000000000, libos_time_to_ns(libos_time_from_s(7)));
+	ASSERT_EQUAL(-3000000, libos_time_to_ns(libos_time_from_ms(-3)));
+}
+
+// ====================
+//
+// libos_time_to_*
+//
+// ====================
+
+CTEST(time_to, truncates)
+{
+	libos_time_t time = libos_time_from_ns(1999999999);
+	ASSERT_EQUAL(1999999, libos_time_to_us(time));
+	ASSERT_EQUAL(1999, libos_time_to_ms(time));
+	ASSERT_EQUAL(1, libos_time_to_s(time));
+}
+
+// ====================
+//
+// libos_time_difference_*
+//
+// ====================
+
+CTEST(time_difference, sign)
+{
+	libos_time_t a = libos_time_from_ms(10);
+	libos_time_t b = libos_time_from_ms(2500);
+
+	ASSERT_EQUAL(2490000000, libos_time_difference_ns(a, b));
+	ASSERT_EQUAL(2490000, libos_time_difference_us(a, b));
+	ASSERT_EQUAL(2490, libos_time_difference_ms(a, b));
+	ASSERT_EQUAL(2, libos_time_difference_s(a, b));
+	ASSERT_EQUAL(-2490, libos_time_difference_ms(b, a));
+}
+
+// ====================
+//
+// libos_time_add / libos_time_subtract
+//
+// ====================
+
+CTEST(time_arithmetic, addSubtract)
+{
+	libos_time_t a = libos_time_from_s(3);
+	libos_time_t b = libos_time_from_ms(250);
+
+	ASSERT_EQUAL(3250, libos_time_to_ms(libos_time_add(a, b)));
+	ASSERT_EQUAL(2750, libos_time_to_ms(libos_time_subtract(a, b)));
+}
+
+// ====================
+//
+// libos_time_is_*
+//
+// ====================
+
+CTEST(time_compare, laterEarlierSame)
+{
+	libos_time_t a = libos_time_from_ms(20);
+	libos_time_t b = libos_time_from_ms(10);
+
+	ASSERT_TRUE(libos_time_is_later(a, b));
+	ASSERT_FALSE(libos_time_is_later(b, a));
+	ASSERT_FALSE(libos_time_is_later(a, a));
+	ASSERT_TRUE(libos_time_is_earlier(b, a));
+	ASSERT_FALSE(libos_time_is_earlier(a, b));
+	ASSERT_FALSE(libos_time_is_earlier(a, a));
+	ASSERT_TRUE(libos_time_is_same(a, libos_time_from_us(20000)));
+	ASSERT_FALSE(libos_time_is_same(a, b));
+}
+
+// ====================
+//
+// libos_time_ticks_diff
+//
+// ====================
+
+CTEST(time_ticks_diff, forward)
+{
+	ASSERT_EQUAL(25, libos_time_ticks_diff(100, 125));
+	ASSERT_EQUAL(0, libos_time_ticks_diff(100, 100));
+}
+
+CTEST(time_ticks_diff, monotonic)
+{
+	libos_time_ticks_t first = libos_time_ticks_now();
+	libos_time_ticks_t second = libos_time_ticks_now();
+	ASSERT_TRUE(libos_time_ticks_diff(first, second) < (LIBOS_TIME_TICKS_MASK / 2));
+}
+
+// ====================
+//
+// libos_time_ticks_calibration_from_hz
+//
+// ====================
+
+CTEST(time_ticks_calibration_from_hz, invalidArguments)
+{
+	libos_time_ticks_calibration_t calibration;
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_time_ticks_calibration_from_hz(NULL, 1000));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_time_ticks_calibration_from_hz(&calibration, 0));
+}
+
+CTEST(time_ticks_calibration_from_hz, nanosecondTicks)
+{
+	libos_time_ticks_calibration_t calibration;
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_time_ticks_calibration_from_hz(&calibration, 1000000000));
+	ASSERT_EQUAL(0, libos_time_ticks_to_ns(&calibration, 0));
+	ASSERT_EQUAL(1, libos_time_ticks_to_ns(&calibration, 1));
+	ASSERT_EQUAL(123456789, libos_time_ticks_to_ns(&calibration, 123456789));
+	ASSERT_EQUAL(UINT64_C(1) << 62, libos_time_ticks_to_ns(&calibration, UINT64_C(1) << 62));
+}
+
+CTEST(time_ticks_calibration_from_hz, slowCounter)
+{
+	libos_time_ticks_calibration_t calibration;
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_time_ticks_calibration_from_hz(&calibration, 32768));
+	ASSERT_EQUAL(1000000000, libos_time_ticks_to_ns(&calibration, 32768));
+	ASSERT_EQUAL(UINT64_C(3600000000000), libos_time_ticks_to_ns(&calibration, UINT64_C(32768) * 3600));
+}
+
+CTEST(time_ticks_calibration_from_hz, fastCounter)
+{
+	libos_time_ticks_calibration_t calibration;
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_time_ticks_calibration_from_hz(&calibration, 2400000000));
+	uint64_t second_ns = libos_time_ticks_to_ns(&calibration, 2400000000);
+	ASSERT_TRUE(second_ns >= 999999999 && second_ns <= 1000000000);
+	// A day of ticks doesn't overflow, and is precise within a part per million
+	uint64_t day_ns = libos_time_ticks_to_ns(&calibration, UINT64_C(2400000000) * 86400);
+	ASSERT_TRUE(day_ns >= UINT64_C(86399913600000) && day_ns <= UINT64_C(86400000000000));
+}
+
+// ====================
+//
+// libos_time_ticks_calibrate
+//
+// ====================
+
+CTEST(time_ticks_calibrate, measure)
+{
+	libos_time_ticks_calibration_t calibration;
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_time_ticks_calibrate(NULL, 1000));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_time_ticks_calibrate(&calibration, 0));
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_time_ticks_calibrate(&calibration, 2000));
+	libos_time_t start = libos_time_get_now();
+	libos_time_ticks_t start_ticks = libos_time_ticks_now();
+	while (libos_time_difference_us(start, libos_time_get_now()) < 10000) { }
+	uint64_t ns = libos_time_ticks_to_ns(&calibration, libos_time_ticks_diff(start_ticks, libos_time_ticks_now()));
+	// Generous bounds, the tests can run on a busy machine
+	ASSERT_TRUE(ns > 5000000 && ns < 50000000);
+}
@@ -0,0 +1,335 @@
+#include <stdint.h>
+#include "ctest.h"
+
+#include "libos/timer.h"
+
+typedef struct {
+	int fired;
+	uint64_t fired_at;
+} timer_test_counter_t;
+
+static libos_time_t timer_test_now;
+
+static void timer_test_count(libos_timer_t *timer, void *arg)
+{
+	(void)timer;
+	timer_test_counter_t *counter = (timer_test_counter_t *)arg;
+	counter->fired++;
+	counter->fired_at = (uint64_t)libos_time_to_ms(timer_test_now);
+}
+
+// Advances the wheel one millisecond at a time up to the given time.
+static size_t timer_test_advance_to(libos_timer_wheel_t *wheel, libos_time_milliseconds_t ms)
+{
+	size_t count = 0;
+	while (libos_time_to_ms(timer_test_now) < ms)
+	{
+		timer_test_now = libos_time_add(timer_test_now, libos_time_from_ms(1));
+		count += libos_timer_wheel_advance(wheel, timer_test_now);
+	}
+	return count;
+}
+
+// ====================
+//
+// libos_timer_wheel_init
+//
+// ====================
+
+CTEST(timer_wheel_init, invalidArguments)
+{
+	libos_timer_wheel_t wheel;
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_timer_wheel_init(NULL, libos_time_from_ms(0), libos_time_from_ms(1)));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_timer_wheel_init(&wheel, libos_time_from_ms(0), libos_time_from_ms(0)));
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, libos_time_from_ms(0), libos_time_from_ms(1)));
+}
+
+// ====================
+//
+// libos_timer_arm_at
+//
+// ====================
+
+CTEST(timer_arm_at, expiresOnTime)
+{
+	libos_timer_wheel_t wheel;
+	libos_timer_t timer;
+	timer_test_counter_t counter = {0};
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+	libos_timer_init(&timer);
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timer, libos_time_from_ms(10), timer_test_count, &counter));
+	ASSERT_TRUE(libos_timer_is_armed(&timer));
+	ASSERT_EQUAL(0, timer_test_advance_to(&wheel, 9));
+	ASSERT_EQUAL(1, timer_test_advance_to(&wheel, 10));
+	ASSERT_EQUAL(1, counter.fired);
+	ASSERT_EQUAL(10, counter.fired_at);
+	ASSERT_FALSE(libos_timer_is_armed(&timer));
+}
+
+CTEST(timer_arm_at, roundsUp)
+{
+	libos_timer_wheel_t wheel;
+	libos_timer_t timer;
+	timer_test_counter_t counter = {0};
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+	libos_timer_init(&timer);
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timer, libos_time_from_us(4500), timer_test_count, &counter));
+	ASSERT_EQUAL(0, timer_test_advance_to(&wheel, 4));
+	ASSERT_EQUAL(1, timer_test_advance_to(&wheel, 5));
+}
+
+CTEST(timer_arm_at, inThePast)
+{
+	libos_timer_wheel_t wheel;
+	libos_timer_t timer;
+	timer_test_counter_t counter = {0};
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+	libos_timer_init(&timer);
+	ASSERT_EQUAL(0, timer_test_advance_to(&wheel, 100));
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timer, libos_time_from_ms(50), timer_test_count, &counter));
+	ASSERT_EQUAL(1, timer_test_advance_to(&wheel, 101));
+	ASSERT_EQUAL(101, counter.fired_at);
+}
+
+CTEST(timer_arm_at, higherLevels)
+{
+	// Deadlines around every level boundary of the default wheel, and one out of range.
+	static const uint64_t deadlines[] = {1, 63, 64, 65, 200, 4095, 4096, 4097, 100000, 262143, 262144, 300000, 20000000};
+	const size_t count = sizeof(deadlines) / sizeof(deadlines[0]);
+	libos_timer_wheel_t wheel;
+	libos_timer_t timers[sizeof(deadlines) / sizeof(deadlines[0])];
+	timer_test_counter_t counters[sizeof(deadlines) / sizeof(deadlines[0])] = {{0}};
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+
+	// Start at an odd offset, so the slots don't line up with the deadlines.
+	ASSERT_EQUAL(0, timer_test_advance_to(&wheel, 37));
+	for (size_t i = 0; i < count; i++)
+	{
+		libos_timer_init(&timers[i]);
+		ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timers[i], libos_time_from_ms(37 + deadlines[i]), timer_test_count, &counters[i]));
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		ASSERT_EQUAL(0, timer_test_advance_to(&wheel, 37 + deadlines[i] - 1));
+		ASSERT_EQUAL(1, timer_test_advance_to(&wheel, 37 + deadlines[i]));
+		ASSERT_EQUAL(37 + deadlines[i], counters[i].fired_at);
+	}
+}
+
+CTEST(timer_arm_at, rearm)
+{
+	libos_timer_wheel_t wheel;
+	libos_timer_t timer;
+	timer_test_counter_t counter = {0};
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+	libos_timer_init(&timer);
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timer, libos_time_from_ms(10), timer_test_count, &counter));
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timer, libos_time_from_ms(20), timer_test_count, &counter));
+	ASSERT_EQUAL(1, timer_test_advance_to(&wheel, 30));
+	ASSERT_EQUAL(20, counter.fired_at);
+}
+
+// ====================
+//
+// libos_timer_cancel
+//
+// ====================
+
+CTEST(timer_cancel, notCalled)
+{
+	libos_timer_wheel_t wheel;
+	libos_timer_t timer;
+	timer_test_counter_t counter = {0};
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+	libos_timer_init(&timer);
+
+	ASSERT_FALSE(libos_timer_cancel(&wheel, &timer));
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timer, libos_time_from_ms(5000), timer_test_count, &counter));
+	ASSERT_TRUE(libos_timer_cancel(&wheel, &timer));
+	ASSERT_FALSE(libos_timer_is_armed(&timer));
+	ASSERT_FALSE(libos_timer_cancel(&wheel, &timer));
+	ASSERT_EQUAL(0, timer_test_advance_to(&wheel, 6000));
+	ASSERT_EQUAL(0, counter.fired);
+}
+
+// ====================
+//
+// libos_timer_wheel_collect
+//
+// ====================
+
+CTEST(timer_wheel_collect, batch)
+{
+	libos_timer_wheel_t wheel;
+	libos_timer_t timers[3];
+	timer_test_counter_t counter = {0};
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		libos_timer_init(&timers[i]);
+		ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timers[i], libos_time_from_ms(10 * (i + 1)), timer_test_count, &counter));
+	}
+
+	// A single big step expires all of them together
+	timer_test_now = libos_time_from_ms(1000);
+	ASSERT_EQUAL(3, libos_timer_wheel_collect(&wheel, timer_test_now));
+	ASSERT_FALSE(libos_timer_is_armed(&timers[0]));
+	ASSERT_TRUE(libos_timer_is_pending(&timers[0]));
+	ASSERT_EQUAL(0, counter.fired);
+	ASSERT_EQUAL(3, libos_timer_run_expired(&wheel));
+	ASSERT_EQUAL(3, counter.fired);
+	ASSERT_FALSE(libos_timer_is_pending(&timers[0]));
+	ASSERT_EQUAL(0, libos_timer_wheel_collect(&wheel, timer_test_now));
+}
+
+CTEST(timer_wheel_collect, cancelPending)
+{
+	libos_timer_wheel_t wheel;
+	libos_timer_t timers[3];
+	timer_test_counter_t counter = {0};
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		libos_timer_init(&timers[i]);
+		ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timers[i], libos_time_from_ms(5), timer_test_count, &counter));
+	}
+
+	timer_test_now = libos_time_from_ms(10);
+	ASSERT_EQUAL(3, libos_timer_wheel_collect(&wheel, timer_test_now));
+	// A slot runs the last armed timer first, cancel the last of the list.
+	ASSERT_TRUE(libos_timer_cancel(&wheel, &timers[0]));
+	ASSERT_FALSE(libos_timer_is_pending(&timers[0]));
+	ASSERT_FALSE(libos_timer_cancel(&wheel, &timers[0]));
+
+	libos_timer_t *timer;
+	libos_timer_callback_t callback;
+	void *arg;
+	ASSERT_TRUE(libos_timer_wheel_pop_expired(&wheel, &timer, &callback, &arg));
+	ASSERT_TRUE(timer == &timers[2]);
+	ASSERT_TRUE(callback == timer_test_count);
+	ASSERT_TRUE(arg == &counter);
+	ASSERT_FALSE(libos_timer_is_pending(timer));
+	ASSERT_EQUAL(1, libos_timer_run_expired(&wheel));
+	ASSERT_EQUAL(1, counter.fired);
+	ASSERT_FALSE(libos_timer_wheel_pop_expired(&wheel, &timer, &callback, &arg));
+
+	// The list is still usable for the next batch.
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timers[0], libos_time_from_ms(15), timer_test_count, &counter));
+	ASSERT_EQUAL(1, timer_test_advance_to(&wheel, 15));
+	ASSERT_EQUAL(2, counter.fired);
+}
+
+static void timer_test_periodic(libos_timer_t *timer, void *arg)
+{
+	libos_timer_wheel_t *wheel = (libos_timer_wheel_t *)arg;
+	libos_timer_arm_at(wheel, timer, libos_time_add(timer_test_now, libos_time_from_ms(10)), timer_test_periodic, arg);
+}
+
+CTEST(timer_wheel_advance, rearmFromCallback)
+{
+	libos_timer_wheel_t wheel;
+	libos_timer_t timer;
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+	libos_timer_init(&timer);
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &timer, libos_time_from_ms(10), timer_test_periodic, &wheel));
+	ASSERT_EQUAL(10, timer_test_advance_to(&wheel, 100));
+	ASSERT_TRUE(libos_timer_is_armed(&timer));
+}
+
+typedef struct {
+	libos_timer_wheel_t *wheel;
+	libos_timer_t *sibling;
+	bool cancel;
+	timer_test_counter_t counter;
+} timer_test_sibling_t;
+
+// Re-arms (or cancels) another timer that expired in the same batch.
+static void timer_test_sibling(libos_timer_t *timer, void *arg)
+{
+	(void)timer;
+	timer_test_sibling_t *test = (timer_test_sibling_t *)arg;
+	test->counter.fired++;
+	if (test->cancel)
+	{
+		libos_timer_cancel(test->wheel, test->sibling);
+	}
+	else
+	{
+		libos_timer_arm_at(test->wheel, test->sibling, libos_time_add(timer_test_now, libos_time_from_ms(40)), timer_test_count, &test->counter);
+	}
+}
+
+CTEST(timer_wheel_advance, rearmPendingFromCallback)
+{
+	libos_timer_wheel_t wheel;
+	libos_timer_t a;
+	libos_timer_t b;
+	libos_timer_t c;
+	timer_test_counter_t c_counter = {0};
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+	libos_timer_init(&a);
+	libos_timer_init(&b);
+	libos_timer_init(&c);
+	timer_test_sibling_t test = { &wheel, &b, false, {0} };
+
+	// The callback of a (armed last, so it runs first) moves b, which is already in the expired batch, 40 ms ahead.
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &b, libos_time_from_ms(5), timer_test_count, &test.counter));
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &a, libos_time_from_ms(5), timer_test_sibling, &test));
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &c, libos_time_from_ms(40), timer_test_count, &c_counter));
+
+	timer_test_now = libos_time_from_ms(10);
+	ASSERT_EQUAL(1, libos_timer_wheel_advance(&wheel, timer_test_now));
+	ASSERT_EQUAL(1, test.counter.fired);
+	ASSERT_EQUAL(0, c_counter.fired);
+	ASSERT_TRUE(libos_timer_is_armed(&b));
+	ASSERT_TRUE(libos_timer_is_armed(&c));
+	ASSERT_EQUAL(2, wheel.armed_count);
+
+	ASSERT_EQUAL(0, timer_test_advance_to(&wheel, 39));
+	ASSERT_EQUAL(1, timer_test_advance_to(&wheel, 40));
+	ASSERT_EQUAL(40, c_counter.fired_at);
+	ASSERT_EQUAL(0, timer_test_advance_to(&wheel, 49));
+	ASSERT_EQUAL(1, timer_test_advance_to(&wheel, 50));
+	ASSERT_EQUAL(50, test.counter.fired_at);
+	ASSERT_EQUAL(0, wheel.armed_count);
+}
+
+CTEST(timer_wheel_advance, cancelPendingFromCallback)
+{
+	libos_timer_wheel_t wheel;
+	libos_timer_t a;
+	libos_timer_t b;
+	timer_test_now = libos_time_from_ms(0);
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_wheel_init(&wheel, timer_test_now, libos_time_from_ms(1)));
+	libos_timer_init(&a);
+	libos_timer_init(&b);
+	timer_test_sibling_t test = { &wheel, &b, true, {0} };
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &b, libos_time_from_ms(5), timer_test_count, &test.counter));
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_timer_arm_at(&wheel, &a, libos_time_from_ms(5), timer_test_sibling, &test));
+
+	timer_test_now = libos_time_from_ms(10);
+	ASSERT_EQUAL(1, libos_timer_wheel_advance(&wheel, timer_test_now));
+	ASSERT_EQUAL(1, test.counter.fired);
+	ASSERT_FALSE(libos_timer_is_armed(&b));
+	ASSERT_FALSE(libos_timer_is_pending(&b));
+	ASSERT_EQUAL(0, timer_test_advance_to(&wheel, 100));
+}
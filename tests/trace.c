@@ -0,0 +1,153 @@
+#include <stdint.h>
+#include <string.h>
+#include "ctest.h"
+
+// Record the events of the macros in this file.
+#undef LIBOS_ENABLE_TRACE
+#define LIBOS_ENABLE_TRACE 1
+#define LIBOS_TRACE_RING_SIZE 8
+
+#include "libos/trace.h"
+
+LIBOS_TRACE_DEFINE();
+
+static uint8_t trace_test_dump[1024];
+static size_t trace_test_dump_size;
+
+// The test platform appends the dump to the buffer.
+static void trace_test_write(void *context, const void *data, size_t size)
+{
+	(void)context;
+	memcpy(&trace_test_dump[trace_test_dump_size], data, size);
+	trace_test_dump_size += size;
+}
+
+static void trace_test_reset(void)
+{
+	libos_trace_pause();
+	libos_trace_clear();
+	trace_test_dump_size = 0;
+	libos_trace_resume();
+}
+
+static const libos_trace_record_t *trace_test_records(uint32_t *count, uint32_t *overwritten)
+{
+	if (libos_trace_dump(trace_test_write, NULL, NULL) != LIBOS_ERR_OK)
+	{
+		return NULL;
+	}
+	uint32_t ring_header[3];
+	memcpy(ring_header, &trace_test_dump[sizeof(libos_trace_dump_header_t)], sizeof(ring_header));
+	*count = ring_header[1];
+	*overwritten = ring_header[2];
+	return (const libos_trace_record_t *)(void *)&trace_test_dump[sizeof(libos_trace_dump_header_t) + sizeof(ring_header)];
+}
+
+static libos_trace_type_t trace_test_type(const libos_trace_record_t *record)
+{
+	return (libos_trace_type_t)(record->event >> 28);
+}
+
+// ====================
+//
+// LIBOS_TRACE_*
+//
+// ====================
+
+CTEST(trace, recordsEventsInOrder)
+{
+	trace_test_reset();
+	LIBOS_TRACE_BEGIN("outer");
+	LIBOS_TRACE_COUNTER("depth", 42);
+	LIBOS_TRACE_INSTANT("point");
+	LIBOS_TRACE_END("outer");
+
+	uint32_t count;
+	uint32_t overwritten;
+	const libos_trace_record_t *records = trace_test_records(&count, &overwritten);
+	ASSERT_NOT_NULL(records);
+	ASSERT_EQUAL(4, count);
+	ASSERT_EQUAL(0, overwritten);
+	ASSERT_EQUAL(LIBOS_TRACE_TYPE_BEGIN, trace_test_type(&records[0]));
+	ASSERT_EQUAL(LIBOS_TRACE_TYPE_COUNTER, trace_test_type(&records[1]));
+	ASSERT_EQUAL(42, records[1].value);
+	ASSERT_EQUAL(LIBOS_TRACE_TYPE_INSTANT, trace_test_type(&records[2]));
+	ASSERT_EQUAL(LIBOS_TRACE_TYPE_END, trace_test_type(&records[3]));
+	ASSERT_TRUE(records[3].ticks >= records[0].ticks);
+}
+
+CTEST(trace, nameIdPointsToName)
+{
+	trace_test_reset();
+	LIBOS_TRACE_INSTANT("trace_test_name");
+
+	uint32_t count;
+	uint32_t overwritten;
+	const libos_trace_record_t *records = trace_test_records(&count, &overwritten);
+	ASSERT_NOT_NULL(records);
+	ASSERT_EQUAL(1, count);
+	uint32_t name = records[0].event & ((UINT32_C(1) << 28) - 1);
+	ASSERT_STR("trace_test_name", &__start_libos_trace_names[name]);
+}
+
+CTEST(trace, fullRingKeepsNewest)
+{
+	trace_test_reset();
+	for (uint32_t i = 0; i < LIBOS_TRACE_RING_SIZE + 3; i++)
+	{
+		LIBOS_TRACE_COUNTER("value", i);
+	}
+
+	uint32_t count;
+	uint32_t overwritten;
+	const libos_trace_record_t *records = trace_test_records(&count, &overwritten);
+	ASSERT_NOT_NULL(records);
+	ASSERT_EQUAL(LIBOS_TRACE_RING_SIZE, count);
+	ASSERT_EQUAL(3, overwritten);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		ASSERT_EQUAL(i + 3, records[i].value);
+	}
+}
+
+CTEST(trace, pausedDoesNotRecord)
+{
+	trace_test_reset();
+	libos_trace_pause();
+	LIBOS_TRACE_INSTANT("ignored");
+	libos_trace_resume();
+
+	uint32_t count;
+	uint32_t overwritten;
+	ASSERT_NOT_NULL(trace_test_records(&count, &overwritten));
+	ASSERT_EQUAL(0, count);
+}
+
+// ====================
+//
+// libos_trace_dump
+//
+// ====================
+
+CTEST(trace_dump, header)
+{
+	trace_test_reset();
+	libos_time_ticks_calibration_t calibration = { 1000, 10 };
+	ASSERT_EQUAL(LIBOS_ERR_OK, libos_trace_dump(trace_test_write, NULL, &calibration));
+
+	libos_trace_dump_header_t header;
+	memcpy(&header, trace_test_dump, sizeof(header));
+	ASSERT_EQUAL(LIBOS_TRACE_DUMP_MAGIC, header.magic);
+	ASSERT_EQUAL(1, header.version);
+	ASSERT_EQUAL(16, header.record_size);
+	ASSERT_EQUAL(1000, header.mult);
+	ASSERT_EQUAL(10, header.shift);
+	ASSERT_EQUAL(0, header.dropped);
+	// The ring of this thread was claimed by the earlier tests, or now by nobody.
+	ASSERT_TRUE(trace_test_dump_size == sizeof(header) || trace_test_dump_size == sizeof(header) + 3 * sizeof(uint32_t));
+}
+
+CTEST(trace_dump, invalidArguments)
+{
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_trace_dump(NULL, NULL, NULL));
+}
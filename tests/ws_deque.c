@@ -0,0 +1,130 @@
+#include <stdint.h>
+#include "ctest.h"
+
+#include "libos/concurrent/ws_deque.h"
+
+// ====================
+//
+// libos_ws_deque_init
+//
+// ====================
+
+CTEST(ws_deque_init, staticStorage)
+{
+	LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(slots, 8);
+	libos_ws_deque_t deque;
+
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_WS_DEQUE_CREATE_STATIC(slots, deque));
+	ASSERT_EQUAL(8, libos_ws_deque_capacity(&deque));
+	ASSERT_EQUAL(0, libos_ws_deque_size(&deque));
+}
+
+CTEST(ws_deque_init, invalidArguments)
+{
+	LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(slots, 6);
+	libos_ws_deque_t deque;
+
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_ws_deque_init(NULL, slots, 4));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_ws_deque_init(&deque, NULL, 4));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_ws_deque_init(&deque, slots, 6));
+	ASSERT_EQUAL(LIBOS_ERR_INVALID_ARG, libos_ws_deque_init(&deque, slots, 0));
+}
+
+// ====================
+//
+// libos_ws_deque_push/pop/steal
+//
+// ====================
+
+CTEST(ws_deque_push_pop, emptyReturnsNull)
+{
+	LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(slots, 4);
+	libos_ws_deque_t deque;
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_WS_DEQUE_CREATE_STATIC(slots, deque));
+
+	ASSERT_NULL(libos_ws_deque_pop(&deque));
+	ASSERT_NULL(libos_ws_deque_steal(&deque));
+	ASSERT_EQUAL(0, libos_ws_deque_size(&deque));
+
+	// A failed pop must not leave the deque in a state where a push is lost.
+	int value = 1;
+	ASSERT_TRUE(libos_ws_deque_push(&deque, &value));
+	ASSERT_EQUAL(1, libos_ws_deque_size(&deque));
+	ASSERT_EQUAL((void *)&value, libos_ws_deque_pop(&deque));
+}
+
+CTEST(ws_deque_push_pop, popIsLastInFirstOut)
+{
+	LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(slots, 4);
+	libos_ws_deque_t deque;
+	int values[3];
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_WS_DEQUE_CREATE_STATIC(slots, deque));
+
+	for (int i = 0; i < 3; i++)
+	{
+		ASSERT_TRUE(libos_ws_deque_push(&deque, &values[i]));
+	}
+	ASSERT_EQUAL(3, libos_ws_deque_size(&deque));
+	ASSERT_EQUAL((void *)&values[2], libos_ws_deque_pop(&deque));
+	ASSERT_EQUAL((void *)&values[1], libos_ws_deque_pop(&deque));
+	ASSERT_EQUAL((void *)&values[0], libos_ws_deque_pop(&deque));
+	ASSERT_NULL(libos_ws_deque_pop(&deque));
+}
+
+CTEST(ws_deque_push_pop, stealIsFirstInFirstOut)
+{
+	LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(slots, 4);
+	libos_ws_deque_t deque;
+	int values[3];
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_WS_DEQUE_CREATE_STATIC(slots, deque));
+
+	for (int i = 0; i < 3; i++)
+	{
+		ASSERT_TRUE(libos_ws_deque_push(&deque, &values[i]));
+	}
+	ASSERT_EQUAL((void *)&values[0], libos_ws_deque_steal(&deque));
+	ASSERT_EQUAL((void *)&values[1], libos_ws_deque_steal(&deque));
+	// The owner and the thief meet at the last element.
+	ASSERT_EQUAL((void *)&values[2], libos_ws_deque_pop(&deque));
+	ASSERT_NULL(libos_ws_deque_steal(&deque));
+	ASSERT_NULL(libos_ws_deque_pop(&deque));
+}
+
+CTEST(ws_deque_push_pop, pushFull)
+{
+	LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(slots, 2);
+	libos_ws_deque_t deque;
+	int values[3];
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_WS_DEQUE_CREATE_STATIC(slots, deque));
+
+	ASSERT_TRUE(libos_ws_deque_push(&deque, &values[0]));
+	ASSERT_TRUE(libos_ws_deque_push(&deque, &values[1]));
+	ASSERT_FALSE(libos_ws_deque_push(&deque, &values[2]));
+
+	// A steal frees the slot at the top for the next push.
+	ASSERT_EQUAL((void *)&values[0], libos_ws_deque_steal(&deque));
+	ASSERT_TRUE(libos_ws_deque_push(&deque, &values[2]));
+	ASSERT_EQUAL((void *)&values[2], libos_ws_deque_pop(&deque));
+	ASSERT_EQUAL((void *)&values[1], libos_ws_deque_pop(&deque));
+}
+
+CTEST(ws_deque_push_pop, orderOverWrapAround)
+{
+	LIBOS_WS_DEQUE_STATIC_DATA_STRUCT(slots, 4);
+	libos_ws_deque_t deque;
+	int values[3];
+	ASSERT_EQUAL(LIBOS_ERR_OK, LIBOS_WS_DEQUE_CREATE_STATIC(slots, deque));
+
+	// Every round moves the indices 3 slots, such that they wrap around the slots many times.
+	for (int round = 0; round < 10; round++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			ASSERT_TRUE(libos_ws_deque_push(&deque, &values[i]));
+		}
+		ASSERT_EQUAL((void *)&values[0], libos_ws_deque_steal(&deque));
+		ASSERT_EQUAL((void *)&values[2], libos_ws_deque_pop(&deque));
+		ASSERT_EQUAL((void *)&values[1], libos_ws_deque_steal(&deque));
+		ASSERT_EQUAL(0, libos_ws_deque_size(&deque));
+	}
+}
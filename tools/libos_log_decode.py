@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""Decodes the binary log frames of libos (LIBOS_LOG_ENABLE_BINARY) back to text.
+
+The format strings are read from the libos_log_fmt section of the ELF file
+of the firmware, the frames are read from a file (or stdin) that contains
+the frames back to back, as written by libos_log_binary_write.
+
+Usage:
+    libos_log_decode.py firmware.elf log.bin [--tick-hz 240000000]
+                        [--levels 0=E,1=W,2=I,3=D]
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SECTION_NAME = b"libos_log_fmt"
+
+ARG_SIGNED = 0
+ARG_UNSIGNED = 1
+ARG_DOUBLE = 2
+ARG_POINTER = 3
+ARG_STRING = 4
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d*))?(hh|h|ll|l|j|z|t|L)?([diouxXcsfFeEgGaAp%])")
+
+
+def read_format_section(path, section_name=SECTION_NAME):
+    """Returns the content of the libos_log_fmt (or the given) section of the ELF file."""
+    with open(path, "rb") as elf:
+        data = elf.read()
+
+    if data[:4] != b"\x7fELF":
+        raise ValueError("%s is not a ELF file" % path)
+    is_64 = data[4] == 2
+    endian = "<" if data[5] == 1 else ">"
+
+    if is_64:
+        shoff, = struct.unpack_from(endian + "Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x3A)
+        header = endian + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(endian + "I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x2E)
+        header = endian + "IIIIIIIIII"
+
+    sections = [struct.unpack_from(header, data, shoff + i * shentsize) for i in range(shnum)]
+    names_offset = sections[shstrndx][4]
+    for name, _, _, _, offset, size, _, _, _, _ in sections:
+        name_end = data.index(b"\0", names_offset + name)
+        if data[names_offset + name:name_end] == section_name:
+            return data[offset:offset + size]
+    raise ValueError("%s has no %s section" % (path, section_name.decode()))
+
+
+def get_varint(frame, offset):
+    value = 0
+    shift = 0
+    while True:
+        byte = frame[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, offset
+
+
+def decode_arguments(payload, offset):
+    args = []
+    while offset < len(payload):
+        tag = payload[offset]
+        offset += 1
+        kind = tag & 0x0F
+        size = tag >> 4
+        if kind == ARG_SIGNED:
+            value, offset = get_varint(payload, offset)
+            value = (value >> 1) ^ -(value & 1)
+        elif kind == ARG_DOUBLE:
+            value, = struct.unpack_from("<d", payload, offset)
+            offset += 8
+        elif kind == ARG_STRING:
+            length, offset = get_varint(payload, offset)
+            value = payload[offset:offset + length].decode("utf-8", "replace")
+            offset += length
+        else:
+            value, offset = get_varint(payload, offset)
+        args.append((kind, size, value))
+    return args
+
+
+def format_message(fmt, args):
+    """Applies the C format string to the decoded arguments."""
+    remaining = list(args)
+
+    def convert(match):
+        flags, width, precision, _, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        if not remaining:
+            return match.group(0)
+        kind, size, value = remaining.pop(0)
+        spec = "%" + flags + width + ("." + precision if precision is not None else "")
+        if conversion in "di":
+            return (spec + "d") % int(value)
+        if conversion in "ouxX":
+            value = int(value)
+            if value < 0:
+                # Like printf, which sees the value promoted to (at least) int.
+                value &= (1 << (8 * max(size, 4))) - 1
+            return (spec + conversion.replace("u", "d")) % value
+        if conversion == "c":
+            return (spec + "c") % chr(int(value))
+        if conversion == "s":
+            return (spec + "s") % (value if kind == ARG_STRING else "0x%x" % value)
+        if conversion == "p":
+            return (spec + "s") % ("0x%x" % int(value))
+        if conversion in "aA":
+            return float(value).hex()
+        return (spec + conversion) % float(value)
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode_stream(formats, stream):
+    """Yields (level, timestamp, message) for every frame in the stream."""
+    offset = 0
+    while offset < len(stream):
+        length, offset = get_varint(stream, offset)
+        payload = stream[offset:offset + length]
+        offset += length
+        if len(payload) < length:
+            break
+
+        level = payload[0]
+        timestamp, position = get_varint(payload, 1)
+        format_id, position = get_varint(payload, position)
+        end = formats.find(b"\0", format_id)
+        fmt = formats[format_id:end if end >= 0 else None].decode("utf-8", "replace")
+        yield level, timestamp, format_message(fmt, decode_arguments(payload, position))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="the ELF file of the firmware")
+    parser.add_argument("log", nargs="?", help="the binary log (default: stdin)")
+    parser.add_argument("--tick-hz", type=float, help="the frequency of libos_time_ticks_now, to print seconds")
+    parser.add_argument("--levels", default="", help="names for the levels, like 0=E,1=W,2=I,3=D")
+    args = parser.parse_args()
+
+    names = dict(item.split("=", 1) for item in args.levels.split(",") if "=" in item)
+    formats = read_format_section(args.elf)
+    if args.log:
+        with open(args.log, "rb") as log:
+            stream = log.read()
+    else:
+        stream = sys.stdin.buffer.read()
+
+    for level, timestamp, message in decode_stream(formats, stream):
+        time = "%.6f" % (timestamp / args.tick_hz) if args.tick_hz else str(timestamp)
+        print("[%s] %s: %s" % (time, names.get(str(level), str(level)), message))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""Converts a libos trace dump (LIBOS_ENABLE_TRACE) to a Chrome trace event JSON file.
+
+The event names are read from the libos_trace_names section of the ELF file
+of the firmware, the dump is read from a file (or stdin) as written by
+libos_trace_dump. The output can be opened in Perfetto (ui.perfetto.dev) or
+chrome://tracing.
+
+Usage:
+    libos_trace_convert.py firmware.elf trace.bin [-o trace.json]
+                           [--tick-hz 240000000] [--tick-bits 32]
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+from libos_log_decode import read_format_section
+
+SECTION_NAME = b"libos_trace_names"
+MAGIC = 0x4C545243
+
+TYPE_SHIFT = 28
+NAME_MASK = (1 << TYPE_SHIFT) - 1
+PHASES = {0: "B", 1: "E", 2: "i", 3: "C"}
+
+
+def read_dump(dump):
+    """Returns the header (mult, shift, dropped) and a list of (thread, overwritten, records) for the dump."""
+    for endian in "<>":
+        magic, = struct.unpack_from(endian + "I", dump, 0)
+        if magic == MAGIC:
+            break
+    else:
+        raise ValueError("not a libos trace dump")
+
+    version, record_size, mult, shift, dropped = struct.unpack_from(endian + "HHIII", dump, 4)
+    if version != 1:
+        raise ValueError("unsupported trace dump version %d" % version)
+    offset = 20
+
+    rings = []
+    while offset + 12 <= len(dump):
+        thread, count, overwritten = struct.unpack_from(endian + "III", dump, offset)
+        offset += 12
+        records = []
+        for _ in range(count):
+            if offset + record_size > len(dump):
+                break
+            records.append(struct.unpack_from(endian + "QII", dump, offset))
+            offset += record_size
+        rings.append((thread, overwritten, records))
+    return (mult, shift, dropped), rings
+
+
+def unwrap(ticks, bits):
+    """Makes the timestamps of a ring monotonic for a counter of the given width."""
+    if bits >= 64:
+        return ticks
+    result = []
+    base = 0
+    previous = None
+    for tick in ticks:
+        if previous is not None and tick < previous:
+            base += 1 << bits
+        previous = tick
+        result.append(base + tick)
+    return result
+
+
+def name_of(names, name_id):
+    end = names.find(b"\0", name_id)
+    return names[name_id:end if end >= 0 else None].decode("utf-8", "replace")
+
+
+def convert(names, header, rings, tick_hz=None, tick_bits=64):
+    """Returns the list of Chrome trace events for the rings."""
+    mult, shift, _ = header
+    if mult:
+        to_us = lambda ticks: ((ticks * mult) >> shift) / 1e3
+    elif tick_hz:
+        to_us = lambda ticks: ticks * 1e6 / tick_hz
+    else:
+        # Uncalibrated, show the ticks as microseconds.
+        to_us = lambda ticks: float(ticks)
+
+    rings = [(thread, overwritten, records, unwrap([r[0] for r in records], tick_bits))
+             for thread, overwritten, records in rings]
+    start = min((ticks[0] for _, _, _, ticks in rings if ticks), default=0)
+
+    events = []
+    for thread, overwritten, records, ticks in rings:
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": thread,
+                       "args": {"name": "thread %d" % thread}})
+        if overwritten:
+            print("thread %d: %d older events were overwritten" % (thread, overwritten), file=sys.stderr)
+
+        depth = 0
+        for (_, event, value), tick in zip(records, ticks):
+            phase = PHASES.get(event >> TYPE_SHIFT)
+            if phase is None:
+                continue
+            name = name_of(names, event & NAME_MASK)
+            # The begins of a overwritten part have no match, skip their ends.
+            if phase == "B":
+                depth += 1
+            elif phase == "E":
+                if depth == 0:
+                    continue
+                depth -= 1
+
+            entry = {"name": name, "ph": phase, "ts": to_us(tick - start), "pid": 1, "tid": thread}
+            if phase == "C":
+                entry["args"] = {name: value}
+            elif phase == "i":
+                entry["s"] = "t"
+                entry["args"] = {"value": value}
+            elif phase == "B":
+                entry["args"] = {"value": value}
+            events.append(entry)
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="the ELF file of the firmware")
+    parser.add_argument("dump", nargs="?", help="the trace dump (default: stdin)")
+    parser.add_argument("-o", "--output", help="the JSON file to write (default: stdout)")
+    parser.add_argument("--tick-hz", type=float, help="the frequency of libos_time_ticks_now, if the dump has no calibration")
+    parser.add_argument("--tick-bits", type=int, default=64, help="the width of the tick counter, like 32 for CCOUNT")
+    args = parser.parse_args()
+
+    names = read_format_section(args.elf, SECTION_NAME)
+    if args.dump:
+        with open(args.dump, "rb") as dump_file:
+            dump = dump_file.read()
+    else:
+        dump = sys.stdin.buffer.read()
+
+    header, rings = read_dump(dump)
+    if header[2]:
+        print("%d events of threads without a ring were dropped" % header[2], file=sys.stderr)
+    if args.tick_hz and header[0]:
+        print("the dump has a calibration, --tick-hz is ignored", file=sys.stderr)
+    trace = {"traceEvents": convert(names, header, rings, args.tick_hz, args.tick_bits), "displayTimeUnit": "ns"}
+
+    if args.output:
+        with open(args.output, "w") as output:
+            json.dump(trace, output)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()